@@ -0,0 +1,316 @@
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <DirectXTex\DirectXTex.h>
+#include "AssetPack.h"
+#include "LZCodec.h"
+#include "Utility.h"
+
+// Pack file identifier ("RXPK").
+static constexpr uint32_t PACK_MAGIC     = 0x4B505852;
+// Pack file format version.
+static constexpr uint32_t PACK_VERSION   = 2;
+// Alignment of the contents of the assets (allows mapping them directly).
+static constexpr uint64_t PACK_ALIGNMENT = 4096;
+// Size of the (decompressed) chunks of the compressed assets.
+static constexpr size_t   PACK_CHUNK     = 256 * 1024;
+// Chunk size flag indicating that the chunk is stored uncompressed.
+static constexpr uint32_t RAW_CHUNK_BIT  = 0x80000000;
+// Entry flag indicating that the asset is compressed.
+static constexpr uint16_t COMPRESSED_BIT = 0x1;
+// Upper bound (exclusive) of the stored size of an asset. File reads take 32-bit sizes,
+// and UINT32_MAX is reserved for reading the whole file.
+static constexpr uint64_t PACK_MAX_SIZE  = UINT32_MAX;
+
+struct PackHeader {
+    uint32_t magic;         // PACK_MAGIC
+    uint32_t version;       // PACK_VERSION
+    uint32_t entryCount;    // Number of table of contents entries
+    uint32_t namesSize;     // Total size of the names (in bytes)
+};
+
+struct PackEntry {
+    uint64_t nameHash;      // Hash of the normalized name
+    uint64_t offset;        // Offset of the contents from the start of the file
+    uint64_t storedSize;    // Size of the stored contents in bytes
+    uint64_t size;          // Size of the decompressed contents in bytes
+    uint32_t nameOffset;    // Offset of the normalized name from the start of the names
+    uint16_t nameLength;    // Length of the normalized name
+    uint16_t flags;         // COMPRESSED_BIT
+};
+
+static_assert(40 == sizeof(PackEntry), "Unexpected table of contents entry size.");
+
+// Aligns the offset to the next multiple of PACK_ALIGNMENT.
+static inline auto alignOffset(const uint64_t offset)
+-> uint64_t {
+    return (offset + (PACK_ALIGNMENT - 1)) & ~(PACK_ALIGNMENT - 1);
+}
+
+// Converts the name to lower case, and replaces backslashes with forward slashes.
+static inline auto normalizeName(const char* name)
+-> std::string {
+    std::string str = name;
+    for (char& c : str) {
+        if ('\\' == c) {
+            c = '/';
+        } else if ('A' <= c && c <= 'Z') {
+            c = static_cast<char>(c - 'A' + 'a');
+        }
+    }
+    return str;
+}
+
+// Computes the 64-bit FNV-1a hash of the string.
+static inline auto hashName(const std::string& str)
+-> uint64_t {
+    uint64_t hash = 14695981039346656037ull;
+    for (const char c : str) {
+        hash ^= static_cast<byte_t>(c);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+AssetPack::AssetPack(const char* packFileWithPath)
+    : m_file{packFileWithPath} {
+    const byte_t* base = m_file.data();
+    // Validate the header.
+    const auto header = reinterpret_cast<const PackHeader*>(base);
+    if (m_file.size() < sizeof(PackHeader) ||
+        PACK_MAGIC != header->magic || PACK_VERSION != header->version) {
+        printError("Invalid asset pack: %s", packFileWithPath);
+        TERMINATE();
+    }
+    // Validate the table of contents.
+    const uint64_t tocEnd = sizeof(PackHeader) + header->entryCount * sizeof(PackEntry) +
+                            header->namesSize;
+    if (m_file.size() < tocEnd) {
+        printError("Truncated asset pack: %s", packFileWithPath);
+        TERMINATE();
+    }
+    const auto entries = reinterpret_cast<const PackEntry*>(base + sizeof(PackHeader));
+    for (uint32_t i = 0; i < header->entryCount; ++i) {
+        const PackEntry& entry = entries[i];
+        // Check that the contents are within the file without overflowing the offset.
+        if (entry.storedSize >= PACK_MAX_SIZE || entry.storedSize > m_file.size() ||
+            entry.offset > m_file.size() - entry.storedSize ||
+            static_cast<uint64_t>(entry.nameOffset) + entry.nameLength > header->namesSize ||
+            (i > 0 && entries[i - 1].nameHash > entry.nameHash)) {
+            printError("Corrupted asset pack: %s", packFileWithPath);
+            TERMINATE();
+        }
+    }
+}
+
+size_t AssetPack::size() const {
+    return reinterpret_cast<const PackHeader*>(m_file.data())->entryCount;
+}
+
+bool AssetPack::find(const char* name, AssetRange& range) const {
+    const byte_t* base    = m_file.data();
+    const auto    header  = reinterpret_cast<const PackHeader*>(base);
+    const auto    entries = reinterpret_cast<const PackEntry*>(base + sizeof(PackHeader));
+    const auto    names   = reinterpret_cast<const char*>(entries + header->entryCount);
+    const std::string normName = normalizeName(name);
+    const uint64_t    hash     = hashName(normName);
+    // Perform a binary search. Hash collisions are resolved by comparing the names.
+    const PackEntry* first = std::lower_bound(entries, entries + header->entryCount, hash,
+                                              [](const PackEntry& entry, const uint64_t h) {
+                                                  return entry.nameHash < h;
+                                              });
+    for (const PackEntry* entry = first; entry < entries + header->entryCount &&
+                                         entry->nameHash == hash; ++entry) {
+        if (entry->nameLength == normName.length() &&
+            0 == memcmp(names + entry->nameOffset, normName.data(), entry->nameLength)) {
+            range = AssetRange{entry->offset, entry->storedSize, entry->size,
+                               0 != (entry->flags & COMPRESSED_BIT)};
+            return true;
+        }
+    }
+    return false;
+}
+
+const byte_t* AssetPack::data(const AssetRange& range) const {
+    assert(range.offset + range.storedSize <= m_file.size());
+    return m_file.data() + range.offset;
+}
+
+void AssetPack::read(const AssetRange& range, byte_t* dst) const {
+    if (range.isCompressed) {
+        decompress(data(range), range, dst);
+    } else {
+        memcpy(dst, data(range), static_cast<size_t>(range.size));
+    }
+}
+
+void AssetPack::decompress(const byte_t* storedData, const AssetRange& range, byte_t* dst) {
+    assert(range.isCompressed);
+    const size_t chunkCount = static_cast<size_t>((range.size + PACK_CHUNK - 1) / PACK_CHUNK);
+    const auto   chunkSizes = reinterpret_cast<const uint32_t*>(storedData);
+    if (range.storedSize < chunkCount * sizeof(uint32_t)) {
+        printError("Truncated compressed asset (offset %llu).",
+                   static_cast<unsigned long long>(range.offset));
+        TERMINATE();
+    }
+    // Compute the offsets of the chunks.
+    std::vector<uint64_t> chunkOffsets(chunkCount + 1);
+    chunkOffsets[0] = chunkCount * sizeof(uint32_t);
+    for (size_t c = 0; c < chunkCount; ++c) {
+        chunkOffsets[c + 1] = chunkOffsets[c] + (chunkSizes[c] & ~RAW_CHUNK_BIT);
+    }
+    if (chunkOffsets[chunkCount] != range.storedSize) {
+        printError("Corrupted compressed asset (offset %llu).",
+                   static_cast<unsigned long long>(range.offset));
+        TERMINATE();
+    }
+    // Decompress the chunks in parallel. The worker threads of the shared executor are used
+    // by all callers (such as the I/O threads), so loading several assets at once does not
+    // oversubscribe the CPU. The calling thread decompresses chunks as well.
+    DirectX::GetSharedTaskExecutor()->Run(chunkCount, [&](const size_t c) {
+        const byte_t* src     = storedData + chunkOffsets[c];
+        const size_t  srcSize = static_cast<size_t>(chunkOffsets[c + 1] - chunkOffsets[c]);
+        const size_t  dstSize = static_cast<size_t>(std::min<uint64_t>(PACK_CHUNK,
+                                                    range.size - c * PACK_CHUNK));
+        byte_t* const chunk   = dst + c * PACK_CHUNK;
+        if (chunkSizes[c] & RAW_CHUNK_BIT) {
+            if (srcSize != dstSize) {
+                printError("Corrupted raw chunk (offset %llu).",
+                           static_cast<unsigned long long>(range.offset));
+                TERMINATE();
+            }
+            memcpy(chunk, src, dstSize);
+        } else if (!LZCodec::decompress(src, srcSize, chunk, dstSize)) {
+            printError("Corrupted compressed chunk (offset %llu).",
+                       static_cast<unsigned long long>(range.offset));
+            TERMINATE();
+        }
+    });
+}
+
+// Splits the data into chunks, and compresses them.
+// Returns 'false' (and leaves 'stored' empty) if the data is not compressible.
+static inline auto compressChunks(const byte_t* data, const uint64_t size,
+                                  std::vector<byte_t>& stored)
+-> bool {
+    const size_t chunkCount = static_cast<size_t>((size + PACK_CHUNK - 1) / PACK_CHUNK);
+    std::vector<uint32_t> chunkSizes(chunkCount);
+    std::vector<byte_t>   chunks;
+    std::vector<byte_t>   scratch(LZCodec::compressBound(PACK_CHUNK));
+    for (size_t c = 0; c < chunkCount; ++c) {
+        const byte_t* chunk     = data + c * PACK_CHUNK;
+        const size_t  chunkSize = static_cast<size_t>(std::min<uint64_t>(PACK_CHUNK,
+                                                      size - c * PACK_CHUNK));
+        const size_t  compSize  = LZCodec::compress(chunk, chunkSize, scratch.data());
+        if (compSize < chunkSize) {
+            chunkSizes[c] = static_cast<uint32_t>(compSize);
+            chunks.insert(chunks.end(), scratch.data(), scratch.data() + compSize);
+        } else {
+            // Store the incompressible chunk as is.
+            chunkSizes[c] = static_cast<uint32_t>(chunkSize) | RAW_CHUNK_BIT;
+            chunks.insert(chunks.end(), chunk, chunk + chunkSize);
+        }
+    }
+    const size_t storedSize = chunkCount * sizeof(uint32_t) + chunks.size();
+    if (storedSize >= size) return false;
+    stored.resize(storedSize);
+    memcpy(stored.data(), chunkSizes.data(), chunkCount * sizeof(uint32_t));
+    memcpy(stored.data() + chunkCount * sizeof(uint32_t), chunks.data(), chunks.size());
+    return true;
+}
+
+// Writes 'count' zero bytes to the file.
+static inline void writePadding(FILE* file, const size_t count) {
+    static const byte_t zeros[PACK_ALIGNMENT] = {};
+    assert(count <= PACK_ALIGNMENT);
+    fwrite(zeros, 1, count, file);
+}
+
+void AssetPack::build(const char* packFileWithPath, const char* rootPath,
+                      const std::vector<std::string>& fileNames, const bool compress) {
+    const std::string rootPathStr = rootPath;
+    const uint32_t    entryCount  = static_cast<uint32_t>(fileNames.size());
+    // Map (and optionally compress) the files, and fill out the table of contents.
+    std::vector<FileView>            files;
+    std::vector<std::vector<byte_t>> compressedFiles(entryCount);
+    std::vector<std::string>         names;
+    std::vector<PackEntry>           entries;
+    files.reserve(entryCount);
+    names.reserve(entryCount);
+    entries.reserve(entryCount);
+    uint32_t namesSize = 0;
+    for (uint32_t i = 0; i < entryCount; ++i) {
+        files.emplace_back((rootPathStr + fileNames[i]).c_str());
+        names.emplace_back(normalizeName(fileNames[i].c_str()));
+        const bool isCompressed = compress &&
+                                  compressChunks(files[i].data(), files[i].size(),
+                                                 compressedFiles[i]);
+        if ((isCompressed ? compressedFiles[i].size() : files[i].size()) >= PACK_MAX_SIZE) {
+            printError("Asset too large (4 GiB - 1 byte or more): %s", fileNames[i].c_str());
+            TERMINATE();
+        }
+        const PackEntry entry = {
+            /* nameHash */   hashName(names[i]),
+            /* offset */     0,
+            /* storedSize */ isCompressed ? compressedFiles[i].size() : files[i].size(),
+            /* size */       files[i].size(),
+            /* nameOffset */ namesSize,
+            /* nameLength */ static_cast<uint16_t>(names[i].length()),
+            /* flags */      isCompressed ? COMPRESSED_BIT : uint16_t{0}
+        };
+        entries.push_back(entry);
+        namesSize += entry.nameLength;
+    }
+    // Sort the table of contents by the hash (and then by the name).
+    std::vector<uint32_t> order(entryCount);
+    for (uint32_t i = 0; i < entryCount; ++i) {
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [&entries, &names](const uint32_t a, const uint32_t b) {
+        return entries[a].nameHash != entries[b].nameHash ?
+               entries[a].nameHash <  entries[b].nameHash : names[a] < names[b];
+    });
+    for (uint32_t i = 1; i < entryCount; ++i) {
+        if (names[order[i - 1]] == names[order[i]]) {
+            printError("Duplicate asset name: %s", names[order[i]].c_str());
+            TERMINATE();
+        }
+    }
+    // Assign the offsets of the contents.
+    uint64_t offset = alignOffset(sizeof(PackHeader) + entryCount * sizeof(PackEntry) +
+                                  namesSize);
+    for (const uint32_t i : order) {
+        entries[i].offset = offset;
+        offset = alignOffset(offset + entries[i].storedSize);
+    }
+    // Write the pack file.
+    FILE* file;
+    if (fopen_s(&file, packFileWithPath, "wb")) {
+        printError("Failed to create the file: %s", packFileWithPath);
+        TERMINATE();
+    }
+    const PackHeader header = {PACK_MAGIC, PACK_VERSION, entryCount, namesSize};
+    fwrite(&header, sizeof(PackHeader), 1, file);
+    for (const uint32_t i : order) {
+        fwrite(&entries[i], sizeof(PackEntry), 1, file);
+    }
+    for (const std::string& name : names) {
+        fwrite(name.data(), 1, name.length(), file);
+    }
+    uint64_t position = sizeof(PackHeader) + entryCount * sizeof(PackEntry) + namesSize;
+    for (const uint32_t i : order) {
+        writePadding(file, static_cast<size_t>(entries[i].offset - position));
+        const byte_t* contents = (entries[i].flags & COMPRESSED_BIT) ? compressedFiles[i].data()
+                                                                     : files[i].data();
+        if (contents) {
+            fwrite(contents, 1, static_cast<size_t>(entries[i].storedSize), file);
+        }
+        position = entries[i].offset + entries[i].storedSize;
+    }
+    writePadding(file, static_cast<size_t>(offset - position));
+    if (ferror(file)) {
+        printError("Failed to write the file: %s", packFileWithPath);
+        TERMINATE();
+    }
+    fclose(file);
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "FileView.h"
+
+// Location of an asset within the pack file.
+struct AssetRange {
+    uint64_t offset;        // Offset from the start of the file (4 KiB aligned)
+    uint64_t storedSize;    // Size of the stored (possibly compressed) contents in bytes
+    uint64_t size;          // Size of the (decompressed) contents in bytes
+    bool     isCompressed;  // Whether the contents are split into compressed chunks
+};
+
+// Read-only memory-mapped pack of assets.
+// File layout: header, table of contents (sorted by the hash of the name),
+// names, followed by the contents of the assets (each starting at a 4 KiB boundary).
+// Names are case-insensitive, and '\' and '/' are treated as the same separator.
+// Compressed assets are split into independently compressed 256 KiB chunks,
+// and start with a table of compressed chunk sizes.
+class AssetPack {
+public:
+    RULE_OF_ZERO_MOVE_ONLY(AssetPack);
+    // Maps the pack file into memory, and validates the table of contents.
+    // The stored size of each asset is guaranteed to be less than UINT32_MAX bytes.
+    explicit AssetPack(const char* packFileWithPath);
+    // Returns the number of assets.
+    size_t size() const;
+    // Looks up the asset by name. Returns 'false' if the asset is not present.
+    bool find(const char* name, AssetRange& range) const;
+    // Returns the address of the stored (possibly compressed) contents of the asset.
+    const byte_t* data(const AssetRange& range) const;
+    // Copies (or decompresses) the contents of the asset into 'dst' (of 'range.size' bytes).
+    void read(const AssetRange& range, byte_t* dst) const;
+    // Decompresses the stored contents of the asset into 'dst' (of 'range.size' bytes).
+    // The chunks are decompressed in parallel, using the shared task executor of DirectXTex.
+    static void decompress(const byte_t* storedData, const AssetRange& range, byte_t* dst);
+    // Creates a pack file containing the specified files (optionally, compressed).
+    // The files are located relative to 'rootPath', and are named accordingly.
+    static void build(const char* packFileWithPath, const char* rootPath,
+                      const std::vector<std::string>& fileNames, const bool compress);
+private:
+    FileView m_file;
+};
@@ -0,0 +1,190 @@
+#include <cassert>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <Windows.h>
+#include "AsyncFileReader.h"
+#include "Utility.h"
+
+// Size of the request which reads the entire file.
+static constexpr uint32_t WHOLE_FILE = UINT32_MAX;
+
+struct ReadRequest {
+    std::wstring                file;           // File name with path (empty for tasks)
+    uint64_t                    offset;         // Offset from the start of the file
+    uint32_t                    size;           // Number of bytes to read (or WHOLE_FILE)
+    AsyncFileReader::Callback   callback;       // Completion callback
+};
+
+struct AsyncFileReader::State {
+    std::mutex                  mutex;
+    std::condition_variable     queueCond;      // Signaled when a request is submitted
+    std::condition_variable     budgetCond;     // Signaled when a read completes
+    std::condition_variable     idleCond;       // Signaled when all requests have completed
+    std::deque<ReadRequest>     queue;          // Requests yet to be started
+    std::vector<std::thread>    threads;        // I/O threads
+    uint64_t                    bytesInFlight;  // Total size of the reads in progress
+    uint64_t                    byteBudget;     // Maximal total size of the reads in progress
+    size_t                      pendingCount;   // Requests submitted but not completed
+    bool                        isRunning;      // Cleared to shut down the I/O threads
+    // Reads the requested part of the file (opened for sequential reading) into the buffer.
+    // Blocks the thread until there is enough room in the I/O budget.
+    void readFile(const ReadRequest& request, Buffer& buffer);
+    // Executes read requests until the reader is destroyed.
+    void processRequests();
+};
+
+void AsyncFileReader::State::readFile(const ReadRequest& request, Buffer& buffer) {
+    const wchar_t* fileWithPath = request.file.c_str();
+    const HANDLE file = CreateFileW(fileWithPath, GENERIC_READ, FILE_SHARE_READ,
+                                    nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (INVALID_HANDLE_VALUE == file) {
+        printError("File not found: %ls", fileWithPath);
+        TERMINATE();
+    }
+    uint32_t size = request.size;
+    if (WHOLE_FILE == size) {
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart >= WHOLE_FILE) {
+            printError("Failed to query the size of the file: %ls", fileWithPath);
+            TERMINATE();
+        }
+        size = static_cast<uint32_t>(fileSize.QuadPart);
+    }
+    // Wait for the reads in progress to complete.
+    {
+        std::unique_lock<std::mutex> lock{mutex};
+        budgetCond.wait(lock, [this, size]() {
+            return 0 == bytesInFlight || bytesInFlight + size <= byteBudget;
+        });
+        bytesInFlight += size;
+    }
+    // Read the file.
+    buffer.ptr       = std::make_unique<byte_t[]>(size);
+    buffer.size      = buffer.capacity = size;
+    buffer.memRecord = TrackedMemory{MemHeap::CPU, MemTag::IMPORT, size};
+    // Specify the offset of the read.
+    OVERLAPPED overlapped = {};
+    overlapped.Offset     = static_cast<DWORD>(request.offset);
+    overlapped.OffsetHigh = static_cast<DWORD>(request.offset >> 32);
+    DWORD readSize = 0;
+    if (!ReadFile(file, buffer.data(), size, &readSize, &overlapped) || readSize != size) {
+        printError("Failed to read the file: %ls", fileWithPath);
+        TERMINATE();
+    }
+    CloseHandle(file);
+    // Release the I/O budget.
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        bytesInFlight -= size;
+    }
+    budgetCond.notify_all();
+}
+
+void AsyncFileReader::State::processRequests() {
+    while (true) {
+        ReadRequest request;
+        {
+            std::unique_lock<std::mutex> lock{mutex};
+            queueCond.wait(lock, [this]() {
+                return !queue.empty() || !isRunning;
+            });
+            if (queue.empty()) return;
+            request = std::move(queue.front());
+            queue.pop_front();
+        }
+        Buffer buffer;
+        if (!request.file.empty()) {
+            readFile(request, buffer);
+        }
+        request.callback(std::move(buffer));
+        {
+            std::lock_guard<std::mutex> lock{mutex};
+            if (0 == --pendingCount) {
+                idleCond.notify_all();
+            }
+        }
+    }
+}
+
+AsyncFileReader::AsyncFileReader(const size_t threadCount, const uint64_t maxBytesInFlight)
+    : m_state{std::make_unique<State>()} {
+    assert(threadCount > 0);
+    m_state->bytesInFlight    = 0;
+    m_state->byteBudget       = maxBytesInFlight;
+    m_state->pendingCount     = 0;
+    m_state->isRunning        = true;
+    for (size_t i = 0; i < threadCount; ++i) {
+        m_state->threads.emplace_back(&State::processRequests, m_state.get());
+    }
+}
+
+AsyncFileReader::AsyncFileReader(AsyncFileReader&& other) noexcept = default;
+
+AsyncFileReader& AsyncFileReader::operator=(AsyncFileReader&& other) noexcept {
+    if (this != &other) {
+        // Shut down the current I/O threads.
+        AsyncFileReader prev{std::move(*this)};
+        m_state = std::move(other.m_state);
+    }
+    return *this;
+}
+
+AsyncFileReader::~AsyncFileReader() noexcept {
+    // Check if it was moved.
+    if (m_state) {
+        // Complete the outstanding requests, and shut down the I/O threads.
+        {
+            std::lock_guard<std::mutex> lock{m_state->mutex};
+            m_state->isRunning = false;
+        }
+        m_state->queueCond.notify_all();
+        for (auto& thread : m_state->threads) {
+            thread.join();
+        }
+        m_state.reset();
+    }
+}
+
+void AsyncFileReader::read(const wchar_t* fileWithPath, Callback callback) {
+    read(fileWithPath, 0, WHOLE_FILE, std::move(callback));
+}
+
+std::future<Buffer> AsyncFileReader::read(const wchar_t* fileWithPath) {
+    // std::function requires a copyable callable.
+    auto promise = std::make_shared<std::promise<Buffer>>();
+    auto future  = promise->get_future();
+    read(fileWithPath, [promise](Buffer&& buffer) {
+        promise->set_value(std::move(buffer));
+    });
+    return future;
+}
+
+void AsyncFileReader::read(const wchar_t* fileWithPath, const uint64_t offset,
+                           const uint32_t size, Callback callback) {
+    assert(fileWithPath && callback);
+    {
+        std::lock_guard<std::mutex> lock{m_state->mutex};
+        m_state->queue.push_back(ReadRequest{fileWithPath, offset, size, std::move(callback)});
+        ++m_state->pendingCount;
+    }
+    m_state->queueCond.notify_one();
+}
+
+void AsyncFileReader::post(Task task) {
+    assert(task);
+    {
+        std::lock_guard<std::mutex> lock{m_state->mutex};
+        m_state->queue.push_back(ReadRequest{std::wstring{}, 0, 0, [task](Buffer&&) { task(); }});
+        ++m_state->pendingCount;
+    }
+    m_state->queueCond.notify_one();
+}
+
+void AsyncFileReader::wait() {
+    std::unique_lock<std::mutex> lock{m_state->mutex};
+    m_state->idleCond.wait(lock, [this]() { return 0 == m_state->pendingCount; });
+}
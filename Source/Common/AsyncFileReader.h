@@ -0,0 +1,35 @@
+#pragma once
+
+#include <functional>
+#include <future>
+#include <memory>
+#include "Buffer.h"
+
+// Asynchronous file reader backed by a pool of I/O threads.
+// Reads are started in submission order, and the total size of the reads in progress is bounded.
+// Completion callbacks run on the I/O threads, so that the processing of the file contents
+// overlaps with the reads of the subsequent files.
+class AsyncFileReader {
+public:
+    using Callback = std::function<void(Buffer&&)>;
+    using Task     = std::function<void()>;
+    RULE_OF_FIVE_MOVE_ONLY(AsyncFileReader);
+    // Ctor; takes the number of I/O threads and the maximal number of bytes
+    // being read at the same time (a single larger file is always allowed).
+    explicit AsyncFileReader(const size_t threadCount, const uint64_t maxBytesInFlight);
+    // Submits a read of the entire file. Invokes 'callback' with the contents on completion.
+    void read(const wchar_t* fileWithPath, Callback callback);
+    // Submits a read of the entire file. Returns the future contents.
+    std::future<Buffer> read(const wchar_t* fileWithPath);
+    // Submits a read of 'size' bytes starting at 'offset' within the file.
+    // Invokes 'callback' with the contents on completion.
+    void read(const wchar_t* fileWithPath, const uint64_t offset, const uint32_t size,
+              Callback callback);
+    // Submits a task which runs on an I/O thread (in submission order) without reading a file.
+    void post(Task task);
+    // Blocks the thread until all submitted reads (and their callbacks) have completed.
+    void wait();
+private:
+    struct State;
+    std::unique_ptr<State> m_state;
+};
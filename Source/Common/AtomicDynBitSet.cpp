@@ -0,0 +1,101 @@
+#include <algorithm>
+#include <cassert>
+#include "AtomicDynBitSet.h"
+#include "Math.h"
+
+AtomicDynBitSet::AtomicDynBitSet()
+    : m_words{nullptr}
+    , m_bitCount{0}
+    , m_wordCount{0} {}
+
+AtomicDynBitSet::AtomicDynBitSet(const size_t size)
+    : m_words{std::make_unique<std::atomic<uint64_t>[]>((size + 63) / 64)}
+    , m_bitCount{static_cast<uint32_t>(size)}
+    , m_wordCount{static_cast<uint32_t>((size + 63) / 64)} {
+    reset(0);
+}
+
+AtomicDynBitSet::AtomicDynBitSet(AtomicDynBitSet&& other) noexcept = default;
+
+AtomicDynBitSet& AtomicDynBitSet::operator=(AtomicDynBitSet&& other) noexcept = default;
+
+AtomicDynBitSet::~AtomicDynBitSet() noexcept = default;
+
+size_t AtomicDynBitSet::size() const {
+    return m_bitCount;
+}
+
+void AtomicDynBitSet::reset(const bool value) {
+    const uint64_t val = value ? UINT64_MAX : 0;
+    for (size_t w = 0; w < m_wordCount; ++w) {
+        m_words[w].store(val, std::memory_order_relaxed);
+    }
+    // Set the unused bits of the last word to 0.
+    const size_t usedBits = m_bitCount % 64;
+    if (value && usedBits) {
+        m_words[m_wordCount - 1].store((uint64_t{1} << usedBits) - 1, std::memory_order_relaxed);
+    }
+}
+
+bool AtomicDynBitSet::clearBit(const size_t index) {
+    assert(index < m_bitCount);
+    const uint64_t mask = uint64_t{1} << (index % 64);
+    return 0 != (m_words[index / 64].fetch_and(~mask, std::memory_order_relaxed) & mask);
+}
+
+bool AtomicDynBitSet::setBit(const size_t index) {
+    assert(index < m_bitCount);
+    const uint64_t mask = uint64_t{1} << (index % 64);
+    return 0 != (m_words[index / 64].fetch_or(mask, std::memory_order_relaxed) & mask);
+}
+
+bool AtomicDynBitSet::testBit(const size_t index) const {
+    assert(index < m_bitCount);
+    const uint64_t mask = uint64_t{1} << (index % 64);
+    return 0 != (m_words[index / 64].load(std::memory_order_relaxed) & mask);
+}
+
+// Returns 64 bits of the 'bits' array (of 'wordCount' words) starting with bit 'offset'.
+static inline auto loadBits(const uint64_t* bits, const size_t wordCount, const size_t offset)
+-> uint64_t {
+    const size_t w     = offset / 64;
+    const size_t shift = offset % 64;
+    uint64_t     value = bits[w] >> shift;
+    if (shift && w + 1 < wordCount) {
+        value |= bits[w + 1] << (64 - shift);
+    }
+    return value;
+}
+
+void AtomicDynBitSet::publishRange(const size_t first, const size_t count,
+                                   const uint64_t* bits) {
+    assert(first + count <= m_bitCount);
+    if (0 == count) return;
+    const size_t end          = first + count;
+    const size_t srcWordCount = (count + 63) / 64;
+    for (size_t w = first / 64, lastWord = (end - 1) / 64; w <= lastWord; ++w) {
+        // Compute the range of bits of the word covered by the source.
+        const size_t lo = std::max(first, w * 64);
+        const size_t hi = std::min(end,   w * 64 + 64);
+        const size_t n  = hi - lo;
+        const uint64_t mask  = (n == 64) ? UINT64_MAX : (((uint64_t{1} << n) - 1) << (lo % 64));
+        const uint64_t value = (loadBits(bits, srcWordCount, lo - first) << (lo % 64)) & mask;
+        if (mask == UINT64_MAX) {
+            // The word is owned by a single writer.
+            m_words[w].store(value, std::memory_order_relaxed);
+        } else {
+            // The word may be shared with a neighbouring range.
+            uint64_t prev = m_words[w].load(std::memory_order_relaxed);
+            while (!m_words[w].compare_exchange_weak(prev, (prev & ~mask) | value,
+                                                     std::memory_order_relaxed)) {}
+        }
+    }
+}
+
+size_t AtomicDynBitSet::popCount() const {
+    size_t count = 0;
+    for (size_t w = 0; w < m_wordCount; ++w) {
+        count += popCount64(m_words[w].load(std::memory_order_relaxed));
+    }
+    return count;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include "Definitions.h"
+
+// Thread-safe BitSet with size specified at runtime.
+// Bits are stored in 64-bit words; bits past the end of the set are always kept at 0.
+// Operations are relaxed: the visibility of the results to other threads
+// must be established by the caller (e.g. by waiting for the writers to finish).
+class AtomicDynBitSet {
+public:
+    RULE_OF_FIVE_MOVE_ONLY(AtomicDynBitSet);
+    // Ctor; performs zero-initialization.
+    AtomicDynBitSet();
+    // Ctor; takes the size (number of bits) as input.
+    explicit AtomicDynBitSet(const size_t size);
+    // Returns the size (number of bits).
+    size_t size() const;
+    // Resets the values of all bits to 'value' (0 or 1). Not thread-safe.
+    void reset(const bool value);
+    // Sets the value of the specified bit to 0. Returns the previous value.
+    bool clearBit(const size_t index);
+    // Sets the value of the specified bit to 1. Returns the previous value.
+    bool setBit(const size_t index);
+    // Returns 'true' if the specified bit is 1, 'false' otherwise.
+    bool testBit(const size_t index) const;
+    // Overwrites the values of 'count' bits starting with 'first'
+    // with the bits of the 'bits' array (starting with bit 0 of 'bits[0]').
+    // Whole words are written with plain atomic stores; only the (at most two)
+    // words shared with neighbouring ranges require atomic read-modify-write operations.
+    // Concurrent writers must publish disjoint bit ranges.
+    void publishRange(const size_t first, const size_t count, const uint64_t* bits);
+    // Returns the number of bits set to 1.
+    size_t popCount() const;
+private:
+    std::unique_ptr<std::atomic<uint64_t>[]> m_words;
+    uint32_t                                 m_bitCount;
+    uint32_t                                 m_wordCount;
+};
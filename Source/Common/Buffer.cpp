@@ -19,6 +19,7 @@ Buffer::Buffer(const char* fileWithPath) {
     rewind(file);
     // Read the file.
     ptr = std::make_unique<byte_t[]>(capacity);
+    memRecord = TrackedMemory{MemHeap::CPU, MemTag::IMPORT, capacity};
     fread(ptr.get(), 1, size, file);
     // Close the file.
     fclose(file);
@@ -2,6 +2,7 @@
 
 #include <memory>
 #include "Definitions.h"
+#include "MemoryStats.h"
 
 struct Buffer {
 	RULE_OF_ZERO(Buffer);
@@ -16,4 +17,5 @@ public:
     std::unique_ptr<byte_t[]> ptr;          // Storage array
     uint32_t                  size;         // Bytes currently used
     uint32_t                  capacity;     // Bytes available in total
+    TrackedMemory             memRecord;    // Memory accounting record
 };
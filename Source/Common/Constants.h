@@ -61,8 +61,18 @@ constexpr auto FORMAT_RTV      = DXGI_FORMAT_R8G8B8A8_UNORM_SRGB;
 constexpr auto FORMAT_DSV      = DXGI_FORMAT_D24_UNORM_S8_UINT;
 // Upload buffer size (32 MiB).
 constexpr auto UPLOAD_BUF_SIZE = 32 * 1024 * 1024;
+// Size of the upload batch which is submitted right away (8 MiB).
+constexpr auto UPLOAD_BATCH_SIZE = 8 * 1024 * 1024;
+// Maximal delay of the submission of an upload batch (in microseconds).
+constexpr auto UPLOAD_BATCH_DELAY = 2000;
+// Size of a GPU heap used for suballocation (64 MiB).
+constexpr auto GPU_HEAP_SIZE   = 64 * 1024 * 1024;
 // Temporary allocator's buffer size (4 KiB).
 constexpr auto TEMP_DATA_SIZE = 4 * 1024;
+// Number of threads performing asynchronous file I/O (and asset decoding).
+constexpr auto IO_THREAD_CNT   = 4;
+// Maximal total size of the file reads in progress (64 MiB).
+constexpr auto IO_BUDGET_SIZE  = 64 * 1024 * 1024;
 // Camera's speed (in meters/sec).
 constexpr auto CAM_SPEED       = 500.f;
 // Camera's angular speed (in radians/sec).
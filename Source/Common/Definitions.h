@@ -38,6 +38,14 @@ using sign_t = ptrdiff_t;
                                   T& operator=(T&&) noexcept;      \
                                   ~T() noexcept
 
+// Declares a -default- Dtor.
+// Forbids copy/move construction and copy/move assignment.
+#define RULE_OF_ZERO_IMMOVABLE(T) T(const T&)                = delete; \
+                                  T& operator=(const T&)     = delete; \
+                                  T(T&&) noexcept            = delete; \
+                                  T& operator=(T&&) noexcept = delete; \
+                                  ~T() noexcept              = default
+
 // Declares a static class which cannot be
 // constructed, destroyed, copied, moved or assigned.
 #define STATIC_CLASS(T) T()                        = delete; \
@@ -0,0 +1,84 @@
+#include <cassert>
+#include "DescriptorAllocator.h"
+#include "Utility.h"
+
+// Marks slots which do not belong to any range.
+static constexpr uint32_t NO_OWNER = UINT32_MAX;
+
+DescriptorAllocator::DescriptorAllocator()
+    : DescriptorAllocator{0} {}
+
+DescriptorAllocator::DescriptorAllocator(const uint32_t capacity)
+    : m_allocator{capacity, 1}
+    , m_ranges(capacity)
+    , m_generations(capacity, 0)
+    , m_owners(capacity, NO_OWNER)
+    , m_pendingFrees{}
+    , m_size{0} {}
+
+DescriptorRange DescriptorAllocator::allocate(const uint32_t count) {
+    assert(count > 0);
+    TlsfAllocation allocation;
+    if (!m_allocator.allocate(count, 1, allocation)) {
+        printError("Descriptor pool exhausted: capacity: %u, in use: %u, requested: %u.",
+                   capacity(), m_size, count);
+        TERMINATE();
+    }
+    const uint32_t index = static_cast<uint32_t>(allocation.offset);
+    m_ranges[index] = allocation;
+    for (uint32_t i = index; i < index + count; ++i) {
+        m_owners[i] = index;
+    }
+    m_size += count;
+    return DescriptorRange{index, count, m_generations[index]};
+}
+
+bool DescriptorAllocator::isValid(const DescriptorRange& range) const {
+    return range.index < capacity()              &&
+           m_owners[range.index] == range.index  &&
+           m_generations[range.index] == range.generation;
+}
+
+bool DescriptorAllocator::isAllocated(const uint32_t index) const {
+    return index < capacity() && m_owners[index] != NO_OWNER;
+}
+
+DescriptorRange DescriptorAllocator::range(const uint32_t index) const {
+    assert(isAllocated(index) && m_owners[index] == index);
+    const uint32_t count = static_cast<uint32_t>(m_ranges[index].size);
+    return DescriptorRange{index, count, m_generations[index]};
+}
+
+void DescriptorAllocator::free(const DescriptorRange& range, const uint64_t fenceValue) {
+    if (!isValid(range)) {
+        printError("Attempted to free a stale descriptor range (index: %u, generation: %u).",
+                   range.index, range.generation);
+        TERMINATE();
+    }
+    assert(m_pendingFrees.empty() || m_pendingFrees.back().fenceValue <= fenceValue);
+    // Invalidate the handle and the slots right away; recycle them later.
+    ++m_generations[range.index];
+    for (uint32_t i = range.index; i < range.index + range.count; ++i) {
+        m_owners[i] = NO_OWNER;
+    }
+    m_pendingFrees.push_back(PendingFree{m_ranges[range.index], fenceValue});
+}
+
+void DescriptorAllocator::reclaim(const uint64_t completedFenceValue) {
+    size_t count = 0;
+    while (count < m_pendingFrees.size() &&
+           m_pendingFrees[count].fenceValue <= completedFenceValue) {
+        const TlsfAllocation& allocation = m_pendingFrees[count++].allocation;
+        m_allocator.free(allocation);
+        m_size -= static_cast<uint32_t>(allocation.size);
+    }
+    m_pendingFrees.erase(m_pendingFrees.begin(), m_pendingFrees.begin() + count);
+}
+
+uint32_t DescriptorAllocator::size() const {
+    return m_size;
+}
+
+uint32_t DescriptorAllocator::capacity() const {
+    return static_cast<uint32_t>(m_generations.size());
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <vector>
+#include "TlsfAllocator.h"
+
+// Generation-tagged handle of a contiguous range of descriptors.
+struct DescriptorRange {
+    uint32_t index;             // Index of the first descriptor
+    uint32_t count;             // Number of descriptors
+    uint32_t generation;        // Generation of the first slot at the time of allocation
+};
+
+// Manages the slots of a descriptor pool (independently of the graphics API).
+// Ranges are allocated from segregated free lists in constant time.
+// Freed ranges are only recycled once the GPU has finished using them (as signaled by
+// a fence), while their handles become stale immediately. Not thread-safe.
+class DescriptorAllocator {
+public:
+    RULE_OF_ZERO_MOVE_ONLY(DescriptorAllocator);
+    // Ctor; creates an empty allocator with no capacity.
+    DescriptorAllocator();
+    // Ctor; takes the number of descriptors of the pool.
+    explicit DescriptorAllocator(const uint32_t capacity);
+    // Allocates a contiguous range of 'count' descriptors (e.g. for a descriptor table).
+    DescriptorRange allocate(const uint32_t count = 1);
+    // Returns 'true' if the range has not been freed since its allocation.
+    bool isValid(const DescriptorRange& range) const;
+    // Returns 'true' if the descriptor belongs to an allocated range.
+    bool isAllocated(const uint32_t index) const;
+    // Returns the handle of the allocated range which starts with the descriptor.
+    DescriptorRange range(const uint32_t index) const;
+    // Frees the range. The slots are recycled once the fence reaches 'fenceValue'.
+    // Fence values must increase monotonically.
+    void free(const DescriptorRange& range, const uint64_t fenceValue);
+    // Recycles the slots of the ranges freed with fence values up to 'completedFenceValue'.
+    void reclaim(const uint64_t completedFenceValue);
+    // Returns the number of descriptors in use (including the ones awaiting recycling).
+    uint32_t size() const;
+    // Returns the number of descriptors of the pool.
+    uint32_t capacity() const;
+private:
+    struct PendingFree {
+        TlsfAllocation               allocation;  // Slots of the freed range
+        uint64_t                     fenceValue;  // Fence value which marks the end of use
+    };
+    TlsfAllocator                    m_allocator;
+    std::vector<TlsfAllocation>      m_ranges;       // Allocated ranges (by the first slot)
+    std::vector<uint32_t>            m_generations;  // Incremented whenever a range is freed
+    std::vector<uint32_t>            m_owners;       // First slot of the range (or UINT32_MAX)
+    std::vector<PendingFree>         m_pendingFrees; // Freed ranges (from the oldest)
+    uint32_t                         m_size;         // Number of descriptors in use
+};
@@ -1,37 +1,40 @@
 #include <cassert>
-#include "DynBitSet.h"
+#include <cstring>
+#include <tmmintrin.h>
+#include "DynBitSet.hpp"
+#include "Math.h"
 
 DynBitSet::DynBitSet()
     : m_bits{nullptr}
     , m_bitCount{0}
-    , m_dwordCount{0} {}
+    , m_wordCount{0} {}
 
 DynBitSet::DynBitSet(const size_t size)
-    : m_bits{std::make_unique<uint32_t[]>((size + 31) / 32)}
+    : m_bits{std::make_unique<uint64_t[]>((size + 63) / 64)}
     , m_bitCount{static_cast<uint32_t>(size)}
-    , m_dwordCount{static_cast<uint32_t>((size + 31) / 32)} {
+    , m_wordCount{static_cast<uint32_t>((size + 63) / 64)} {
     reset(0);
 }
 
 DynBitSet::DynBitSet(const DynBitSet& other)
-    : m_bits{std::make_unique<uint32_t[]>(other.m_dwordCount)}
+    : m_bits{std::make_unique<uint64_t[]>(other.m_wordCount)}
     , m_bitCount{other.m_bitCount}
-    , m_dwordCount{other.m_dwordCount} {
-    memcpy(m_bits.get(), other.m_bits.get(), other.m_dwordCount * sizeof(uint32_t));
+    , m_wordCount{other.m_wordCount} {
+    memcpy(m_bits.get(), other.m_bits.get(), other.m_wordCount * sizeof(uint64_t));
 }
 
 DynBitSet& DynBitSet::operator=(const DynBitSet& other) {
     if (this != &other) {
         m_bitCount = other.m_bitCount;
-        if (m_dwordCount >= other.m_dwordCount) {
+        if (m_wordCount >= other.m_wordCount) {
             // Reuse the currently allocated buffer.
             // The size exposed to the user will be identical to 'other'.
         } else {
             // Allocate a bigger buffer.
-            m_bits = std::make_unique<uint32_t[]>(other.m_dwordCount);
+            m_bits = std::make_unique<uint64_t[]>(other.m_wordCount);
         }
-        m_dwordCount = other.m_dwordCount;
-        memcpy(m_bits.get(), other.m_bits.get(), other.m_dwordCount * sizeof(uint32_t));
+        m_wordCount = other.m_wordCount;
+        memcpy(m_bits.get(), other.m_bits.get(), other.m_wordCount * sizeof(uint64_t));
     }
     return *this;
 }
@@ -42,27 +45,192 @@ DynBitSet& DynBitSet::operator=(DynBitSet&& other) noexcept = default;
 
 DynBitSet::~DynBitSet() noexcept = default;
 
+size_t DynBitSet::size() const {
+    return m_bitCount;
+}
+
+void DynBitSet::clearPadding() {
+    const size_t usedBits = m_bitCount % 64;
+    if (usedBits) {
+        m_bits[m_wordCount - 1] &= (uint64_t{1} << usedBits) - 1;
+    }
+}
+
 void DynBitSet::reset(const bool value) {
     const byte_t val = value ? 0xFF : 0x0;
-    memset(m_bits.get(), val, m_dwordCount * sizeof(uint32_t));
+    memset(m_bits.get(), val, m_wordCount * sizeof(uint64_t));
+    clearPadding();
 }
 
 void DynBitSet::clearBit(const size_t index) {
     assert(index < m_bitCount);
-    m_bits[index / 32] &= ~(1 << (index % 32));
+    m_bits[index / 64] &= ~(uint64_t{1} << (index % 64));
 }
 
 void DynBitSet::setBit(const size_t index) {
     assert(index < m_bitCount);
-    m_bits[index / 32] |= 1 << (index % 32);
+    m_bits[index / 64] |= uint64_t{1} << (index % 64);
 }
 
 void DynBitSet::toggleBit(const size_t index) {
     assert(index < m_bitCount);
-    m_bits[index / 32] ^= 1 << (index % 32);
+    m_bits[index / 64] ^= uint64_t{1} << (index % 64);
 }
 
 bool DynBitSet::testBit(const size_t index) const {
     assert(index < m_bitCount);
-    return 0 != (m_bits[index / 32] & 1 << (index % 32));
+    return 0 != (m_bits[index / 64] & uint64_t{1} << (index % 64));
+}
+
+// Sets the bits in the range [first, first + count) to 'value'.
+static inline void fillRange(uint64_t* words, const size_t first, const size_t count,
+                             const bool value) {
+    if (0 == count) return;
+    const size_t last      = first + count - 1;
+    const size_t firstWord = first / 64;
+    const size_t lastWord  = last  / 64;
+    // Masks of the bits within the first and the last words.
+    const uint64_t firstMask = UINT64_MAX << (first % 64);
+    const uint64_t lastMask  = UINT64_MAX >> (63 - last % 64);
+    if (firstWord == lastWord) {
+        const uint64_t mask = firstMask & lastMask;
+        words[firstWord] = value ? (words[firstWord] | mask) : (words[firstWord] & ~mask);
+    } else {
+        words[firstWord] = value ? (words[firstWord] | firstMask)
+                                 : (words[firstWord] & ~firstMask);
+        // Fill the words in between.
+        memset(&words[firstWord + 1], value ? 0xFF : 0x0,
+               (lastWord - firstWord - 1) * sizeof(uint64_t));
+        words[lastWord]  = value ? (words[lastWord] | lastMask)
+                                 : (words[lastWord] & ~lastMask);
+    }
+}
+
+void DynBitSet::clearRange(const size_t first, const size_t count) {
+    assert(first + count <= m_bitCount);
+    fillRange(m_bits.get(), first, count, false);
+}
+
+void DynBitSet::setRange(const size_t first, const size_t count) {
+    assert(first + count <= m_bitCount);
+    fillRange(m_bits.get(), first, count, true);
+}
+
+// Computes the population count of each byte using a nibble look-up table (SSSE3).
+static inline auto popCountBytes(const __m128i v)
+-> __m128i {
+    const __m128i lut    = _mm_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m128i mask   = _mm_set1_epi8(0x0F);
+    const __m128i loBits = _mm_and_si128(v, mask);
+    const __m128i hiBits = _mm_and_si128(_mm_srli_epi16(v, 4), mask);
+    return _mm_add_epi8(_mm_shuffle_epi8(lut, loBits), _mm_shuffle_epi8(lut, hiBits));
+}
+
+size_t DynBitSet::popCount() const {
+    const uint64_t* words = m_bits.get();
+    size_t  w   = 0;
+    __m128i acc = _mm_setzero_si128();
+    for (; w + 2 <= m_wordCount; w += 2) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(words + w));
+        // Sum the byte counts into two 64-bit lanes.
+        acc = _mm_add_epi64(acc, _mm_sad_epu8(popCountBytes(v), _mm_setzero_si128()));
+    }
+    size_t count = static_cast<size_t>(_mm_cvtsi128_si64(acc) + _mm_extract_epi64(acc, 1));
+    if (w < m_wordCount) {
+        count += popCount64(words[w]);
+    }
+    return count;
+}
+
+bool DynBitSet::none() const {
+    return findFirst() == m_bitCount;
+}
+
+// Returns the index of the first non-zero word starting from 'w', or 'wordCount' if none.
+static inline auto findNonZeroWord(const uint64_t* words, size_t w, const size_t wordCount)
+-> size_t {
+    // Test pairs of words at once.
+    for (; w + 2 <= wordCount; w += 2) {
+        const __m128i pair = _mm_loadu_si128(reinterpret_cast<const __m128i*>(words + w));
+        if (!_mm_testz_si128(pair, pair)) {
+            return words[w] ? w : w + 1;
+        }
+    }
+    return (w < wordCount && words[w]) ? w : wordCount;
+}
+
+size_t DynBitSet::findFirst() const {
+    const size_t w = findNonZeroWord(m_bits.get(), 0, m_wordCount);
+    if (w == m_wordCount) return m_bitCount;
+    unsigned long bit;
+    _BitScanForward64(&bit, m_bits[w]);
+    return w * 64 + bit;
+}
+
+size_t DynBitSet::findNext(const size_t index) const {
+    const size_t next = index + 1;
+    if (next >= m_bitCount) return m_bitCount;
+    size_t   w    = next / 64;
+    // Mask off the bits preceding 'next' within its word.
+    uint64_t word = m_bits[w] & (UINT64_MAX << (next % 64));
+    if (!word) {
+        w = findNonZeroWord(m_bits.get(), w + 1, m_wordCount);
+        if (w == m_wordCount) return m_bitCount;
+        word = m_bits[w];
+    }
+    unsigned long bit;
+    _BitScanForward64(&bit, word);
+    return w * 64 + bit;
+}
+
+// Applies the bitwise operation to 'count' words of 'dst' and 'src', storing the result in 'dst'.
+// Processes 4 words per iteration using SSE2.
+template <typename VecOp, typename ScalarOp>
+static inline void applyBitwiseOp(uint64_t* dst, const uint64_t* src, const size_t count,
+                                  VecOp vecOp, ScalarOp scalarOp) {
+    size_t w = 0;
+    for (; w + 4 <= count; w += 4) {
+        __m128i*       d = reinterpret_cast<__m128i*>(dst + w);
+        const __m128i* s = reinterpret_cast<const __m128i*>(src + w);
+        const __m128i r0 = vecOp(_mm_loadu_si128(d),     _mm_loadu_si128(s));
+        const __m128i r1 = vecOp(_mm_loadu_si128(d + 1), _mm_loadu_si128(s + 1));
+        _mm_storeu_si128(d,     r0);
+        _mm_storeu_si128(d + 1, r1);
+    }
+    for (; w < count; ++w) {
+        dst[w] = scalarOp(dst[w], src[w]);
+    }
+}
+
+DynBitSet& DynBitSet::operator&=(const DynBitSet& other) {
+    assert(m_bitCount == other.m_bitCount);
+    applyBitwiseOp(m_bits.get(), other.m_bits.get(), m_wordCount,
+                   [](const __m128i a, const __m128i b) { return _mm_and_si128(a, b); },
+                   [](const uint64_t a, const uint64_t b) { return a & b; });
+    return *this;
+}
+
+DynBitSet& DynBitSet::operator|=(const DynBitSet& other) {
+    assert(m_bitCount == other.m_bitCount);
+    applyBitwiseOp(m_bits.get(), other.m_bits.get(), m_wordCount,
+                   [](const __m128i a, const __m128i b) { return _mm_or_si128(a, b); },
+                   [](const uint64_t a, const uint64_t b) { return a | b; });
+    return *this;
+}
+
+DynBitSet& DynBitSet::operator^=(const DynBitSet& other) {
+    assert(m_bitCount == other.m_bitCount);
+    applyBitwiseOp(m_bits.get(), other.m_bits.get(), m_wordCount,
+                   [](const __m128i a, const __m128i b) { return _mm_xor_si128(a, b); },
+                   [](const uint64_t a, const uint64_t b) { return a ^ b; });
+    return *this;
+}
+
+DynBitSet& DynBitSet::andNot(const DynBitSet& other) {
+    assert(m_bitCount == other.m_bitCount);
+    // Note: _mm_andnot_si128(x, y) computes (~x & y).
+    applyBitwiseOp(m_bits.get(), other.m_bits.get(), m_wordCount,
+                   [](const __m128i a, const __m128i b) { return _mm_andnot_si128(b, a); },
+                   [](const uint64_t a, const uint64_t b) { return a & ~b; });
+    return *this;
 }
@@ -4,6 +4,7 @@
 #include "Definitions.h"
 
 // BitSet with size specified at runtime.
+// Bits are stored in 64-bit words; bits past the end of the set are always kept at 0.
 class DynBitSet {
 public:
     RULE_OF_FIVE(DynBitSet);
@@ -11,6 +12,8 @@ public:
     DynBitSet();
     // Ctor; takes the size (number of bits) as input.
     explicit DynBitSet(const size_t size);
+    // Returns the size (number of bits).
+    size_t size() const;
     // Resets the values of all bits to 'value' (0 or 1).
     void reset(const bool value);
     // Sets the value of the specified bit to 0.
@@ -21,8 +24,34 @@ public:
     void toggleBit(const size_t index);
     // Returns 'true' if the specified bit is 1, 'false' otherwise.
     bool testBit(const size_t index) const;
+    // Sets the values of 'count' bits starting with 'first' to 0.
+    void clearRange(const size_t first, const size_t count);
+    // Sets the values of 'count' bits starting with 'first' to 1.
+    void setRange(const size_t first, const size_t count);
+    // Returns the number of bits set to 1.
+    size_t popCount() const;
+    // Returns 'true' if no bits are set to 1.
+    bool none() const;
+    // Returns the index of the first bit set to 1, or 'size()' if there are none.
+    size_t findFirst() const;
+    // Returns the index of the first bit set to 1 after the specified bit,
+    // or 'size()' if there are none.
+    size_t findNext(const size_t index) const;
+    // Invokes 'func(index)' for each bit set to 1, in ascending order.
+    // Pairs of 0 words are skipped using a single vector test.
+    template <typename F>
+    void forEachSetBit(F&& func) const;
+    // Bulk bitwise operations. Both sets must have the same size.
+    DynBitSet& operator&=(const DynBitSet& other);
+    DynBitSet& operator|=(const DynBitSet& other);
+    DynBitSet& operator^=(const DynBitSet& other);
+    // Performs (this & ~other).
+    DynBitSet& andNot(const DynBitSet& other);
 private:
-    std::unique_ptr<uint32_t[]> m_bits;
+    // Sets the unused bits of the last word to 0.
+    void clearPadding();
+private:
+    std::unique_ptr<uint64_t[]> m_bits;
     uint32_t                    m_bitCount;
-    uint32_t                    m_dwordCount;
+    uint32_t                    m_wordCount;
 };
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <intrin.h>
+#include <smmintrin.h>
+#include "DynBitSet.h"
+
+template <typename F>
+inline void DynBitSet::forEachSetBit(F&& func) const {
+    const uint64_t* words = m_bits.get();
+    size_t w = 0;
+    // Process pairs of words, skipping empty ones.
+    for (; w + 2 <= m_wordCount; w += 2) {
+        const __m128i pair = _mm_loadu_si128(reinterpret_cast<const __m128i*>(words + w));
+        if (_mm_testz_si128(pair, pair)) continue;
+        for (size_t i = w; i < w + 2; ++i) {
+            uint64_t word = words[i];
+            while (word) {
+                unsigned long bit;
+                _BitScanForward64(&bit, word);
+                func(i * 64 + bit);
+                // Clear the lowest set bit.
+                word &= word - 1;
+            }
+        }
+    }
+    // Process the remaining word.
+    if (w < m_wordCount) {
+        uint64_t word = words[w];
+        while (word) {
+            unsigned long bit;
+            _BitScanForward64(&bit, word);
+            func(w * 64 + bit);
+            word &= word - 1;
+        }
+    }
+}
@@ -0,0 +1,108 @@
+#include <Windows.h>
+#include "FileView.h"
+#include "Utility.h"
+
+// Maps the contents of the file (opened for sequential reading) into memory.
+// Returns the address of the view, and the size of the file in bytes.
+static inline auto mapFile(const HANDLE file, const bool prefetch, uint64_t& size)
+-> const byte_t* {
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize)) {
+        printError("Failed to query the file size.");
+        TERMINATE();
+    }
+    size = static_cast<uint64_t>(fileSize.QuadPart);
+    // Files of size 0 cannot be mapped.
+    if (0 == size) {
+        CloseHandle(file);
+        return nullptr;
+    }
+    const HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        printError("Failed to create a file mapping.");
+        TERMINATE();
+    }
+    const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view) {
+        printError("Failed to map a view of the file.");
+        TERMINATE();
+    }
+    // The view keeps the file mapping alive.
+    CloseHandle(mapping);
+    CloseHandle(file);
+    if (prefetch) {
+        // Issue a single large read instead of faulting the pages in one by one.
+        WIN32_MEMORY_RANGE_ENTRY range = {const_cast<void*>(view), static_cast<size_t>(size)};
+        PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+    }
+    return static_cast<const byte_t*>(view);
+}
+
+FileView::FileView()
+    : m_data{nullptr}
+    , m_size{0} {}
+
+FileView::FileView(const char* fileWithPath, const bool prefetch) {
+    const HANDLE file = CreateFileA(fileWithPath, GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                    OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (INVALID_HANDLE_VALUE == file) {
+        printError("File not found: %s", fileWithPath);
+        TERMINATE();
+    }
+    m_data = mapFile(file, prefetch, m_size);
+}
+
+FileView::FileView(const wchar_t* fileWithPath, const bool prefetch) {
+    const HANDLE file = CreateFileW(fileWithPath, GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                    OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (INVALID_HANDLE_VALUE == file) {
+        printError("File not found: %ls", fileWithPath);
+        TERMINATE();
+    }
+    m_data = mapFile(file, prefetch, m_size);
+}
+
+FileView::FileView(FileView&& other) noexcept
+    : m_data{other.m_data}
+    , m_size{other.m_size} {
+    // Mark as moved.
+    other.m_data = nullptr;
+    other.m_size = 0;
+}
+
+FileView& FileView::operator=(FileView&& other) noexcept {
+    if (this != &other) {
+        if (m_data) {
+            UnmapViewOfFile(m_data);
+        }
+        m_data = other.m_data;
+        m_size = other.m_size;
+        // Mark as moved.
+        other.m_data = nullptr;
+        other.m_size = 0;
+    }
+    return *this;
+}
+
+FileView::~FileView() noexcept {
+    // Check if it was moved.
+    if (m_data) {
+        UnmapViewOfFile(m_data);
+    }
+}
+
+const byte_t* FileView::data() const {
+    return m_data;
+}
+
+uint64_t FileView::size() const {
+    return m_size;
+}
+
+const byte_t* FileView::begin() const {
+    return m_data;
+}
+
+const byte_t* FileView::end() const {
+    return m_data + m_size;
+}
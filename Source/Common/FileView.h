@@ -0,0 +1,23 @@
+#pragma once
+
+#include "Definitions.h"
+
+// Read-only memory-mapped view of an entire file.
+// The contents are paged in on demand, without being copied.
+class FileView {
+public:
+    RULE_OF_FIVE_MOVE_ONLY(FileView);
+    // Constructs an empty view.
+    FileView();
+    // Maps the file into memory. Optionally, prefetches the contents.
+    explicit FileView(const char*    fileWithPath, const bool prefetch = false);
+    explicit FileView(const wchar_t* fileWithPath, const bool prefetch = false);
+    /* Accessors */
+    const byte_t* data() const;
+    uint64_t      size() const;
+    const byte_t* begin() const;
+    const byte_t* end() const;
+private:
+    const byte_t* m_data;    // Start of the mapped region
+    uint64_t      m_size;    // Size of the file in bytes
+};
@@ -0,0 +1,102 @@
+#include <algorithm>
+#include <cassert>
+#include <cinttypes>
+#include "FrameStats.h"
+#include "Utility.h"
+
+FrameStatsHistory::FrameStatsHistory()
+    : m_frames{std::make_unique<FrameStats[]>(capacity)}
+    , m_current{}
+    , m_load{}
+    , m_frameCount{0} {}
+
+FrameStats& FrameStatsHistory::current() {
+    return m_current;
+}
+
+UploadStats& FrameStatsHistory::uploads() {
+    return (m_frameCount > 0) ? m_current.uploads : m_load;
+}
+
+const UploadStats& FrameStatsHistory::loadUploads() const {
+    return m_load;
+}
+
+void FrameStatsHistory::advance() {
+    m_current.frameIndex = m_frameCount;
+    m_frames[m_frameCount % capacity] = m_current;
+    ++m_frameCount;
+    // Start recording a new frame.
+    m_current = FrameStats{};
+}
+
+size_t FrameStatsHistory::size() const {
+    return static_cast<size_t>(std::min<uint64_t>(m_frameCount, capacity));
+}
+
+const FrameStats& FrameStatsHistory::get(const size_t age) const {
+    assert(age < size());
+    return m_frames[(m_frameCount - 1 - age) % capacity];
+}
+
+// Opens the file for writing. Returns 'nullptr' on failure.
+static inline auto openStatsFile(const char* fileWithPath)
+-> FILE* {
+    FILE* file;
+    if (fopen_s(&file, fileWithPath, "w")) {
+        printWarning("Failed to open the file: %s", fileWithPath);
+        return nullptr;
+    }
+    return file;
+}
+
+void FrameStatsHistory::writeCsv(const char* fileWithPath) const {
+    FILE* file = openStatsFile(fileWithPath);
+    if (!file) return;
+    fputs("frame,totalObjs,visObjs,drawnObjs,matSwitches,"
+          "gbDraws,gbIndices,gbDescTables,gbRootConsts,gbBarriers,"
+          "shDraws,shIndices,shDescTables,shRootConsts,shBarriers,"
+          "uploadBytes,uploadStalls,scratchBytes\n", file);
+    for (size_t age = size(); age-- > 0; ) {
+        const FrameStats& s = get(age);
+        fprintf(file, "%" PRIu64 ",%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%" PRIu64 ",%u,%u\n",
+                s.frameIndex, s.totalObjCount, s.visObjCount, s.drawnObjCount, s.matSwitchCount,
+                s.gBufferPass.drawCalls, s.gBufferPass.indexCount,
+                s.gBufferPass.descTableChanges, s.gBufferPass.rootConstChanges,
+                s.gBufferPass.barrierCount,
+                s.shadingPass.drawCalls, s.shadingPass.indexCount,
+                s.shadingPass.descTableChanges, s.shadingPass.rootConstChanges,
+                s.shadingPass.barrierCount,
+                s.uploads.bytes, s.uploads.stalls, s.scratchBytes);
+    }
+    fclose(file);
+}
+
+// Writes the pass statistics as a JSON object.
+static inline void writeJsonPassStats(FILE* file, const char* name, const PassStats& p) {
+    fprintf(file, "\"%s\": {\"drawCalls\": %u, \"indexCount\": %u, "
+                  "\"descTableChanges\": %u, \"rootConstChanges\": %u, \"barriers\": %u}",
+            name, p.drawCalls, p.indexCount, p.descTableChanges, p.rootConstChanges,
+            p.barrierCount);
+}
+
+void FrameStatsHistory::writeJson(const char* fileWithPath) const {
+    FILE* file = openStatsFile(fileWithPath);
+    if (!file) return;
+    fputs("[\n", file);
+    for (size_t age = size(); age-- > 0; ) {
+        const FrameStats& s = get(age);
+        fprintf(file, "  {\"frame\": %" PRIu64 ", \"totalObjs\": %u, \"visObjs\": %u, "
+                      "\"drawnObjs\": %u, \"matSwitches\": %u, ",
+                s.frameIndex, s.totalObjCount, s.visObjCount, s.drawnObjCount,
+                s.matSwitchCount);
+        writeJsonPassStats(file, "gBufferPass", s.gBufferPass);
+        fputs(", ", file);
+        writeJsonPassStats(file, "shadingPass", s.shadingPass);
+        fprintf(file, ", \"uploadBytes\": %" PRIu64 ", \"uploadStalls\": %u, "
+                      "\"scratchBytes\": %u}%s\n",
+                s.uploads.bytes, s.uploads.stalls, s.scratchBytes, age > 0 ? "," : "");
+    }
+    fputs("]\n", file);
+    fclose(file);
+}
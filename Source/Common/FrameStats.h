@@ -0,0 +1,66 @@
+#pragma once
+
+#include <memory>
+#include "Definitions.h"
+
+// Command statistics of a single render pass.
+struct PassStats {
+    uint32_t drawCalls;         // Number of draw calls
+    uint32_t indexCount;        // Number of submitted indices (vertices for non-indexed draws)
+    uint32_t descTableChanges;  // Number of descriptor table bindings
+    uint32_t rootConstChanges;  // Number of root constant updates
+    uint32_t barrierCount;      // Number of resource barriers
+};
+
+// Upload statistics (of a single frame, or of the scene load).
+struct UploadStats {
+    uint64_t bytes;             // Number of bytes written into the upload buffer
+    uint32_t stalls;            // Number of upload buffer reservations which had to wait
+};
+
+// Rendering statistics of a single frame.
+struct FrameStats {
+    uint64_t    frameIndex;     // Index of the frame since the start of the session
+    uint32_t    totalObjCount;  // Number of objects in the scene
+    uint32_t    visObjCount;    // Number of objects which passed frustum culling
+    uint32_t    drawnObjCount;  // Number of objects for which draw calls were issued
+    uint32_t    matSwitchCount; // Number of material switches
+    PassStats   gBufferPass;    // G-buffer generation pass
+    PassStats   shadingPass;    // Shading pass
+    UploadStats uploads;        // Uploads recorded during the frame
+    uint32_t    scratchBytes;   // High-water mark of the temporary allocator (in bytes)
+};
+
+// Fixed-size ring buffer of per-frame statistics.
+// Counters are plain integers updated by the render passes; no allocations take place
+// after construction, so statistics can be kept enabled in release builds.
+class FrameStatsHistory {
+public:
+    RULE_OF_ZERO_MOVE_ONLY(FrameStatsHistory);
+    // Ctor; allocates the history and performs zero-initialization.
+    FrameStatsHistory();
+    // Returns the statistics of the frame currently being recorded.
+    FrameStats& current();
+    // Returns the upload statistics the uploads are charged to: those of the scene load
+    // until the first frame is committed, and those of the current frame afterwards.
+    UploadStats& uploads();
+    // Returns the upload statistics of the scene load (i.e. recorded before the first frame).
+    const UploadStats& loadUploads() const;
+    // Commits the statistics of the current frame to the history, and starts a new frame.
+    void advance();
+    // Returns the number of committed frames stored in the history.
+    size_t size() const;
+    // Returns the statistics of a committed frame; 'age' of 0 corresponds to the last frame.
+    const FrameStats& get(const size_t age) const;
+    // Writes the history (from the oldest to the newest frame) to the file in the CSV format.
+    void writeCsv(const char* fileWithPath) const;
+    // Writes the history (from the oldest to the newest frame) to the file in the JSON format.
+    void writeJson(const char* fileWithPath) const;
+public:
+    static constexpr size_t       capacity = 512; // Maximal number of stored frames
+private:
+    std::unique_ptr<FrameStats[]> m_frames;     // Committed frames (ring buffer)
+    FrameStats                    m_current;    // Frame currently being recorded
+    UploadStats                   m_load;       // Uploads recorded before the first frame
+    uint64_t                      m_frameCount; // Total number of committed frames
+};
@@ -0,0 +1,167 @@
+#include <algorithm>
+#include <cassert>
+#include <cinttypes>
+#include <cmath>
+#include <intrin.h>
+#include "FrameTimeStats.h"
+#include "Utility.h"
+
+LogHistogram::LogHistogram() {
+    reset();
+}
+
+size_t LogHistogram::computeBucketIndex(const uint64_t value) {
+    assert(value <= MAX_VALUE);
+    // Values which fit into the sub-bucket range are stored exactly.
+    if (value < SUB_BUCKET_CNT) {
+        return static_cast<size_t>(value);
+    }
+    // Find the most significant bit.
+    unsigned long msb;
+    _BitScanReverse64(&msb, value);
+    // Keep SUB_BUCKET_BITS bits of precision below the most significant bit.
+    const size_t shift = msb - SUB_BUCKET_BITS;
+    return (shift + 1) * SUB_BUCKET_CNT + static_cast<size_t>(value >> shift) - SUB_BUCKET_CNT;
+}
+
+uint64_t LogHistogram::computeBucketUpperBound(const size_t index) {
+    assert(index < BUCKET_CNT);
+    if (index < SUB_BUCKET_CNT) {
+        return index;
+    }
+    const size_t   shift = index / SUB_BUCKET_CNT - 1;
+    const uint64_t base  = index % SUB_BUCKET_CNT + SUB_BUCKET_CNT;
+    return ((base + 1) << shift) - 1;
+}
+
+void LogHistogram::record(const uint64_t value) {
+    const uint64_t clampedValue = std::min(value, MAX_VALUE);
+    ++m_counts[computeBucketIndex(clampedValue)];
+    ++m_count;
+    m_sum += clampedValue;
+    m_min  = std::min(m_min, clampedValue);
+    m_max  = std::max(m_max, clampedValue);
+}
+
+void LogHistogram::merge(const LogHistogram& other) {
+    for (size_t i = 0; i < BUCKET_CNT; ++i) {
+        m_counts[i] += other.m_counts[i];
+    }
+    m_count += other.m_count;
+    m_sum   += other.m_sum;
+    m_min    = std::min(m_min, other.m_min);
+    m_max    = std::max(m_max, other.m_max);
+}
+
+void LogHistogram::reset() {
+    memset(m_counts, 0, sizeof(m_counts));
+    m_count = 0;
+    m_sum   = 0;
+    m_min   = UINT64_MAX;
+    m_max   = 0;
+}
+
+uint64_t LogHistogram::count() const {
+    return m_count;
+}
+
+uint64_t LogHistogram::minValue() const {
+    return m_count ? m_min : 0;
+}
+
+uint64_t LogHistogram::maxValue() const {
+    return m_max;
+}
+
+double LogHistogram::mean() const {
+    return m_count ? static_cast<double>(m_sum) / m_count : 0.0;
+}
+
+uint64_t LogHistogram::percentile(const double percentile) const {
+    if (0 == m_count) return 0;
+    // Compute the rank of the value (at least 1).
+    const double   fraction = std::min(std::max(percentile, 0.0), 100.0) * 0.01;
+    const uint64_t rank     = std::max<uint64_t>(1, static_cast<uint64_t>(
+                                                        std::ceil(fraction * m_count)));
+    // Find the bucket which contains the value with the computed rank.
+    uint64_t cumulativeCount = 0;
+    for (size_t i = 0; i < BUCKET_CNT; ++i) {
+        cumulativeCount += m_counts[i];
+        if (cumulativeCount >= rank) {
+            return std::min(computeBucketUpperBound(i), m_max);
+        }
+    }
+    return m_max;
+}
+
+FrameTimeStats::FrameTimeStats()
+    : m_slots{std::make_unique<LogHistogram[]>(METRIC_CNT * SLOT_CNT)}
+    , m_session{std::make_unique<LogHistogram[]>(METRIC_CNT)}
+    , m_slotTimes{std::make_unique<uint64_t[]>(SLOT_CNT)} {
+    std::fill_n(m_slotTimes.get(), SLOT_CNT, UINT64_MAX);
+}
+
+void FrameTimeStats::record(const uint64_t cpuFrameTime, const uint64_t gpuFrameTime,
+                            const uint64_t timeStamp) {
+    const uint64_t slotTime  = timeStamp / SLOT_DURATION;
+    const size_t   slotIndex = static_cast<size_t>(slotTime % SLOT_CNT);
+    if (m_slotTimes[slotIndex] != slotTime) {
+        // The slot is reused; discard its old contents (however old they are).
+        assert(UINT64_MAX == m_slotTimes[slotIndex] || m_slotTimes[slotIndex] < slotTime);
+        for (size_t m = 0; m < METRIC_CNT; ++m) {
+            m_slots[m * SLOT_CNT + slotIndex].reset();
+        }
+        m_slotTimes[slotIndex] = slotTime;
+    }
+    const uint64_t gap = (cpuFrameTime > gpuFrameTime) ? cpuFrameTime - gpuFrameTime
+                                                       : gpuFrameTime - cpuFrameTime;
+    const uint64_t values[METRIC_CNT] = {cpuFrameTime, gpuFrameTime, gap};
+    for (size_t m = 0; m < METRIC_CNT; ++m) {
+        m_slots[m * SLOT_CNT + slotIndex].record(values[m]);
+        m_session[m].record(values[m]);
+    }
+}
+
+LogHistogram FrameTimeStats::histogram(const Metric metric, const Window window,
+                                       const uint64_t timeStamp) const {
+    const size_t m = static_cast<size_t>(metric);
+    assert(m < METRIC_CNT);
+    if (Window::SESSION == window) {
+        return m_session[m];
+    }
+    // Merge the slots which overlap the window [timeStamp - duration, timeStamp].
+    const uint64_t duration  = (Window::LAST_1S == window) ? 1000000 : 10000000;
+    const uint64_t firstTime = (timeStamp > duration) ? (timeStamp - duration) / SLOT_DURATION
+                                                      : 0;
+    const uint64_t lastTime  = timeStamp / SLOT_DURATION;
+    LogHistogram result;
+    for (size_t i = 0; i < SLOT_CNT; ++i) {
+        if (firstTime <= m_slotTimes[i] && m_slotTimes[i] <= lastTime) {
+            result.merge(m_slots[m * SLOT_CNT + i]);
+        }
+    }
+    return result;
+}
+
+uint64_t FrameTimeStats::percentile(const Metric metric, const Window window,
+                                    const uint64_t timeStamp, const double percentile) const {
+    return histogram(metric, window, timeStamp).percentile(percentile);
+}
+
+void FrameTimeStats::printReport(const uint64_t timeStamp) const {
+    static const char* metricNames[] = {"CPU", "GPU", "CPU-GPU gap"};
+    static const char* windowNames[] = {"last 1 s", "last 10 s", "session"};
+    printInfo("Frame time report (in milliseconds):");
+    for (size_t m = 0; m < METRIC_CNT; ++m) {
+        for (size_t w = 0; w < static_cast<size_t>(Window::COUNT); ++w) {
+            const LogHistogram h = histogram(static_cast<Metric>(m), static_cast<Window>(w),
+                                             timeStamp);
+            printInfo("- %-11s (%-9s): frames: %6" PRIu64 ", mean: %6.2f, p50: %6.2f, p90: %6.2f, "
+                      "p99: %6.2f, p99.9: %6.2f, max: %6.2f",
+                      metricNames[m], windowNames[w], h.count(), h.mean() * 1e-3,
+                      h.percentile(50.0) * 1e-3, h.percentile(90.0) * 1e-3,
+                      h.percentile(99.0) * 1e-3, h.percentile(99.9) * 1e-3,
+                      h.maxValue() * 1e-3);
+        }
+    }
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <memory>
+#include "Definitions.h"
+
+// Histogram with logarithmic buckets (HDR histogram style) and fixed memory footprint.
+// Each power of 2 is split into 2^SUB_BUCKET_BITS linear sub-buckets,
+// which bounds the relative error of reported values by 2^-SUB_BUCKET_BITS.
+class LogHistogram {
+public:
+    RULE_OF_ZERO(LogHistogram);
+    // Ctor; performs zero-initialization.
+    LogHistogram();
+    // Adds the value to the histogram. Values above MAX_VALUE are clamped. O(1).
+    void record(const uint64_t value);
+    // Adds all values of the other histogram to this histogram.
+    void merge(const LogHistogram& other);
+    // Removes all values from the histogram.
+    void reset();
+    // Returns the number of recorded values.
+    uint64_t count() const;
+    // Returns the smallest recorded value (or 0 if the histogram is empty).
+    uint64_t minValue() const;
+    // Returns the largest recorded value (or 0 if the histogram is empty).
+    uint64_t maxValue() const;
+    // Returns the arithmetic mean of the recorded values (or 0 if the histogram is empty).
+    double mean() const;
+    // Returns the value below which 'percentile' percent (0..100) of values fall.
+    // The result is accurate up to the bucket precision, and never exceeds maxValue().
+    uint64_t percentile(const double percentile) const;
+public:
+    static constexpr size_t   SUB_BUCKET_BITS = 5;
+    static constexpr size_t   SUB_BUCKET_CNT  = size_t{1} << SUB_BUCKET_BITS;
+    // Values are stored with up to 27 significant bits (over 2 minutes in microseconds).
+    static constexpr size_t   VALUE_BITS      = 27;
+    static constexpr uint64_t MAX_VALUE       = (uint64_t{1} << VALUE_BITS) - 1;
+    static constexpr size_t   BUCKET_CNT      = (VALUE_BITS - SUB_BUCKET_BITS + 1) *
+                                                SUB_BUCKET_CNT;
+private:
+    // Returns the index of the bucket containing the value.
+    static size_t computeBucketIndex(const uint64_t value);
+    // Returns the largest value which belongs to the bucket.
+    static uint64_t computeBucketUpperBound(const size_t index);
+private:
+    uint32_t m_counts[BUCKET_CNT];  // Number of values per bucket
+    uint64_t m_count;               // Total number of values
+    uint64_t m_sum;                 // Sum of all values
+    uint64_t m_min, m_max;          // Extrema
+};
+
+// Tracks the CPU frame time, the GPU frame time and the gap between them
+// over rolling time windows. Recording is O(1) and allocation-free.
+// Rolling windows are composed of short slots, each tagged with the time it covers.
+// A window includes the slots which overlap it, so its duration is accurate up to a slot.
+class FrameTimeStats {
+public:
+    enum class Metric {
+        CPU,                        // CPU frame time
+        GPU,                        // GPU frame time
+        GAP,                        // Absolute difference between the CPU and GPU frame times
+        COUNT
+    };
+    enum class Window {
+        LAST_1S,                    // Last second
+        LAST_10S,                   // Last 10 seconds
+        SESSION,                    // Entire session
+        COUNT
+    };
+    RULE_OF_ZERO_MOVE_ONLY(FrameTimeStats);
+    // Ctor; allocates the histograms.
+    FrameTimeStats();
+    // Records the frame times; 'timeStamp' is the time at the end of the frame.
+    // All arguments are in microseconds.
+    void record(const uint64_t cpuFrameTime, const uint64_t gpuFrameTime,
+                const uint64_t timeStamp);
+    // Returns the histogram of the metric over the window ending at 'timeStamp' (in microseconds).
+    // For rolling windows, the histograms of the slots within the window are merged on demand;
+    // slots older than the window (e.g. recorded before a pause) are skipped.
+    LogHistogram histogram(const Metric metric, const Window window,
+                           const uint64_t timeStamp) const;
+    // Returns the specified percentile (0..100) of the metric over the window
+    // ending at 'timeStamp'. All times are in microseconds.
+    uint64_t percentile(const Metric metric, const Window window, const uint64_t timeStamp,
+                        const double percentile) const;
+    // Prints a percentile report for all metrics and windows ending at 'timeStamp'.
+    void printReport(const uint64_t timeStamp) const;
+public:
+    static constexpr uint64_t        SLOT_DURATION = 100000;     // Slot duration (in microseconds)
+    // The longest window, plus the slot which partially overlaps it.
+    static constexpr size_t          SLOT_CNT      = 10000000 / SLOT_DURATION + 1;
+private:
+    static constexpr size_t          METRIC_CNT    = static_cast<size_t>(Metric::COUNT);
+    // Histograms of the slots [metric][slot] and the session [metric].
+    std::unique_ptr<LogHistogram[]>  m_slots;
+    std::unique_ptr<LogHistogram[]>  m_session;
+    // Absolute indices (time stamps divided by SLOT_DURATION) of the slots [slot].
+    // Slots which have never been recorded to are marked with UINT64_MAX.
+    std::unique_ptr<uint64_t[]>      m_slotTimes;
+};
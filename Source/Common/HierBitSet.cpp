@@ -0,0 +1,113 @@
+#include <cassert>
+#include <cstring>
+#include "HierBitSet.hpp"
+#include "Math.h"
+
+HierBitSet::HierBitSet()
+    : m_leaves{nullptr}
+    , m_summary{nullptr}
+    , m_bitCount{0}
+    , m_leafCount{0}
+    , m_summaryCount{0} {}
+
+HierBitSet::HierBitSet(const size_t size)
+    : m_leaves{std::make_unique<uint64_t[]>((size + 63) / 64)}
+    , m_summary{std::make_unique<uint64_t[]>((size + 4095) / 4096)}
+    , m_bitCount{static_cast<uint32_t>(size)}
+    , m_leafCount{static_cast<uint32_t>((size + 63) / 64)}
+    , m_summaryCount{static_cast<uint32_t>((size + 4095) / 4096)} {
+    memset(m_leaves.get(),  0, m_leafCount    * sizeof(uint64_t));
+    memset(m_summary.get(), 0, m_summaryCount * sizeof(uint64_t));
+}
+
+HierBitSet::HierBitSet(const HierBitSet& other)
+    : m_leaves{std::make_unique<uint64_t[]>(other.m_leafCount)}
+    , m_summary{std::make_unique<uint64_t[]>(other.m_summaryCount)}
+    , m_bitCount{other.m_bitCount}
+    , m_leafCount{other.m_leafCount}
+    , m_summaryCount{other.m_summaryCount} {
+    memcpy(m_leaves.get(),  other.m_leaves.get(),  m_leafCount    * sizeof(uint64_t));
+    memcpy(m_summary.get(), other.m_summary.get(), m_summaryCount * sizeof(uint64_t));
+}
+
+HierBitSet& HierBitSet::operator=(const HierBitSet& other) {
+    if (this != &other) {
+        if (m_leafCount < other.m_leafCount) {
+            // Allocate bigger buffers.
+            m_leaves  = std::make_unique<uint64_t[]>(other.m_leafCount);
+            m_summary = std::make_unique<uint64_t[]>(other.m_summaryCount);
+        }
+        m_bitCount     = other.m_bitCount;
+        m_leafCount    = other.m_leafCount;
+        m_summaryCount = other.m_summaryCount;
+        memcpy(m_leaves.get(),  other.m_leaves.get(),  m_leafCount    * sizeof(uint64_t));
+        memcpy(m_summary.get(), other.m_summary.get(), m_summaryCount * sizeof(uint64_t));
+    }
+    return *this;
+}
+
+HierBitSet::HierBitSet(HierBitSet&& other) noexcept = default;
+
+HierBitSet& HierBitSet::operator=(HierBitSet&& other) noexcept = default;
+
+HierBitSet::~HierBitSet() noexcept = default;
+
+size_t HierBitSet::size() const {
+    return m_bitCount;
+}
+
+void HierBitSet::clear() {
+    for (size_t s = 0; s < m_summaryCount; ++s) {
+        uint64_t summary = m_summary[s];
+        while (summary) {
+            unsigned long leafBit;
+            _BitScanForward64(&leafBit, summary);
+            m_leaves[s * 64 + leafBit] = 0;
+            summary &= summary - 1;
+        }
+        m_summary[s] = 0;
+    }
+}
+
+void HierBitSet::clearBit(const size_t index) {
+    assert(index < m_bitCount);
+    const size_t l = index / 64;
+    m_leaves[l] &= ~(uint64_t{1} << (index % 64));
+    if (0 == m_leaves[l]) {
+        // Update the summary.
+        m_summary[l / 64] &= ~(uint64_t{1} << (l % 64));
+    }
+}
+
+void HierBitSet::setBit(const size_t index) {
+    assert(index < m_bitCount);
+    const size_t l = index / 64;
+    m_leaves[l]       |= uint64_t{1} << (index % 64);
+    m_summary[l / 64] |= uint64_t{1} << (l % 64);
+}
+
+bool HierBitSet::testBit(const size_t index) const {
+    assert(index < m_bitCount);
+    return 0 != (m_leaves[index / 64] & uint64_t{1} << (index % 64));
+}
+
+bool HierBitSet::none() const {
+    for (size_t s = 0; s < m_summaryCount; ++s) {
+        if (m_summary[s]) return false;
+    }
+    return true;
+}
+
+size_t HierBitSet::popCount() const {
+    size_t count = 0;
+    for (size_t s = 0; s < m_summaryCount; ++s) {
+        uint64_t summary = m_summary[s];
+        while (summary) {
+            unsigned long leafBit;
+            _BitScanForward64(&leafBit, summary);
+            count += popCount64(m_leaves[s * 64 + leafBit]);
+            summary &= summary - 1;
+        }
+    }
+    return count;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <memory>
+#include "Definitions.h"
+
+// Two-level BitSet with size specified at runtime, suitable for sparse sets.
+// Bits are stored in 64-bit leaf words; each bit of a summary word
+// indicates whether the corresponding leaf word is non-zero.
+// Therefore, a single summary word covers 64 * 64 = 4096 bits.
+class HierBitSet {
+public:
+    RULE_OF_FIVE(HierBitSet);
+    // Ctor; performs zero-initialization.
+    HierBitSet();
+    // Ctor; takes the size (number of bits) as input.
+    explicit HierBitSet(const size_t size);
+    // Returns the size (number of bits).
+    size_t size() const;
+    // Sets the values of all bits to 0.
+    // Only touches the non-zero leaf words.
+    void clear();
+    // Sets the value of the specified bit to 0.
+    void clearBit(const size_t index);
+    // Sets the value of the specified bit to 1.
+    void setBit(const size_t index);
+    // Returns 'true' if the specified bit is 1, 'false' otherwise.
+    bool testBit(const size_t index) const;
+    // Returns 'true' if no bits are set to 1.
+    bool none() const;
+    // Returns the number of bits set to 1.
+    size_t popCount() const;
+    // Invokes 'func(index)' for each bit set to 1, in ascending order.
+    // Only visits the non-zero leaf words.
+    template <typename F>
+    void forEachSetBit(F&& func) const;
+private:
+    std::unique_ptr<uint64_t[]> m_leaves;
+    std::unique_ptr<uint64_t[]> m_summary;
+    uint32_t                    m_bitCount;
+    uint32_t                    m_leafCount;
+    uint32_t                    m_summaryCount;
+};
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <intrin.h>
+#include "HierBitSet.h"
+
+template <typename F>
+inline void HierBitSet::forEachSetBit(F&& func) const {
+    for (size_t s = 0; s < m_summaryCount; ++s) {
+        uint64_t summary = m_summary[s];
+        while (summary) {
+            unsigned long leafBit;
+            _BitScanForward64(&leafBit, summary);
+            const size_t l    = s * 64 + leafBit;
+            uint64_t     word = m_leaves[l];
+            while (word) {
+                unsigned long bit;
+                _BitScanForward64(&bit, word);
+                func(l * 64 + bit);
+                // Clear the lowest set bit.
+                word &= word - 1;
+            }
+            summary &= summary - 1;
+        }
+    }
+}
@@ -0,0 +1,166 @@
+#include <algorithm>
+#include <cstring>
+#include "LZCodec.h"
+
+// Minimal match length.
+static constexpr size_t LZ_MIN_MATCH  = 4;
+// Maximal match offset.
+static constexpr size_t LZ_MAX_OFFSET = 65535;
+// Size of the match finder's hash table (log2).
+static constexpr size_t LZ_HASH_BITS  = 14;
+// Number of trailing bytes which are always encoded as literals.
+static constexpr size_t LZ_TAIL_SIZE  = 8;
+
+// Loads 4 bytes from an unaligned address.
+static inline auto load32(const byte_t* ptr)
+-> uint32_t {
+    uint32_t value;
+    memcpy(&value, ptr, sizeof(value));
+    return value;
+}
+
+// Computes the hash table index of the 4-byte sequence.
+static inline auto hashSequence(const uint32_t sequence)
+-> size_t {
+    return (sequence * 2654435761u) >> (32 - LZ_HASH_BITS);
+}
+
+// Writes the continuation bytes of the length.
+static inline auto writeLength(size_t length, byte_t* dst)
+-> byte_t* {
+    for (; length >= 255; length -= 255) {
+        *dst++ = 255;
+    }
+    *dst++ = static_cast<byte_t>(length);
+    return dst;
+}
+
+// Reads the continuation bytes of the length. Returns 'false' on overrun.
+static inline auto readLength(const byte_t*& src, const byte_t* srcEnd, size_t& length)
+-> bool {
+    byte_t value;
+    do {
+        if (src >= srcEnd) return false;
+        value   = *src++;
+        length += value;
+    } while (255 == value);
+    return true;
+}
+
+// Writes a record. A record with 'matchLength' of 0 only contains literals.
+static inline auto writeRecord(const byte_t* literals, const size_t literalLength,
+                               const size_t offset, const size_t matchLength, byte_t* dst)
+-> byte_t* {
+    byte_t* token = dst++;
+    // Encode the literals.
+    const size_t litCode = literalLength < 15 ? literalLength : 15;
+    if (litCode == 15) {
+        dst = writeLength(literalLength - 15, dst);
+    }
+    memcpy(dst, literals, literalLength);
+    dst += literalLength;
+    // Encode the match.
+    size_t matchCode = 0;
+    if (matchLength > 0) {
+        *dst++ = static_cast<byte_t>(offset);
+        *dst++ = static_cast<byte_t>(offset >> 8);
+        const size_t length = matchLength - LZ_MIN_MATCH;
+        matchCode = length < 15 ? length : 15;
+        if (matchCode == 15) {
+            dst = writeLength(length - 15, dst);
+        }
+    }
+    *token = static_cast<byte_t>((litCode << 4) | matchCode);
+    return dst;
+}
+
+size_t LZCodec::compressBound(const size_t size) {
+    // Token, literal length continuation bytes, literals.
+    return 1 + size / 255 + 1 + size;
+}
+
+size_t LZCodec::compress(const byte_t* src, const size_t srcSize, byte_t* dst) {
+    byte_t* const dstBegin = dst;
+    // Table of the most recent positions of 4-byte sequences.
+    static thread_local uint32_t hashTable[size_t{1} << LZ_HASH_BITS];
+    memset(hashTable, 0, sizeof(hashTable));
+    size_t literalStart = 0;
+    if (srcSize > LZ_TAIL_SIZE + LZ_MIN_MATCH) {
+        const size_t matchLimit = srcSize - LZ_TAIL_SIZE;
+        // Position 0 is implied by the zero-initialized table, so it is skipped.
+        size_t pos = 1;
+        while (pos < matchLimit) {
+            const uint32_t sequence  = load32(src + pos);
+            const size_t   hash      = hashSequence(sequence);
+            const size_t   candidate = hashTable[hash];
+            hashTable[hash] = static_cast<uint32_t>(pos);
+            if (pos - candidate > LZ_MAX_OFFSET || load32(src + candidate) != sequence) {
+                ++pos;
+                continue;
+            }
+            // Extend the match forward.
+            size_t matchLength = LZ_MIN_MATCH;
+            while (pos + matchLength < matchLimit &&
+                   src[candidate + matchLength] == src[pos + matchLength]) {
+                ++matchLength;
+            }
+            dst = writeRecord(src + literalStart, pos - literalStart, pos - candidate,
+                              matchLength, dst);
+            pos += matchLength;
+            literalStart = pos;
+        }
+    }
+    // Encode the remaining bytes as literals.
+    dst = writeRecord(src + literalStart, srcSize - literalStart, 0, 0, dst);
+    return static_cast<size_t>(dst - dstBegin);
+}
+
+bool LZCodec::decompress(const byte_t* src, const size_t srcSize,
+                         byte_t* dst, const size_t dstSize) {
+    const byte_t* const srcEnd   = src + srcSize;
+    byte_t* const       dstBegin = dst;
+    byte_t* const       dstEnd   = dst + dstSize;
+    while (src < srcEnd) {
+        const byte_t token = *src++;
+        // Copy the literals.
+        size_t literalLength = token >> 4;
+        if (15 == literalLength && !readLength(src, srcEnd, literalLength)) return false;
+        if (literalLength > static_cast<size_t>(srcEnd - src) ||
+            literalLength > static_cast<size_t>(dstEnd - dst)) return false;
+        if (literalLength <= 16 && srcEnd - src >= 16 && dstEnd - dst >= 16) {
+            // Fast path: copy a fixed-size block (possibly past the end of the literals).
+            memcpy(dst, src, 16);
+        } else {
+            memcpy(dst, src, literalLength);
+        }
+        src += literalLength;
+        dst += literalLength;
+        // The last record only contains literals.
+        if (src == srcEnd) break;
+        // Copy the match.
+        if (srcEnd - src < 2) return false;
+        const size_t offset = src[0] | (static_cast<size_t>(src[1]) << 8);
+        src += 2;
+        size_t matchLength = token & 15;
+        if (15 == matchLength && !readLength(src, srcEnd, matchLength)) return false;
+        matchLength += LZ_MIN_MATCH;
+        if (0 == offset || offset > static_cast<size_t>(dst - dstBegin) ||
+            matchLength > static_cast<size_t>(dstEnd - dst)) return false;
+        const byte_t* match = dst - offset;
+        if (offset >= 16 && matchLength <= 16 && dstEnd - dst >= 16) {
+            // Fast path: copy a fixed-size block (possibly past the end of the match).
+            memcpy(dst, match, 16);
+            dst += matchLength;
+            continue;
+        }
+        // If the match overlaps the destination, it repeats with the period of 'offset'.
+        // Therefore, the size of the copy can be doubled at each step.
+        while (matchLength > 0) {
+            const size_t count = std::min(static_cast<size_t>(dst - match), matchLength);
+            memcpy(dst, match, count);
+            dst         += count;
+            matchLength -= count;
+        }
+    }
+    return dst == dstEnd;
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "Definitions.h"
+
+// Fast byte-oriented LZ77 codec (similar to LZ4).
+// The compressed stream is a sequence of {token, literals, match offset, match length} records.
+// The token contains the literal length (4 high bits) and the match length (4 low bits);
+// lengths which do not fit are continued using extra bytes (255 means "more to follow").
+// The stream always ends with a record containing only literals.
+class LZCodec {
+public:
+    STATIC_CLASS(LZCodec);
+    // Returns the maximal compressed size of 'size' bytes of data.
+    static size_t compressBound(const size_t size);
+    // Compresses 'srcSize' bytes of 'src' into 'dst' (of at least 'compressBound(srcSize)' bytes).
+    // Returns the compressed size.
+    static size_t compress(const byte_t* src, const size_t srcSize, byte_t* dst);
+    // Decompresses 'srcSize' bytes of 'src' into exactly 'dstSize' bytes of 'dst'.
+    // Returns 'false' if the compressed data is malformed.
+    static bool decompress(const byte_t* src, const size_t srcSize,
+                           byte_t* dst, const size_t dstSize);
+};
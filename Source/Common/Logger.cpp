@@ -0,0 +1,195 @@
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include "Logger.h"
+
+// Maximal length of a single message (including the null terminator); longer ones are truncated.
+static constexpr size_t LOG_MSG_SIZE = 240;
+// Capacity of the ring buffer (number of records). Must be a power of 2.
+static constexpr size_t LOG_RING_CNT = 1024;
+// Period (in milliseconds) with which the background thread polls the ring buffer.
+static constexpr auto   LOG_POLL_MS  = std::chrono::milliseconds{2};
+
+static_assert(0 == (LOG_RING_CNT & (LOG_RING_CNT - 1)), "The ring size must be a power of 2.");
+
+struct LogRecord {
+    uint64_t timeStamp;                     // Microseconds since the start of the log
+    LogLevel level;                         // Severity
+    char     message[LOG_MSG_SIZE];         // Formatted message
+};
+
+// Ring buffer cell. The sequence number determines whether the cell is
+// ready for writing (sequence == position) or reading (sequence == position + 1).
+struct alignas(64) LogCell {
+    std::atomic<size_t> sequence;
+    LogRecord           record;
+};
+
+using Clock = std::chrono::steady_clock;
+
+// Logger state.
+static LogCell               logRing[LOG_RING_CNT];
+static std::atomic<size_t>   logEnqueuePos;     // Advanced by producers
+static std::atomic<size_t>   logDequeuePos;     // Advanced by the consumer
+static std::atomic<uint64_t> logDropCount;      // Number of dropped records
+static std::atomic<bool>     logIsRunning;      // Whether the background thread is active
+static std::once_flag        logInitFlag;
+static std::mutex            logDrainMutex;     // Held by the consumer (never by producers)
+static std::thread           logThread;
+static Clock::time_point     logStartTime;
+
+// Writes out a single record.
+static inline void printRecord(const LogRecord& record) {
+    FILE* stream = (LogLevel::FATAL == record.level) ? stderr : stdout;
+    const char* prefix = "";
+    switch (record.level) {
+        case LogLevel::WARNING: prefix = "Warning: "; break;
+        case LogLevel::FATAL:   prefix = "Error: ";   break;
+        default:                                      break;
+    }
+    const uint64_t seconds = record.timeStamp / 1000000;
+    const uint64_t millis  = record.timeStamp / 1000 % 1000;
+    fprintf(stream, "[%" PRIu64 ".%03" PRIu64 "] %s%s\n", seconds, millis, prefix,
+            record.message);
+}
+
+// Writes out all records available for reading. Returns the number of written records.
+// Must be called with 'logDrainMutex' held, which makes the caller the sole consumer.
+static size_t drainRing() {
+    static uint64_t reportedDropCount = 0;
+    size_t count = 0;
+    size_t pos   = logDequeuePos.load(std::memory_order_relaxed);
+    while (true) {
+        LogCell& cell = logRing[pos & (LOG_RING_CNT - 1)];
+        if (cell.sequence.load(std::memory_order_acquire) != pos + 1) break;
+        printRecord(cell.record);
+        // Make the cell available to the producers on the next lap.
+        cell.sequence.store(pos + LOG_RING_CNT, std::memory_order_release);
+        logDequeuePos.store(++pos, std::memory_order_release);
+        ++count;
+    }
+    // Report overflows.
+    const uint64_t dropCount = logDropCount.load(std::memory_order_relaxed);
+    if (dropCount != reportedDropCount) {
+        fprintf(stdout, "Warning: %" PRIu64 " log record(s) dropped due to overflow.\n",
+                dropCount - reportedDropCount);
+        reportedDropCount = dropCount;
+    }
+    if (count > 0) {
+        fflush(stdout);
+    }
+    return count;
+}
+
+// Stops the background thread, and writes out the remaining records.
+static void stopLogger() {
+    logIsRunning.store(false, std::memory_order_release);
+    if (logThread.joinable()) {
+        logThread.join();
+    }
+    std::lock_guard<std::mutex> lock{logDrainMutex};
+    drainRing();
+}
+
+// Initializes the ring buffer, and starts the background thread.
+static void startLogger() {
+    for (size_t i = 0; i < LOG_RING_CNT; ++i) {
+        logRing[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    logEnqueuePos.store(0, std::memory_order_relaxed);
+    logDequeuePos.store(0, std::memory_order_relaxed);
+    logDropCount.store(0, std::memory_order_relaxed);
+    logStartTime = Clock::now();
+    logIsRunning.store(true, std::memory_order_release);
+    logThread = std::thread{[]() {
+        while (logIsRunning.load(std::memory_order_acquire)) {
+            size_t count;
+            {
+                std::lock_guard<std::mutex> lock{logDrainMutex};
+                count = drainRing();
+            }
+            if (0 == count) {
+                std::this_thread::sleep_for(LOG_POLL_MS);
+            }
+        }
+    }};
+    // Write out the remaining records at exit.
+    atexit(stopLogger);
+}
+
+// Writes out the pending records followed by the message on the calling thread.
+static void writeSynchronously(const uint64_t timeStamp, const LogLevel level,
+                               const char* fmt, va_list args) {
+    LogRecord record;
+    record.timeStamp = timeStamp;
+    record.level     = level;
+    vsnprintf(record.message, LOG_MSG_SIZE, fmt, args);
+    std::lock_guard<std::mutex> lock{logDrainMutex};
+    drainRing();
+    printRecord(record);
+    fflush((LogLevel::FATAL == level) ? stderr : stdout);
+}
+
+void Logger::write(const LogLevel level, const char* fmt, va_list args) {
+    std::call_once(logInitFlag, startLogger);
+    const uint64_t timeStamp = std::chrono::duration_cast<std::chrono::microseconds>(
+                               Clock::now() - logStartTime).count();
+    // Claim a cell.
+    LogCell* cell;
+    size_t   pos = logEnqueuePos.load(std::memory_order_relaxed);
+    while (true) {
+        cell = &logRing[pos & (LOG_RING_CNT - 1)];
+        const size_t seq  = cell->sequence.load(std::memory_order_acquire);
+        const sign_t diff = static_cast<sign_t>(seq) - static_cast<sign_t>(pos);
+        if (0 == diff) {
+            // The cell is free; try to advance the enqueue position.
+            if (logEnqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            // The ring buffer is full.
+            if (LogLevel::FATAL == level) {
+                // Fatal errors typically precede termination, so they must not be lost.
+                writeSynchronously(timeStamp, level, fmt, args);
+            } else {
+                logDropCount.fetch_add(1, std::memory_order_relaxed);
+            }
+            return;
+        } else {
+            // Another producer has claimed the cell.
+            pos = logEnqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+    // Format the message in place.
+    cell->record.timeStamp = timeStamp;
+    cell->record.level     = level;
+    vsnprintf(cell->record.message, LOG_MSG_SIZE, fmt, args);
+    // Publish the record.
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    // Wait for fatal errors to be written out (the process is likely about to terminate).
+    // Fall back to synchronous output if the background thread has been stopped.
+    if (LogLevel::FATAL == level || !logIsRunning.load(std::memory_order_acquire)) {
+        flush();
+    }
+}
+
+void Logger::flush() {
+    const size_t target = logEnqueuePos.load(std::memory_order_acquire);
+    while (logDequeuePos.load(std::memory_order_acquire) < target) {
+        if (!logIsRunning.load(std::memory_order_acquire)) {
+            // The consumer is gone; write out the records on this thread.
+            std::lock_guard<std::mutex> lock{logDrainMutex};
+            drainRing();
+        } else {
+            std::this_thread::yield();
+        }
+    }
+}
+
+uint64_t Logger::droppedCount() {
+    return logDropCount.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdarg>
+#include "Definitions.h"
+
+// Severity of a log record.
+enum class LogLevel : uint8_t {
+    INFO,       // Printed to stdout without a prefix
+    WARNING,    // Printed to stdout with the "Warning:" prefix
+    FATAL       // Printed to stderr with the "Error:" prefix
+};
+
+// Asynchronous logger.
+// Callers format messages directly into a bounded lock-free multi-producer single-consumer
+// ring buffer, and a background thread writes them out. Producers never block each other;
+// if the ring buffer is full, the record is dropped and counted instead.
+// Fatal errors are the exception: they are never dropped, and are written out synchronously.
+class Logger {
+public:
+    STATIC_CLASS(Logger);
+    // Formats the message (printf syntax) and enqueues it for output. Appends a newline.
+    // Time stamps are taken from a monotonic clock (seconds since the first record).
+    // FATAL records (and all records enqueued before them) are written out before returning.
+    static void write(const LogLevel level, const char* fmt, va_list args);
+    // Blocks the thread until all records enqueued before the call have been written out.
+    static void flush();
+    // Returns the number of records dropped due to ring buffer overflow.
+    static uint64_t droppedCount();
+};
@@ -34,6 +34,16 @@ constexpr auto isPow2(const T v)
     return 0 == (v & (v - 1));
 }
 
+// Returns the number of bits set to 1 (SWAR).
+// Note: the POPCNT instruction is not available on all SSE4.1 CPUs.
+static inline auto popCount64(uint64_t v)
+-> size_t {
+    v = v - ((v >> 1) & 0x5555555555555555ull);
+    v = (v & 0x3333333333333333ull) + ((v >> 2) & 0x3333333333333333ull);
+    v = (v + (v >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+    return static_cast<size_t>((v * 0x0101010101010101ull) >> 56);
+}
+
 // Aligns the integer number to the next multiple of alignment.
 template <size_t alignment>
 static inline auto align(const size_t number)
@@ -0,0 +1,168 @@
+#include <atomic>
+#include <cassert>
+#include "MemoryStats.h"
+#include "Utility.h"
+
+static constexpr size_t HEAP_CNT = static_cast<size_t>(MemHeap::COUNT);
+static constexpr size_t TAG_CNT  = static_cast<size_t>(MemTag::COUNT);
+
+struct MemCounters {
+    std::atomic<uint64_t> current;      // Bytes currently allocated
+    std::atomic<uint64_t> peak;         // Peak number of bytes
+    std::atomic<uint64_t> count;        // Number of live allocations
+};
+
+// Counters per heap and tag, and per heap (all tags).
+static MemCounters           memCounters[HEAP_CNT][TAG_CNT];
+static MemCounters           memTotals[HEAP_CNT];
+static std::atomic<uint64_t> memBudgets[HEAP_CNT];
+
+// Atomically updates the maximum.
+static inline void updatePeak(std::atomic<uint64_t>& peak, const uint64_t value) {
+    uint64_t prevPeak = peak.load(std::memory_order_relaxed);
+    while (prevPeak < value &&
+           !peak.compare_exchange_weak(prevPeak, value, std::memory_order_relaxed)) {}
+}
+
+// Adds the allocation to the counters.
+static inline void addAllocation(MemCounters& counters, const size_t size) {
+    const uint64_t current = counters.current.fetch_add(size, std::memory_order_relaxed) + size;
+    counters.count.fetch_add(1, std::memory_order_relaxed);
+    updatePeak(counters.peak, current);
+}
+
+// Removes the allocation from the counters.
+static inline void removeAllocation(MemCounters& counters, const size_t size) {
+    assert(counters.current.load(std::memory_order_relaxed) >= size);
+    counters.current.fetch_sub(size, std::memory_order_relaxed);
+    counters.count.fetch_sub(1, std::memory_order_relaxed);
+}
+
+static inline auto getCounters(const MemHeap heap, const MemTag tag)
+-> MemCounters& {
+    assert(heap < MemHeap::COUNT && tag < MemTag::COUNT);
+    return memCounters[static_cast<size_t>(heap)][static_cast<size_t>(tag)];
+}
+
+void MemoryStats::recordAllocation(const MemHeap heap, const MemTag tag, const size_t size) {
+    addAllocation(getCounters(heap, tag), size);
+    addAllocation(memTotals[static_cast<size_t>(heap)], size);
+}
+
+void MemoryStats::recordDeallocation(const MemHeap heap, const MemTag tag, const size_t size) {
+    removeAllocation(getCounters(heap, tag), size);
+    removeAllocation(memTotals[static_cast<size_t>(heap)], size);
+}
+
+uint64_t MemoryStats::currentSize(const MemHeap heap, const MemTag tag) {
+    return getCounters(heap, tag).current.load(std::memory_order_relaxed);
+}
+
+uint64_t MemoryStats::peakSize(const MemHeap heap, const MemTag tag) {
+    return getCounters(heap, tag).peak.load(std::memory_order_relaxed);
+}
+
+uint64_t MemoryStats::allocationCount(const MemHeap heap, const MemTag tag) {
+    return getCounters(heap, tag).count.load(std::memory_order_relaxed);
+}
+
+uint64_t MemoryStats::totalSize(const MemHeap heap) {
+    return memTotals[static_cast<size_t>(heap)].current.load(std::memory_order_relaxed);
+}
+
+uint64_t MemoryStats::totalPeakSize(const MemHeap heap) {
+    return memTotals[static_cast<size_t>(heap)].peak.load(std::memory_order_relaxed);
+}
+
+void MemoryStats::setBudget(const MemHeap heap, const uint64_t budget) {
+    memBudgets[static_cast<size_t>(heap)].store(budget, std::memory_order_relaxed);
+}
+
+void MemoryStats::printReport() {
+    static const char* heapNames[HEAP_CNT] = {"CPU", "GPU"};
+    static const char* tagNames[TAG_CNT]   = {"Vertex buffers*", "Index buffers*",
+                                              "Constant buffers*", "Textures",
+                                              "Render targets", "Upload buffer",
+                                              "Scratch", "Import", "Other"};
+    constexpr double MiB = 1.0 / (1024 * 1024);
+    printInfo("Memory report (current / peak, in MiB):");
+    for (size_t h = 0; h < HEAP_CNT; ++h) {
+        const auto heap = static_cast<MemHeap>(h);
+        printInfo("%s heap: %.2f / %.2f", heapNames[h],
+                  totalSize(heap) * MiB, totalPeakSize(heap) * MiB);
+        for (size_t t = 0; t < TAG_CNT; ++t) {
+            const auto tag = static_cast<MemTag>(t);
+            if (0 == peakSize(heap, tag)) continue;
+            printInfo("- %-16s: %8.2f / %8.2f (%llu allocations)", tagNames[t],
+                      currentSize(heap, tag) * MiB, peakSize(heap, tag) * MiB,
+                      static_cast<unsigned long long>(allocationCount(heap, tag)));
+        }
+        if (MemHeap::GPU == heap) {
+            printInfo("- (*) Cumulative: buffers are never released.");
+        }
+        const uint64_t budget = memBudgets[h].load(std::memory_order_relaxed);
+        if (budget > 0) {
+            const uint64_t peak = totalPeakSize(heap);
+            printInfo("- Budget: %.2f (peak usage: %.1f%%)", budget * MiB,
+                      100.0 * peak / budget);
+            if (peak > budget) {
+                printWarning("%s memory budget exceeded by %.2f MiB.", heapNames[h],
+                             (peak - budget) * MiB);
+            }
+        }
+    }
+}
+
+TrackedMemory::TrackedMemory()
+    : m_heap{MemHeap::CPU}
+    , m_tag{MemTag::OTHER}
+    , m_size{0} {}
+
+TrackedMemory::TrackedMemory(const MemHeap heap, const MemTag tag, const size_t size)
+    : m_heap{heap}
+    , m_tag{tag}
+    , m_size{size} {
+    if (m_size) {
+        MemoryStats::recordAllocation(m_heap, m_tag, m_size);
+    }
+}
+
+void TrackedMemory::resize(const size_t size) {
+    if (m_size == size) return;
+    if (m_size) {
+        MemoryStats::recordDeallocation(m_heap, m_tag, m_size);
+    }
+    m_size = size;
+    if (m_size) {
+        MemoryStats::recordAllocation(m_heap, m_tag, m_size);
+    }
+}
+
+TrackedMemory::TrackedMemory(TrackedMemory&& other) noexcept
+    : m_heap{other.m_heap}
+    , m_tag{other.m_tag}
+    , m_size{other.m_size} {
+    // Mark as moved.
+    other.m_size = 0;
+}
+
+TrackedMemory& TrackedMemory::operator=(TrackedMemory&& other) noexcept {
+    if (this != &other) {
+        if (m_size) {
+            MemoryStats::recordDeallocation(m_heap, m_tag, m_size);
+        }
+        m_heap = other.m_heap;
+        m_tag  = other.m_tag;
+        m_size = other.m_size;
+        // Mark as moved.
+        other.m_size = 0;
+    }
+    return *this;
+}
+
+TrackedMemory::~TrackedMemory() noexcept {
+    // Check if it was moved.
+    if (m_size) {
+        MemoryStats::recordDeallocation(m_heap, m_tag, m_size);
+    }
+}
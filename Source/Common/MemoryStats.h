@@ -0,0 +1,67 @@
+#pragma once
+
+#include "Definitions.h"
+
+// Memory domain.
+enum class MemHeap : uint8_t {
+    CPU,                // System memory
+    GPU,                // Video memory (or system memory visible to the GPU)
+    COUNT
+};
+
+// Subsystem which owns the memory.
+// Buffers are never released (the buffer heaps only grow), so the GPU buffer tags are cumulative.
+// Descriptor heaps are not tracked: their size is driver-defined, and cannot be queried.
+enum class MemTag : uint8_t {
+    VERTEX_BUFFER,      // Vertex attribute buffers (cumulative)
+    INDEX_BUFFER,       // Index buffers (cumulative)
+    CONSTANT_BUFFER,    // Constant and structured buffers (cumulative)
+    TEXTURE,            // Textures (including all MIP levels)
+    RENDER_TARGET,      // G-buffer render targets and depth buffers
+    UPLOAD_BUFFER,      // Upload ring buffer
+    SCRATCH,            // Temporary (linear) allocators
+    IMPORT,             // Asset import temporaries (file contents, decoded images, etc.)
+    OTHER,              // Everything else
+    COUNT
+};
+
+// Thread-safe tagged memory accounting.
+// Tracks current and peak sizes per heap and tag, and compares them against budgets.
+class MemoryStats {
+public:
+    STATIC_CLASS(MemoryStats);
+    // Records an allocation of 'size' bytes.
+    static void recordAllocation(const MemHeap heap, const MemTag tag, const size_t size);
+    // Records a deallocation of 'size' bytes.
+    static void recordDeallocation(const MemHeap heap, const MemTag tag, const size_t size);
+    // Returns the number of bytes currently allocated.
+    static uint64_t currentSize(const MemHeap heap, const MemTag tag);
+    // Returns the largest number of bytes allocated at any point of time.
+    static uint64_t peakSize(const MemHeap heap, const MemTag tag);
+    // Returns the number of live allocations.
+    static uint64_t allocationCount(const MemHeap heap, const MemTag tag);
+    // Returns the number of bytes currently allocated within the heap (all tags).
+    static uint64_t totalSize(const MemHeap heap);
+    // Returns the peak number of bytes allocated within the heap (all tags).
+    static uint64_t totalPeakSize(const MemHeap heap);
+    // Sets the budget (in bytes) of the heap. 0 means no budget.
+    static void setBudget(const MemHeap heap, const uint64_t budget);
+    // Prints the current and peak sizes per heap and tag, and checks them against the budgets.
+    static void printReport();
+};
+
+// Records an allocation for the lifetime of the object (RAII).
+class TrackedMemory {
+public:
+    RULE_OF_FIVE_MOVE_ONLY(TrackedMemory);
+    // Ctor; does not record anything.
+    TrackedMemory();
+    // Ctor; records an allocation of 'size' bytes (if non-zero).
+    explicit TrackedMemory(const MemHeap heap, const MemTag tag, const size_t size);
+    // Changes the recorded size to 'size' bytes.
+    void resize(const size_t size);
+private:
+    MemHeap m_heap;
+    MemTag  m_tag;
+    size_t  m_size;
+};
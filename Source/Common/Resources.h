@@ -2,6 +2,7 @@
 
 #include <memory>
 #include "Definitions.h"
+#include "MemoryStats.h"
 
 // A linear allocator which uses N static, non-growing memory regions of the same size.
 // It works as a ring buffer: switching from the buffer (N - 1) causes the buffer 0 to be used.
@@ -19,6 +20,8 @@ public:
     void switchToNextBuffer();
     // Resets the allocator to its initial state.
     void reset();
+    // Returns the number of bytes allocated within the current buffer.
+    size_t allocatedSize() const;
 private:
     // Returns the pointer to the end of the current buffer.
     // It coincides with the beginning of the next buffer if wrap around does not occur.
@@ -27,6 +30,7 @@ private:
     size_t                    m_size;       // Size of each buffer
     byte_t*                   m_current;    // Current (free) position within the heap region
     std::unique_ptr<byte_t[]> m_heapRegion; // Heap region backing N buffers
+    TrackedMemory             m_memRecord;  // Memory accounting record
 };
 
 using LinearAllocator = BufferedLinearAllocator<1>;
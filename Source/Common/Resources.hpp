@@ -6,7 +6,8 @@
 template <size_t N>
 inline BufferedLinearAllocator<N>::BufferedLinearAllocator(const size_t size)
     : m_size{size}
-    , m_heapRegion{std::make_unique<byte_t[]>(size * N)} {
+    , m_heapRegion{std::make_unique<byte_t[]>(size * N)}
+    , m_memRecord{MemHeap::CPU, MemTag::SCRATCH, size * N} {
     static_assert(N >= 1, "BufferedLinearAllocator must have at least 1 buffer.");
     assert(size >= 64 && "The size of the buffer cannot be smaller than 64 bytes.");
     m_current = m_heapRegion.get();
@@ -54,3 +55,9 @@ template <size_t N>
 inline void BufferedLinearAllocator<N>::reset() {
     m_current = m_heapRegion.get();
 }
+
+template <size_t N>
+inline auto BufferedLinearAllocator<N>::allocatedSize() const
+-> size_t {
+    return m_size - static_cast<size_t>(computeBufferEnd() - m_current);
+}
@@ -1,6 +1,14 @@
+#include <atomic>
+#include <chrono>
 #include <DirectXTex\DirectXTex.h>
+#include <future>
 #include <load_obj.h>
+#include <mutex>
+#include "AssetPack.h"
+#include "AsyncFileReader.h"
+#include "FileView.h"
 #include "Math.h"
+#include "MemoryStats.h"
 #include "Scene.h"
 #include "Utility.h"
 #include "..\D3D12\Renderer.hpp"
@@ -16,14 +24,12 @@ public:
     std::vector<uint32_t> indices;
 };
 
-// Returns 'true' if the string (path or filename) has a '.tga' extension.
-static inline auto hasTgaExt(const std::string& str)
+// Returns 'true' if the string (path or filename) has the extension 'ext' (e.g. ".tga").
+static inline auto hasExt(const std::string& str, const char* ext)
 -> bool {
-    const size_t len = str.length();
-    return len > 4 && '.' == str[len - 4] &&
-                      't' == str[len - 3] &&
-                      'g' == str[len - 2] &&
-                      'a' == str[len - 1];
+    const size_t len    = str.length();
+    const size_t extLen = strlen(ext);
+    return len > extLen && 0 == str.compare(len - extLen, extLen, ext);
 }
 
 // Converts the string 'str' to a UTF-8 character string 'wideStr' of length up to 'wideStrLen'.
@@ -37,16 +43,194 @@ static inline void convertToUtf8(const std::string& str, const size_t wideStrLen
     }
 }
 
+// Decoded texture (with a complete MIP chain), ready to be uploaded to the GPU.
+// The image data resides either in the MIP chain, or in the memory the view refers to.
+struct ImportedTexture {
+    ScratchImage              mipChain;     // Image data
+    ImageView                 view;         // Image data within the .dds file (used if not empty)
+    std::unique_ptr<byte_t[]> contents;     // Decompressed file contents (referred to by the view)
+    TrackedMemory             memRecord;    // Memory accounting record
+};
+
+// Texture import statistics.
+struct ImportStats {
+    std::atomic<uint64_t> textureCount;     // Number of imported textures
+    std::atomic<uint64_t> allocationCount;  // Number of import buffer (re)allocations
+    std::atomic<uint64_t> bytesCopied;      // Number of bytes copied (not counting decoding)
+};
+
+// Buffers of an I/O thread reused by the textures decoded on the thread.
+// They grow to the size of the largest texture, and are freed once the thread exits.
+struct DecodeArena {
+    DecodeArena() : dataCapacity{0}, memRecord{MemHeap::CPU, MemTag::IMPORT, 0} {
+        image.RetainBuffers(true);
+    }
+    // Returns a buffer of at least 'size' bytes for the decompressed file contents.
+    byte_t* reserveData(const size_t size, ImportStats& stats) {
+        if (dataCapacity < size) {
+            data         = std::make_unique<byte_t[]>(size);
+            dataCapacity = size;
+            ++stats.allocationCount;
+        }
+        return data.get();
+    }
+public:
+    std::unique_ptr<byte_t[]> data;         // Decompressed file contents
+    size_t                    dataCapacity; // Size of the buffer (in bytes)
+    ScratchImage              image;        // Decoded image (the base MIP level)
+    TrackedMemory             memRecord;    // Memory accounting record
+};
+
+static thread_local DecodeArena decodeArena;
+
+// Pool of MIP chains, which are filled by the I/O threads and consumed by the main thread.
+// The chains keep their buffers once released, so that they can be reused by other textures.
+class MipChainPool {
+public:
+    MipChainPool() : m_capacity{0}, m_memRecord{MemHeap::CPU, MemTag::IMPORT, 0} {}
+    // Returns an empty MIP chain (with retained buffers).
+    ScratchImage acquire() {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        if (m_chains.empty()) {
+            ScratchImage mipChain;
+            mipChain.RetainBuffers(true);
+            return mipChain;
+        }
+        ScratchImage mipChain = std::move(m_chains.back());
+        m_chains.pop_back();
+        m_capacity -= mipChain.GetPixelsCapacity();
+        m_memRecord.resize(m_capacity);
+        return mipChain;
+    }
+    // Returns the MIP chain to the pool.
+    void release(ScratchImage&& mipChain) {
+        mipChain.Release();
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_capacity += mipChain.GetPixelsCapacity();
+        m_memRecord.resize(m_capacity);
+        m_chains.push_back(std::move(mipChain));
+    }
+private:
+    std::mutex                m_mutex;
+    std::vector<ScratchImage> m_chains;
+    size_t                    m_capacity;   // Total size of the pooled buffers (in bytes)
+    TrackedMemory             m_memRecord;  // Memory accounting record
+};
+
+// Decodes the .tga file, and generates MIP maps.
+// The decompressed contents and the decoded image reside in the arena of the calling thread.
+static inline auto importTgaTexture(const byte_t* data, const size_t size,
+                                    MipChainPool& mipChainPool, ImportStats& stats)
+-> ImportedTexture {
+    DecodeArena&  arena = decodeArena;
+    ScratchImage& img   = arena.image;
+    // Decode the .tga texture.
+    const size_t imgCapacity = img.GetPixelsCapacity();
+    CHECK_CALL(LoadFromTGAMemory(data, size, TGA_FLAGS_NONE, nullptr, img),
+               "Failed to load the .tga file.");
+    if (imgCapacity < img.GetPixelsCapacity()) ++stats.allocationCount;
+    // Perform quick verification.
+    assert(1 == img.GetImageCount());
+    assert(TEX_DIMENSION_TEXTURE2D == img.GetMetadata().dimension);
+    // Generate MIP maps. The base level is copied into the MIP chain.
+    ImportedTexture texture;
+    texture.mipChain = mipChainPool.acquire();
+    const size_t mipCapacity = texture.mipChain.GetPixelsCapacity();
+    CHECK_CALL(GenerateMipMaps(*img.GetImages(), TEX_FILTER_DEFAULT, 0, texture.mipChain),
+               "Failed to generate MIP maps.");
+    if (mipCapacity < texture.mipChain.GetPixelsCapacity()) ++stats.allocationCount;
+    stats.bytesCopied += img.GetPixelsSize();
+    // Account for the import buffers.
+    arena.memRecord.resize(arena.dataCapacity + img.GetPixelsCapacity());
+    texture.memRecord = TrackedMemory{MemHeap::CPU, MemTag::IMPORT,
+                                      texture.mipChain.GetPixelsCapacity()};
+    return texture;
+}
+
+// Imports the .dds file the view of the texture refers to. If the file contains MIP maps,
+// the texture is uploaded directly from the file contents. Otherwise, MIP maps are generated.
+static inline auto importDdsTexture(ImportedTexture&& texture, const std::string& texName,
+                                    MipChainPool& mipChainPool, ImportStats& stats)
+-> ImportedTexture {
+    const TexMetadata& info = texture.view.GetMetadata();
+    // Only uncompressed 2D textures can be uploaded.
+    if (1 != info.arraySize || TEX_DIMENSION_TEXTURE2D != info.dimension || info.IsCubemap() ||
+        IsCompressed(info.format) || IsPlanar(info.format) || IsPalettized(info.format)) {
+        printError("Unsupported .dds texture (only uncompressed 2D textures are supported): %s",
+                   texName.c_str());
+        TERMINATE();
+    }
+    // Legacy formats are converted (copied) while loading, so the file contents are not needed.
+    if (texture.view.IsCopy()) {
+        ++stats.allocationCount;
+        stats.bytesCopied += texture.view.GetPixelsSize();
+        texture.contents.reset();
+        texture.memRecord = TrackedMemory{MemHeap::CPU, MemTag::IMPORT,
+                                          texture.view.GetPixelsSize()};
+    }
+    if (1 == info.mipLevels) {
+        // Generate MIP maps. The base level is copied into the MIP chain.
+        texture.mipChain = mipChainPool.acquire();
+        const size_t mipCapacity = texture.mipChain.GetPixelsCapacity();
+        CHECK_CALL(GenerateMipMaps(*texture.view.GetImages(), TEX_FILTER_DEFAULT, 0,
+                                   texture.mipChain),
+                   "Failed to generate MIP maps.");
+        if (mipCapacity < texture.mipChain.GetPixelsCapacity()) ++stats.allocationCount;
+        stats.bytesCopied += texture.view.GetPixelsSize();
+        // The file contents are no longer needed.
+        texture.view.Release();
+        texture.contents.reset();
+        texture.memRecord = TrackedMemory{MemHeap::CPU, MemTag::IMPORT,
+                                          texture.mipChain.GetPixelsCapacity()};
+    }
+    return std::move(texture);
+}
+
 // Map where Key = texture name, Value = pair {texture : texture index}.
 using TextureMap = std::unordered_map<std::string, std::pair<D3D12::Texture, uint32_t>>;
+// Map where Key = texture name, Value = texture being read and decoded.
+using PendingTextureMap = std::unordered_map<std::string, std::future<ImportedTexture>>;
 
 Scene::Scene(const char* path, const char* objFileName, D3D12::Renderer& engine) {
     assert(path && objFileName);
-    const std::string pathStr = path;
+    const auto startTime = std::chrono::steady_clock::now();
+    const std::string pathStr    = path;
+    const std::string objFileStr = objFileName;
+    // Use the asset pack with the same name as the .obj file (if present) instead of loose files.
+    const std::string packFileStr = pathStr + objFileStr.substr(0, objFileStr.rfind('.')) + ".pack";
+    std::unique_ptr<AssetPack> assetPack;
+    if (INVALID_FILE_ATTRIBUTES != GetFileAttributesA(packFileStr.c_str())) {
+        printInfo("Using the asset pack: %s", packFileStr.c_str());
+        assetPack = std::make_unique<AssetPack>(packFileStr.c_str());
+    }
+    // Locates the asset (either within the pack, or as a loose file),
+    // and invokes 'parse(data, size)' with its contents. Returns the result of 'parse'.
+    auto parseAsset = [&pathStr, &assetPack](const std::string& name, auto parse) {
+        if (assetPack) {
+            AssetRange range;
+            if (!assetPack->find(name.c_str(), range)) return false;
+            if (range.isCompressed) {
+                // Decompress the asset.
+                const size_t        size = static_cast<size_t>(range.size);
+                const auto          data = std::make_unique<byte_t[]>(size);
+                const TrackedMemory memRecord{MemHeap::CPU, MemTag::IMPORT, size};
+                assetPack->read(range, data.get());
+                return parse(reinterpret_cast<const char*>(data.get()), size);
+            }
+            return parse(reinterpret_cast<const char*>(assetPack->data(range)),
+                         static_cast<size_t>(range.size));
+        } else {
+            const FileView fileView{(pathStr + name).c_str(), true};
+            return parse(reinterpret_cast<const char*>(fileView.data()),
+                         static_cast<size_t>(fileView.size()));
+        }
+    };
     // Load the .obj file.
     printInfo("Loading a scene from the file: %s", objFileName);
     obj::File objFile;
-    if (!load_obj(pathStr + std::string{objFileName}, objFile)) {
+    if (!parseAsset(objFileStr, [&objFile](const char* data, const size_t size) {
+        return load_obj(data, size, objFile);
+    })) {
         printError("Failed to load the file: %s", objFileName);
         TERMINATE();
     }
@@ -99,11 +283,16 @@ Scene::Scene(const char* path, const char* objFileName, D3D12::Renderer& engine)
     std::vector<XMFLOAT3> positions{numVertices};
     std::vector<XMFLOAT3> normals{numVertices};
     std::vector<XMFLOAT2> uvCoords{numVertices};
+    const TrackedMemory vertexMemRecord{MemHeap::CPU, MemTag::IMPORT,
+                                        numVertices * (2 * sizeof(XMFLOAT3) + sizeof(XMFLOAT2))};
     for (const auto& entry : indexMap) {
         const size_t vertId = entry.second;
         positions[vertId] = objFile.vertices[entry.first.v];
         normals[vertId]   = objFile.normals[entry.first.n];
         uvCoords[vertId]  = objFile.texcoords[entry.first.t];
+        // The origin of the .obj texture space is at the bottom left, while D3D textures
+        // (and the image files) start with the top row. Flip V instead of the images.
+        uvCoords[vertId].y = 1.f - uvCoords[vertId].y;
     }
     vertexAttrBuffers.assign(0, engine.createVertexBuffer(numVertices, positions.data()));
     vertexAttrBuffers.assign(1, engine.createVertexBuffer(numVertices, normals.data()));
@@ -117,8 +306,6 @@ Scene::Scene(const char* path, const char* objFileName, D3D12::Renderer& engine)
         // Store material indices.
         objects.materialIndices[i] = static_cast<uint16_t>(indexedObjects[i].material);
     }
-    // Copy scene geometry to the GPU.
-    engine.executeCopyCommands();
     // Compute bounding boxes.
     for (size_t i = 0; i < objects.count; ++i) {
         const IndexedObject& io  = indexedObjects[i];
@@ -128,56 +315,169 @@ Scene::Scene(const char* path, const char* objFileName, D3D12::Renderer& engine)
     obj::MaterialLib matLib;
     for (const auto& matLibFileName: objFile.mtl_libs) {
         printInfo("Loading a material library from the file: %s", matLibFileName.c_str());
-        if (!load_mtl(pathStr + matLibFileName, matLib)) {
-            printError("Failed to load the file: %s", matLibFileName);
+        if (!parseAsset(matLibFileName, [&matLib](const char* data, const size_t size) {
+            return load_mtl(data, size, matLib);
+        })) {
+            printError("Failed to load the file: %s", matLibFileName.c_str());
             TERMINATE();
         }
     }
+    // Issue the reads of all textures referenced by the materials up front.
+    // The textures are decoded by the I/O threads as soon as their files have been read
+    // (or mapped, if the files are loose).
+    // The material library (texture names), the pool and the statistics are used by
+    // the I/O threads, so they must outlive the reader.
+    MipChainPool      mipChainPool;
+    ImportStats       importStats{};
+    AsyncFileReader   fileReader{IO_THREAD_CNT, IO_BUDGET_SIZE};
+    PendingTextureMap pendingTextures;
+    wchar_t packFilePath[128];
+    if (assetPack) {
+        convertToUtf8(packFileStr, 128, packFilePath);
+    }
+    for (const auto& matName : objFile.materials) {
+        const auto matIt = matLib.find(matName);
+        if (matIt == matLib.end()) continue;
+        const obj::Material& material = matIt->second;
+        for (const std::string* texName : {&material.map_ka, &material.map_kd, &material.map_bump,
+                                           &material.map_d,  &material.map_ns}) {
+            if (texName->empty() || pendingTextures.count(*texName)) continue;
+            // Currently, only .tga and .dds textures are supported.
+            const bool isDds = hasExt(*texName, ".dds");
+            if (!isDds && !hasExt(*texName, ".tga")) {
+                printError("Unsupported texture file format: %s", texName->c_str());
+                TERMINATE();
+            }
+            // std::function requires a copyable callable.
+            auto promise = std::make_shared<std::promise<ImportedTexture>>();
+            pendingTextures.emplace(*texName, promise->get_future());
+            if (assetPack) {
+                // Read the byte range of the texture from the pack.
+                AssetRange range;
+                if (!assetPack->find(texName->c_str(), range)) {
+                    printError("Texture not found in the asset pack: %s", texName->c_str());
+                    TERMINATE();
+                }
+                if (!range.isCompressed) {
+                    // Refer to the file within the memory-mapped pack instead of reading it.
+                    const byte_t* data = assetPack->data(range);
+                    const size_t  size = static_cast<size_t>(range.size);
+                    fileReader.post([promise, data, size, isDds, texName,
+                                     &mipChainPool, &importStats]() {
+                        if (isDds) {
+                            ImportedTexture texture;
+                            CHECK_CALL(LoadFromDDSMemory(data, size, DDS_FLAGS_NONE, nullptr,
+                                                         texture.view),
+                                       "Failed to load the .dds file.");
+                            promise->set_value(importDdsTexture(std::move(texture), *texName,
+                                                                mipChainPool, importStats));
+                        } else {
+                            promise->set_value(importTgaTexture(data, size,
+                                                                mipChainPool, importStats));
+                        }
+                    });
+                    continue;
+                }
+                // Read the compressed texture, which must be decompressed before decoding.
+                // The pack guarantees that the stored size is below UINT32_MAX.
+                fileReader.read(packFilePath, range.offset, static_cast<uint32_t>(range.storedSize),
+                                [promise, range, isDds, texName,
+                                 &mipChainPool, &importStats](Buffer&& file) {
+                    if (isDds) {
+                        // Decompress the .dds file into a buffer kept alive by the texture.
+                        const size_t    size = static_cast<size_t>(range.size);
+                        ImportedTexture texture;
+                        texture.contents  = std::make_unique<byte_t[]>(size);
+                        texture.memRecord = TrackedMemory{MemHeap::CPU, MemTag::IMPORT, size};
+                        AssetPack::decompress(file.data(), range, texture.contents.get());
+                        CHECK_CALL(LoadFromDDSMemory(texture.contents.get(), size, DDS_FLAGS_NONE,
+                                                     nullptr, texture.view),
+                                   "Failed to load the .dds file.");
+                        promise->set_value(importDdsTexture(std::move(texture), *texName,
+                                                            mipChainPool, importStats));
+                    } else {
+                        // Decompress the texture into the arena of the I/O thread.
+                        const size_t size = static_cast<size_t>(range.size);
+                        byte_t*      data = decodeArena.reserveData(size, importStats);
+                        AssetPack::decompress(file.data(), range, data);
+                        promise->set_value(importTgaTexture(data, size, mipChainPool, importStats));
+                    }
+                });
+            } else {
+                // Combine the path and the filename.
+                wchar_t texFilePath[128];
+                convertToUtf8(pathStr + *texName, 128, texFilePath);
+                if (isDds) {
+                    // Map the .dds file instead of reading it, so that the texture is uploaded
+                    // directly from the file cache.
+                    fileReader.post([promise, texFilePath, texName,
+                                     &mipChainPool, &importStats]() {
+                        ImportedTexture texture;
+                        CHECK_CALL(LoadFromDDSFile(texFilePath, DDS_FLAGS_NONE, nullptr,
+                                                   texture.view),
+                                   "Failed to load the .dds file.");
+                        promise->set_value(importDdsTexture(std::move(texture), *texName,
+                                                            mipChainPool, importStats));
+                    });
+                    continue;
+                }
+                // Map the .tga file instead of reading it, so that it is decoded in place
+                // (from the file cache) rather than copied into a buffer first.
+                fileReader.post([promise, texFilePath, &mipChainPool, &importStats]() {
+                    const FileView fileView{texFilePath, true};
+                    promise->set_value(importTgaTexture(fileView.data(),
+                                                        static_cast<size_t>(fileView.size()),
+                                                        mipChainPool, importStats));
+                });
+            }
+        }
+    }
     // Store textures in a map to avoid duplicates.
     TextureMap texLib;
     // Acquires the texture index by either looking it up in the texture library,
-    // or loading it from disk (and subsequently adding it to the library).
-    auto acquireTexureIndex = [&texLib, &pathStr, &engine](const std::string& texName) {
+    // or waiting for it to be imported (and subsequently adding it to the library).
+    auto acquireTexureIndex = [&texLib, &pendingTextures, &mipChainPool, &importStats,
+                               &engine](const std::string& texName) {
         if (texName.empty()) return UINT32_MAX;
-        // Currently, only .tga textures are supported.
-        assert(hasTgaExt(texName));
-        // Check whether we have to load the texture.
+        // Check whether we have to upload the texture.
         const auto texIt = texLib.find(texName);
         if (texIt != texLib.end()) {
             return texIt->second.second;
         } else {
-            // Combine the path and the filename.
-            wchar_t tgaFilePath[128];
-            convertToUtf8(pathStr + texName, 128, tgaFilePath);
-            // Load the .tga texture.
-            ScratchImage tmp;
-            CHECK_CALL(LoadFromTGAFile(tgaFilePath, nullptr, tmp),
-                       "Failed to load the .tga file.");
-            // Perform quick verification.
-            assert(1 == tmp.GetImageCount());
-            assert(TEX_DIMENSION_TEXTURE2D == tmp.GetMetadata().dimension);
-            // Flip the image.
-            ScratchImage img;
-            CHECK_CALL(FlipRotate(*tmp.GetImages(), TEX_FR_FLIP_VERTICAL, img),
-                       "Failed to perform a vertical image flip.");
-            // Generate MIP maps.
-            ScratchImage mipChain;
-            CHECK_CALL(GenerateMipMaps(*img.GetImages(), TEX_FILTER_DEFAULT, 0, mipChain),
-                       "Failed to generate MIP maps.");
-            const TexMetadata& info = mipChain.GetMetadata();
+            // Wait for the texture to be imported.
+            ImportedTexture     imported = pendingTextures.at(texName).get();
+            const ImageView&    view     = imported.view;
+            const ScratchImage& mipChain = imported.mipChain;
+            // Upload the texture directly from the file contents, if possible.
+            const bool          isView   = nullptr != view.GetPixels();
+            const TexMetadata&  info     = isView ? view.GetMetadata()   : mipChain.GetMetadata();
+            const Image*        images   = isView ? view.GetImages()     : mipChain.GetImages();
+            const size_t        size     = isView ? view.GetPixelsSize() : mipChain.GetPixelsSize();
             // Describe the 2D texture.
             const D3D12_SUBRESOURCE_FOOTPRINT footprint = {
                 /* Format */   info.format,
                 /* Width */    static_cast<uint32_t>(info.width),
                 /* Height */   static_cast<uint32_t>(info.height),
                 /* Depth */    static_cast<uint32_t>(info.depth),
-                /* RowPitch */ static_cast<uint32_t>(mipChain.GetImages()->rowPitch)
+                /* RowPitch */ static_cast<uint32_t>(images->rowPitch)
             };
             const uint32_t mipCount = static_cast<uint32_t>(info.mipLevels);
+            // Pass the MIP levels individually, since their pitches are not necessarily
+            // fractions of the pitch of the base level.
+            std::vector<D3D12_SUBRESOURCE_DATA> mipData(mipCount);
+            for (uint32_t i = 0; i < mipCount; ++i) {
+                mipData[i].pData      = images[i].pixels;
+                mipData[i].RowPitch   = static_cast<LONG_PTR>(images[i].rowPitch);
+                mipData[i].SlicePitch = static_cast<LONG_PTR>(images[i].slicePitch);
+            }
             // Create a texture.
-            D3D12::Texture texture  = engine.createTexture2D(footprint, mipCount,
-                                                             mipChain.GetPixels());
+            D3D12::Texture texture  = engine.createTexture2D(footprint, mipCount, mipData.data());
             const uint32_t index    = static_cast<uint32_t>(engine.getTextureIndex(texture));
+            ++importStats.textureCount;
+            importStats.bytesCopied += size;
+            // The data has been copied into the upload buffer, so the MIP chain can be reused
+            // (and the file contents can be released).
+            if (!isView) mipChainPool.release(std::move(imported.mipChain));
             // Add the texture to the library.
             texLib.emplace(texName, std::make_pair(std::move(texture), index));
             return index;
@@ -209,13 +509,12 @@ Scene::Scene(const char* path, const char* objFileName, D3D12::Renderer& engine)
             assert(materials[i].metalTexId != UINT32_MAX);
             assert(materials[i].baseTexId  != UINT32_MAX);
             assert(materials[i].roughTexId != UINT32_MAX);
-            // Copy textures to the GPU.
-            engine.executeCopyCommands();
         }
     }
     // Copy materials to the GPU.
     engine.setMaterials(matCount, materials.get());
-    engine.executeCopyCommands();
+    // Submit the remaining uploads without waiting for the batching deadline.
+    engine.flushUploads();
     // Move textures into the array.
     texCount = texLib.size();
     textures.allocate(texCount);
@@ -224,5 +523,12 @@ Scene::Scene(const char* path, const char* objFileName, D3D12::Renderer& engine)
         auto& texture = entry.second;
         textures.assign(i++, std::move(texture.first));
     }
-    printInfo("Scene loaded successfully.");
+    const std::chrono::duration<double> loadTime = std::chrono::steady_clock::now() - startTime;
+    printInfo("Scene loaded successfully in %.2f seconds.", loadTime.count());
+    if (const uint64_t count = importStats.textureCount) {
+        printInfo("Imported %llu textures: %.2f allocations and %.2f MiB copied per texture.",
+                  static_cast<unsigned long long>(count),
+                  static_cast<double>(importStats.allocationCount) / count,
+                  static_cast<double>(importStats.bytesCopied) / (count * 1024 * 1024));
+    }
 }
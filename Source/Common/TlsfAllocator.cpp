@@ -0,0 +1,251 @@
+#include <algorithm>
+#include <cassert>
+#include <intrin.h>
+#include "TlsfAllocator.h"
+
+// Returns the index of the most significant set bit.
+static inline auto findMsb(const uint64_t value)
+-> uint32_t {
+    assert(value != 0);
+    unsigned long bit;
+    _BitScanReverse64(&bit, value);
+    return bit;
+}
+
+// Returns the index of the least significant set bit.
+static inline auto findLsb(const uint64_t value)
+-> uint32_t {
+    assert(value != 0);
+    unsigned long bit;
+    _BitScanForward64(&bit, value);
+    return bit;
+}
+
+float TlsfStats::fragmentation() const {
+    const uint64_t freeSize = capacity - usedSize;
+    if (0 == freeSize) return 0.f;
+    return 1.f - static_cast<float>(largestFreeBlock) / static_cast<float>(freeSize);
+}
+
+TlsfAllocator::TlsfAllocator()
+    : TlsfAllocator{0, 1} {}
+
+TlsfAllocator::TlsfAllocator(const uint64_t capacity, const uint64_t granularity)
+    : m_blocks{}
+    , m_unusedBlock{NIL}
+    , m_flBitmap{0}
+    , m_capacity{capacity / granularity}
+    , m_usedSize{0}
+    , m_granularityLog2{findMsb(granularity)}
+    , m_allocationCount{0}
+    , m_freeBlockCount{0} {
+    assert(0 == (granularity & (granularity - 1)));
+    assert(0 == (capacity & (granularity - 1)));
+    std::fill_n(m_slBitmaps, FL_COUNT, 0);
+    std::fill_n(&m_freeLists[0][0], FL_COUNT * SL_COUNT, NIL);
+    if (m_capacity > 0) {
+        // The entire address space is a single free block.
+        insertFreeBlock(createBlock(0, m_capacity));
+    }
+}
+
+void TlsfAllocator::mapSizeToList(const uint64_t size, uint32_t& fl, uint32_t& sl) {
+    if (size < SL_COUNT) {
+        // Small blocks are segregated linearly.
+        fl = 0;
+        sl = static_cast<uint32_t>(size);
+    } else {
+        const uint32_t msb = findMsb(size);
+        fl = msb - SL_LOG2 + 1;
+        sl = static_cast<uint32_t>(size >> (msb - SL_LOG2)) - SL_COUNT;
+    }
+}
+
+uint32_t TlsfAllocator::takeFreeBlock(const uint64_t size) {
+    // Round the size up to the next list, so that any block of the list is large enough.
+    uint64_t roundedSize = size;
+    if (size >= SL_COUNT) {
+        roundedSize += (uint64_t{1} << (findMsb(size) - SL_LOG2)) - 1;
+    }
+    uint32_t fl, sl;
+    mapSizeToList(roundedSize, fl, sl);
+    // Find the first non-empty list of at least the same size.
+    uint32_t slMap = (fl < FL_COUNT) ? m_slBitmaps[fl] & (~0u << sl) : 0;
+    if (0 == slMap && fl + 1 < FL_COUNT) {
+        const uint64_t flMap = m_flBitmap & (~uint64_t{0} << (fl + 1));
+        if (flMap != 0) {
+            fl    = findLsb(flMap);
+            slMap = m_slBitmaps[fl];
+        }
+    }
+    uint32_t index = NIL;
+    if (slMap != 0) {
+        sl    = findLsb(slMap);
+        index = m_freeLists[fl][sl];
+    } else {
+        // The only suitable blocks may belong to the list of the requested size.
+        mapSizeToList(size, fl, sl);
+        for (index = m_freeLists[fl][sl]; index != NIL; index = m_blocks[index].nextFree) {
+            if (m_blocks[index].size >= size) break;
+        }
+    }
+    if (index != NIL) {
+        removeFreeBlock(index);
+    }
+    return index;
+}
+
+uint32_t TlsfAllocator::createBlock(const uint64_t offset, const uint64_t size) {
+    uint32_t index;
+    if (m_unusedBlock != NIL) {
+        index         = m_unusedBlock;
+        m_unusedBlock = m_blocks[index].nextFree;
+    } else {
+        index = static_cast<uint32_t>(m_blocks.size());
+        m_blocks.emplace_back();
+    }
+    m_blocks[index] = Block{offset, size, NIL, NIL, NIL, NIL, false};
+    return index;
+}
+
+void TlsfAllocator::destroyBlock(const uint32_t index) {
+    m_blocks[index].nextFree = m_unusedBlock;
+    m_unusedBlock            = index;
+}
+
+void TlsfAllocator::insertFreeBlock(const uint32_t index) {
+    uint32_t fl, sl;
+    mapSizeToList(m_blocks[index].size, fl, sl);
+    const uint32_t head = m_freeLists[fl][sl];
+    m_blocks[index].isFree   = true;
+    m_blocks[index].prevFree = NIL;
+    m_blocks[index].nextFree = head;
+    if (head != NIL) {
+        m_blocks[head].prevFree = index;
+    }
+    m_freeLists[fl][sl] = index;
+    m_flBitmap      |= uint64_t{1} << fl;
+    m_slBitmaps[fl] |= 1u << sl;
+    ++m_freeBlockCount;
+}
+
+void TlsfAllocator::removeFreeBlock(const uint32_t index) {
+    uint32_t fl, sl;
+    mapSizeToList(m_blocks[index].size, fl, sl);
+    const uint32_t prev = m_blocks[index].prevFree;
+    const uint32_t next = m_blocks[index].nextFree;
+    if (prev != NIL) {
+        m_blocks[prev].nextFree = next;
+    } else {
+        m_freeLists[fl][sl] = next;
+        if (NIL == next) {
+            // The list is now empty.
+            m_slBitmaps[fl] &= ~(1u << sl);
+            if (0 == m_slBitmaps[fl]) {
+                m_flBitmap &= ~(uint64_t{1} << fl);
+            }
+        }
+    }
+    if (next != NIL) {
+        m_blocks[next].prevFree = prev;
+    }
+    m_blocks[index].isFree = false;
+    --m_freeBlockCount;
+}
+
+uint32_t TlsfAllocator::splitBlock(const uint32_t index, const uint64_t size) {
+    assert(size < m_blocks[index].size);
+    const uint64_t offset    = m_blocks[index].offset + size;
+    const uint64_t remainder = m_blocks[index].size   - size;
+    // Note: creating a block may reallocate the storage.
+    const uint32_t split = createBlock(offset, remainder);
+    const uint32_t next  = m_blocks[index].nextPhys;
+    m_blocks[split].prevPhys = index;
+    m_blocks[split].nextPhys = next;
+    if (next != NIL) {
+        m_blocks[next].prevPhys = split;
+    }
+    m_blocks[index].nextPhys = split;
+    m_blocks[index].size     = size;
+    return split;
+}
+
+void TlsfAllocator::mergeWithNext(const uint32_t index) {
+    const uint32_t next  = m_blocks[index].nextPhys;
+    const uint32_t after = m_blocks[next].nextPhys;
+    m_blocks[index].size    += m_blocks[next].size;
+    m_blocks[index].nextPhys = after;
+    if (after != NIL) {
+        m_blocks[after].prevPhys = index;
+    }
+    destroyBlock(next);
+}
+
+bool TlsfAllocator::allocate(const uint64_t size, const uint64_t alignment,
+                             TlsfAllocation& allocation) {
+    assert(size > 0);
+    assert(alignment > 0 && 0 == (alignment & (alignment - 1)));
+    const uint64_t granule = uint64_t{1} << m_granularityLog2;
+    const uint64_t count   = (size + granule - 1) >> m_granularityLog2;
+    const uint64_t align   = std::max(alignment >> m_granularityLog2, uint64_t{1});
+    // Reserve space for the worst-case alignment padding.
+    const uint64_t request = count + align - 1;
+    if (request > m_capacity - m_usedSize) return false;
+    uint32_t index = takeFreeBlock(request);
+    if (NIL == index) return false;
+    // Return the alignment padding to the free lists.
+    const uint64_t offset  = m_blocks[index].offset;
+    const uint64_t padding = ((offset + align - 1) & ~(align - 1)) - offset;
+    if (padding > 0) {
+        const uint32_t aligned = splitBlock(index, padding);
+        insertFreeBlock(index);
+        index = aligned;
+    }
+    // Return the unused tail to the free lists.
+    if (m_blocks[index].size > count) {
+        insertFreeBlock(splitBlock(index, count));
+    }
+    m_usedSize += count;
+    ++m_allocationCount;
+    allocation.offset = m_blocks[index].offset << m_granularityLog2;
+    allocation.size   = count << m_granularityLog2;
+    allocation.block  = index;
+    return true;
+}
+
+void TlsfAllocator::free(const TlsfAllocation& allocation) {
+    uint32_t index = allocation.block;
+    assert(index < m_blocks.size() && !m_blocks[index].isFree);
+    assert(m_blocks[index].offset << m_granularityLog2 == allocation.offset);
+    m_usedSize -= m_blocks[index].size;
+    --m_allocationCount;
+    // Merge with the adjacent free blocks.
+    const uint32_t next = m_blocks[index].nextPhys;
+    if (next != NIL && m_blocks[next].isFree) {
+        removeFreeBlock(next);
+        mergeWithNext(index);
+    }
+    const uint32_t prev = m_blocks[index].prevPhys;
+    if (prev != NIL && m_blocks[prev].isFree) {
+        removeFreeBlock(prev);
+        mergeWithNext(prev);
+        index = prev;
+    }
+    insertFreeBlock(index);
+}
+
+TlsfStats TlsfAllocator::stats() const {
+    uint64_t largest = 0;
+    if (m_flBitmap != 0) {
+        // The largest block belongs to the last non-empty list.
+        const uint32_t fl = findMsb(m_flBitmap);
+        const uint32_t sl = findMsb(m_slBitmaps[fl]);
+        for (uint32_t i = m_freeLists[fl][sl]; i != NIL; i = m_blocks[i].nextFree) {
+            largest = std::max(largest, m_blocks[i].size);
+        }
+    }
+    return TlsfStats{m_capacity        << m_granularityLog2,
+                     m_usedSize        << m_granularityLog2,
+                     largest           << m_granularityLog2,
+                     m_allocationCount, m_freeBlockCount};
+}
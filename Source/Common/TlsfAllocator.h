@@ -0,0 +1,83 @@
+#pragma once
+
+#include <vector>
+#include "Definitions.h"
+
+// Allocated range of the address space.
+struct TlsfAllocation {
+    uint64_t offset;            // Offset from the beginning of the address space
+    uint64_t size;              // Size of the range (in bytes)
+    uint32_t block;             // Index of the block (for internal use)
+};
+
+// Occupancy of the address space.
+struct TlsfStats {
+    uint64_t capacity;          // Size of the address space (in bytes)
+    uint64_t usedSize;          // Number of allocated bytes (including the padding)
+    uint64_t largestFreeBlock;  // Size of the largest free block (in bytes)
+    uint32_t allocationCount;   // Number of live allocations
+    uint32_t freeBlockCount;    // Number of free blocks
+    // Returns the fraction of the free space which is not part of the largest free block.
+    float fragmentation() const;
+};
+
+// Two-Level Segregated Fit allocator of an abstract address space (e.g. a GPU heap).
+// Free blocks are kept in size-segregated lists, and located using 2 levels of bitmaps,
+// so both allocation and deallocation take constant time.
+// Only offsets are managed; all sizes are multiples of the (power of 2) granularity.
+class TlsfAllocator {
+public:
+    RULE_OF_ZERO_MOVE_ONLY(TlsfAllocator);
+    // Ctor; creates an empty allocator with no capacity.
+    TlsfAllocator();
+    // Ctor; takes the size of the address space and the allocation granularity (in bytes).
+    explicit TlsfAllocator(const uint64_t capacity, const uint64_t granularity);
+    // Allocates 'size' bytes aligned to 'alignment' (a power of 2).
+    // Returns 'false' if there is no sufficiently large free block.
+    bool allocate(const uint64_t size, const uint64_t alignment, TlsfAllocation& allocation);
+    // Frees the allocation, and merges it with the adjacent free blocks.
+    void free(const TlsfAllocation& allocation);
+    // Returns the occupancy statistics.
+    TlsfStats stats() const;
+private:
+    static constexpr uint32_t SL_LOG2  = 4;               // Log2 of the number of 2nd level lists
+    static constexpr uint32_t SL_COUNT = 1 << SL_LOG2;    // Number of 2nd level lists
+    static constexpr uint32_t FL_COUNT = 65 - SL_LOG2;    // Number of 1st level classes
+    static constexpr uint32_t NIL      = UINT32_MAX;      // Invalid block index
+    struct Block {
+        uint64_t offset;        // In granules
+        uint64_t size;          // In granules
+        uint32_t prevPhys;      // Adjacent block at the lower address
+        uint32_t nextPhys;      // Adjacent block at the higher address
+        uint32_t prevFree;      // Previous block of the same free list
+        uint32_t nextFree;      // Next block of the same free list (or the next unused block)
+        bool     isFree;
+    };
+    // Computes the indices of the free list which contains blocks of the specified size.
+    static void mapSizeToList(const uint64_t size, uint32_t& fl, uint32_t& sl);
+    // Returns a free block of at least 'size' granules (or NIL), and removes it from its list.
+    uint32_t takeFreeBlock(const uint64_t size);
+    // Returns a new block; reuses the storage of unused blocks.
+    uint32_t createBlock(const uint64_t offset, const uint64_t size);
+    // Returns the storage of the block to the pool.
+    void destroyBlock(const uint32_t index);
+    // Inserts the free block into the corresponding free list.
+    void insertFreeBlock(const uint32_t index);
+    // Removes the free block from its free list.
+    void removeFreeBlock(const uint32_t index);
+    // Shrinks the block to 'size' granules. Returns the block containing the remainder.
+    uint32_t splitBlock(const uint32_t index, const uint64_t size);
+    // Merges the block with the next physically adjacent block (which is destroyed).
+    void mergeWithNext(const uint32_t index);
+private:
+    std::vector<Block>        m_blocks;                   // Block storage
+    uint32_t                  m_unusedBlock;              // Head of the list of unused blocks
+    uint64_t                  m_flBitmap;                 // Non-empty 1st level classes
+    uint32_t                  m_slBitmaps[FL_COUNT];      // Non-empty 2nd level lists
+    uint32_t                  m_freeLists[FL_COUNT][SL_COUNT]; // Heads of the free lists
+    uint64_t                  m_capacity;                 // In granules
+    uint64_t                  m_usedSize;                 // In granules
+    uint32_t                  m_granularityLog2;          // Log2 of the size of the granule
+    uint32_t                  m_allocationCount;          // Number of live allocations
+    uint32_t                  m_freeBlockCount;           // Number of free blocks
+};
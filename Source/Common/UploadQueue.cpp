@@ -0,0 +1,213 @@
+#include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "UploadQueue.h"
+
+using Clock = std::chrono::steady_clock;
+
+struct InFlightBatch {
+    uint64_t                            fenceValue;     // Signaled once the copies complete
+    std::vector<std::promise<void>>     promises;       // Completion of the uploads
+};
+
+struct UploadQueue::State {
+    std::mutex                          mutex;
+    std::condition_variable             batchCond;      // Signaled when the batch is due
+    std::condition_variable             inFlightCond;   // Signaled when a batch is submitted
+    CopyBackend                         backend;
+    std::vector<std::promise<void>>     batch;          // Recorded uploads not yet submitted
+    std::vector<InFlightBatch>          inFlight;       // Submitted batches (from the oldest)
+    Clock::time_point                   deadline;       // Submission time of the current batch
+    Clock::duration                     maxDelay;       // Maximal age of a batch
+    uint64_t                            batchSize;      // Size of the current batch
+    uint64_t                            maxBatchSize;   // Size which triggers the submission
+    uint64_t                            batchCount;     // Number of submitted batches
+    bool                                isRunning;      // Cleared to shut down the threads
+    std::thread                         submitThread;   // Submits batches
+    std::thread                         completeThread; // Waits for the submitted batches
+    // Returns 'true' if the current batch should be submitted without waiting further.
+    bool isBatchDue() const;
+    // Submits the current batch. The caller must hold the lock.
+    void submitBatch();
+    // Fulfills the promises of the batches completed so far. The caller must hold the lock.
+    void completeBatches();
+    // Submits batches until the queue is destroyed.
+    void processBatches();
+    // Tracks the completion of the submitted batches until the queue is destroyed.
+    // Waiting for the fence on a separate thread keeps the batches due (by size or by
+    // deadline) from being held back by the copies in flight.
+    void processCompletions();
+};
+
+bool UploadQueue::State::isBatchDue() const {
+    return !batch.empty() && (batchSize >= maxBatchSize || !isRunning);
+}
+
+void UploadQueue::State::submitBatch() {
+    assert(!batch.empty());
+    const uint64_t fenceValue = backend.submit();
+    assert(inFlight.empty() || inFlight.back().fenceValue <= fenceValue);
+    inFlight.push_back(InFlightBatch{fenceValue, std::move(batch)});
+    batch.clear();
+    batchSize = 0;
+    ++batchCount;
+    inFlightCond.notify_one();
+}
+
+void UploadQueue::State::completeBatches() {
+    const uint64_t completedFenceValue = backend.completedFenceValue();
+    size_t count = 0;
+    while (count < inFlight.size() && inFlight[count].fenceValue <= completedFenceValue) {
+        for (auto& promise : inFlight[count++].promises) {
+            promise.set_value();
+        }
+    }
+    inFlight.erase(inFlight.begin(), inFlight.begin() + count);
+}
+
+void UploadQueue::State::processBatches() {
+    std::unique_lock<std::mutex> lock{mutex};
+    while (true) {
+        if (isBatchDue() || (!batch.empty() && Clock::now() >= deadline)) {
+            submitBatch();
+        }
+        if (!batch.empty()) {
+            // Wait for the batch to fill up (or for its deadline), unless it is flushed.
+            batchCond.wait_until(lock, deadline, [this]() {
+                return batch.empty() || isBatchDue();
+            });
+        } else if (isRunning) {
+            // Wait for a new batch.
+            batchCond.wait(lock, [this]() {
+                return !batch.empty() || !isRunning;
+            });
+        } else {
+            // All batches are submitted.
+            return;
+        }
+    }
+}
+
+void UploadQueue::State::processCompletions() {
+    std::unique_lock<std::mutex> lock{mutex};
+    while (true) {
+        if (!inFlight.empty()) {
+            // Wait for the oldest batch to complete. Allow recording in the meantime.
+            const uint64_t fenceValue = inFlight.front().fenceValue;
+            lock.unlock();
+            backend.wait(fenceValue);
+            lock.lock();
+            completeBatches();
+        } else if (isRunning || !batch.empty()) {
+            // Wait for a batch to be submitted (possibly the last one, during the shutdown).
+            inFlightCond.wait(lock, [this]() {
+                return !inFlight.empty() || (!isRunning && batch.empty());
+            });
+        } else {
+            // All uploads are complete.
+            return;
+        }
+    }
+}
+
+UploadQueue::UploadQueue() = default;
+
+UploadQueue::UploadQueue(CopyBackend backend, const uint64_t maxBatchSize,
+                         const uint64_t maxDelay)
+    : m_state{std::make_unique<State>()} {
+    assert(backend.submit && backend.completedFenceValue && backend.wait);
+    m_state->backend        = std::move(backend);
+    m_state->maxDelay       = std::chrono::duration_cast<Clock::duration>(
+                                  std::chrono::microseconds{maxDelay});
+    m_state->batchSize      = 0;
+    m_state->maxBatchSize   = maxBatchSize;
+    m_state->batchCount     = 0;
+    m_state->isRunning      = true;
+    m_state->submitThread   = std::thread{&State::processBatches, m_state.get()};
+    m_state->completeThread = std::thread{&State::processCompletions, m_state.get()};
+}
+
+UploadQueue::UploadQueue(UploadQueue&& other) noexcept = default;
+
+UploadQueue& UploadQueue::operator=(UploadQueue&& other) noexcept {
+    if (this != &other) {
+        // Complete the current uploads, and shut down the threads.
+        UploadQueue prev{std::move(*this)};
+        m_state = std::move(other.m_state);
+    }
+    return *this;
+}
+
+UploadQueue::~UploadQueue() noexcept {
+    // Check if it was moved.
+    if (m_state) {
+        // Submit the last batch, and wait for all uploads to complete.
+        {
+            std::lock_guard<std::mutex> lock{m_state->mutex};
+            m_state->isRunning = false;
+        }
+        m_state->batchCond.notify_one();
+        m_state->inFlightCond.notify_one();
+        m_state->submitThread.join();
+        m_state->completeThread.join();
+        m_state.reset();
+    }
+}
+
+std::future<void> UploadQueue::upload(const Recorder& recorder) {
+    assert(m_state);
+    std::future<void> future;
+    bool isDue;
+    {
+        std::lock_guard<std::mutex> lock{m_state->mutex};
+        const uint64_t size = recorder();
+        if (m_state->batch.empty()) {
+            m_state->deadline = Clock::now() + m_state->maxDelay;
+        }
+        m_state->batch.emplace_back();
+        future = m_state->batch.back().get_future();
+        m_state->batchSize += size;
+        // Wake up the thread to start tracking the deadline, or to submit the full batch.
+        isDue = 1 == m_state->batch.size() || m_state->isBatchDue();
+    }
+    if (isDue) {
+        m_state->batchCond.notify_one();
+    }
+    return future;
+}
+
+std::future<void> UploadQueue::flush() {
+    assert(m_state);
+    std::promise<void> promise;
+    std::future<void>  future = promise.get_future();
+    {
+        std::lock_guard<std::mutex> lock{m_state->mutex};
+        if (!m_state->batch.empty()) {
+            // Submit the current batch on this thread, so that the copies are queued
+            // by the time the function returns.
+            m_state->submitBatch();
+        }
+        if (!m_state->inFlight.empty()) {
+            // Complete along with the most recently submitted batch.
+            m_state->inFlight.back().promises.push_back(std::move(promise));
+        } else {
+            // Nothing to wait for.
+            promise.set_value();
+        }
+    }
+    m_state->batchCond.notify_one();
+    return future;
+}
+
+void UploadQueue::wait() {
+    flush().wait();
+}
+
+uint64_t UploadQueue::batchCount() const {
+    assert(m_state);
+    std::lock_guard<std::mutex> lock{m_state->mutex};
+    return m_state->batchCount;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <functional>
+#include <future>
+#include <memory>
+#include "Definitions.h"
+
+// Copy engine driven by the upload queue (e.g. a copy command list and its command queue).
+// Replacing the functions with a mock allows the queue to be used without a GPU.
+struct CopyBackend {
+    // Submits the recorded copy commands for execution, and prepares for recording new ones.
+    // Returns the fence value signaled once the copies complete. Invoked while holding
+    // the lock of the queue, so no copy commands are being recorded at the same time.
+    std::function<uint64_t()>               submit;
+    // Returns the fence value reached so far.
+    std::function<uint64_t()>               completedFenceValue;
+    // Blocks the thread until the fence reaches the value. Invoked without holding the lock,
+    // and only by the completion thread of the queue.
+    std::function<void(const uint64_t)>     wait;
+};
+
+// Batches uploads into copy command lists, and submits them on a dedicated thread.
+// The completion of the submitted batches is tracked by another thread.
+// A batch is submitted once its size reaches the limit, its oldest upload has waited
+// for the maximal delay, or it is flushed. Each upload returns a future which becomes
+// ready once the copy fence passes the batch containing the upload.
+// All member functions are thread-safe.
+class UploadQueue {
+public:
+    // Records the copy commands of an upload, and returns the size of the data (in bytes).
+    // Invoked while holding the lock of the queue.
+    using Recorder = std::function<uint64_t()>;
+    RULE_OF_FIVE_MOVE_ONLY(UploadQueue);
+    // Ctor; creates a queue without a backend (and a thread), which cannot be used.
+    UploadQueue();
+    // Ctor; takes the copy backend, the maximal size of a batch (in bytes), and the maximal
+    // delay (in microseconds) between recording an upload and submitting its batch.
+    explicit UploadQueue(CopyBackend backend, const uint64_t maxBatchSize,
+                         const uint64_t maxDelay);
+    // Records the copy commands of an upload, and adds it to the current batch.
+    // The source data can be released once the function returns.
+    // Returns the future which becomes ready once the copy is complete.
+    std::future<void> upload(const Recorder& recorder);
+    // Submits the current batch (on the calling thread) without waiting for its deadline.
+    // Returns the future which becomes ready once all recorded uploads are complete.
+    std::future<void> flush();
+    // Submits the current batch, and blocks the thread until all recorded uploads are complete.
+    void wait();
+    // Returns the number of submitted batches.
+    uint64_t batchCount() const;
+private:
+    struct State;
+    std::unique_ptr<State> m_state;
+};
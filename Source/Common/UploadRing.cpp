@@ -0,0 +1,79 @@
+#include <cassert>
+#include <cinttypes>
+#include "UploadRing.h"
+#include "Utility.h"
+
+UploadRing::UploadRing()
+    : UploadRing{0} {}
+
+UploadRing::UploadRing(const uint64_t capacity)
+    : m_mutex{std::make_unique<std::mutex>()}
+    , m_segments{}
+    , m_capacity{capacity}
+    , m_begin{0}
+    , m_segStart{0}
+    , m_end{0}
+    , m_stallCount{0} {}
+
+uint64_t UploadRing::capacity() const {
+    return m_capacity;
+}
+
+bool UploadRing::reserve(const uint64_t size, const uint64_t alignment,
+                         uint64_t& offset, uint64_t& waitFenceValue) {
+    assert(size > 0);
+    assert(alignment > 0 && 0 == (alignment & (alignment - 1)));
+    assert(0 == m_capacity % alignment);
+    if (size > m_capacity) {
+        printError("Insufficient upload buffer capacity: current: %" PRIu64
+                   ", required: %" PRIu64 ".", m_capacity, size);
+        TERMINATE();
+    }
+    std::lock_guard<std::mutex> lock{*m_mutex};
+    uint64_t start = (m_end + alignment - 1) & ~(alignment - 1);
+    // The chunk must not straddle the end of the buffer.
+    if (start % m_capacity + size > m_capacity) {
+        // Wrap around.
+        start = (start / m_capacity + 1) * m_capacity;
+    }
+    if (m_begin == m_end) {
+        // The buffer is empty, so the padding does not have to be reclaimed.
+        m_begin = m_segStart = start;
+    }
+    if (start + size - m_begin > m_capacity) {
+        ++m_stallCount;
+        waitFenceValue = m_segments.empty() ? 0 : m_segments.front().fenceValue;
+        return false;
+    }
+    m_end  = start + size;
+    offset = start % m_capacity;
+    return true;
+}
+
+void UploadRing::closeSegment(const uint64_t fenceValue) {
+    std::lock_guard<std::mutex> lock{*m_mutex};
+    assert(m_segments.empty() || m_segments.back().fenceValue <= fenceValue);
+    if (m_segStart == m_end) return;
+    m_segments.push_back(Segment{m_end, fenceValue});
+    m_segStart = m_end;
+}
+
+void UploadRing::reclaim(const uint64_t completedFenceValue) {
+    std::lock_guard<std::mutex> lock{*m_mutex};
+    // Only a few segments are in flight at any time, so the queue is kept in a vector.
+    size_t count = 0;
+    while (count < m_segments.size() && m_segments[count].fenceValue <= completedFenceValue) {
+        m_begin = m_segments[count++].end;
+    }
+    m_segments.erase(m_segments.begin(), m_segments.begin() + count);
+}
+
+uint64_t UploadRing::usedSize() const {
+    std::lock_guard<std::mutex> lock{*m_mutex};
+    return m_end - m_begin;
+}
+
+uint64_t UploadRing::stallCount() const {
+    std::lock_guard<std::mutex> lock{*m_mutex};
+    return m_stallCount;
+}
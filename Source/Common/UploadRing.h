@@ -0,0 +1,54 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "Definitions.h"
+
+// Ring allocator of a linear (upload) buffer with fence-based reclamation.
+// Reservations are grouped into segments. A segment is closed with the fence value
+// signaled after the commands which consume its contents, and its space is reclaimed
+// once the fence reaches that value. Any number of segments can be in flight.
+// Only offsets are managed, so the allocator does not depend on the graphics API.
+// All member functions are thread-safe.
+class UploadRing {
+public:
+    RULE_OF_ZERO_MOVE_ONLY(UploadRing);
+    // Ctor; creates an empty allocator with no capacity.
+    UploadRing();
+    // Ctor; takes the capacity of the buffer (in bytes).
+    explicit UploadRing(const uint64_t capacity);
+    // Returns the capacity of the buffer (in bytes).
+    uint64_t capacity() const;
+    // Reserves a contiguous chunk of 'size' bytes aligned to 'alignment' within the current
+    // segment. The alignment must be a power of 2 which divides the capacity.
+    // On success, returns 'true' and the offset to the beginning of the chunk.
+    // Otherwise, counts a stall, and returns 'false' and the fence value which has to be
+    // reached before more space can be reclaimed (or 0 if there are no closed segments,
+    // in which case the current segment has to be closed first).
+    bool reserve(const uint64_t size, const uint64_t alignment,
+                 uint64_t& offset, uint64_t& waitFenceValue);
+    // Closes the current segment, and begins a new one. The closed segment
+    // is reclaimed once the fence reaches 'fenceValue'. Empty segments are ignored.
+    // Fence values must increase monotonically.
+    void closeSegment(const uint64_t fenceValue);
+    // Reclaims the space of all closed segments with fence values up to 'completedFenceValue'.
+    void reclaim(const uint64_t completedFenceValue);
+    // Returns the number of bytes in use (including the alignment and the wrap-around padding).
+    uint64_t usedSize() const;
+    // Returns the number of reservations which have failed due to the lack of space.
+    uint64_t stallCount() const;
+private:
+    struct Segment {
+        uint64_t                    end;          // Position past the end of the segment
+        uint64_t                    fenceValue;   // Fence value which marks the completion
+    };
+    // Positions increase monotonically; offset = position % capacity.
+    std::unique_ptr<std::mutex>     m_mutex;
+    std::vector<Segment>            m_segments;   // Closed segments (from the oldest)
+    uint64_t                        m_capacity;   // Buffer size (in bytes)
+    uint64_t                        m_begin;      // Position of the oldest byte in use
+    uint64_t                        m_segStart;   // Position of the current segment
+    uint64_t                        m_end;        // Position past the last reserved byte
+    uint64_t                        m_stallCount; // Number of failed reservations
+};
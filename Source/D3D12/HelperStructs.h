@@ -4,8 +4,12 @@
 #include <dxgi1_4.h>
 #include <memory>
 #include <utility>
+#include <vector>
 #include <wrl\client.h>
 #include "..\Common\Definitions.h"
+#include "..\Common\DescriptorAllocator.h"
+#include "..\Common\TlsfAllocator.h"
+#include "..\Common\UploadRing.h"
 
 namespace D3D12 {
     using Microsoft::WRL::ComPtr;
@@ -35,23 +39,41 @@ namespace D3D12 {
                                             const D3D12_RESOURCE_STATES after);
     };
 
-	// Segmented ("double buffered") upload ring buffer.
+    // Persistently mapped upload buffer managed by a segmented ring allocator.
     struct UploadRingBuffer {
         RULE_OF_FIVE_MOVE_ONLY(UploadRingBuffer);
         UploadRingBuffer();
-        // Returns the amount of unused space (in bytes) in the buffer.
-        // Effectively, computes the distance from 'offset' to 'prevSegStart'
-        // (or 'currSegStart' if the former is invalid) with respect to the wrap-around.
-        size_t remainingCapacity() const;
-        // Returns the size (in bytes) of the previous segment of the buffer.
-        size_t previousSegmentSize() const;
     public:
         ComPtr<ID3D12Resource>      resource;        // Memory buffer
         byte_t*                     begin;           // CPU virtual memory-mapped address
-        uint32_t                    capacity;        // Buffer size (in bytes)
-        uint32_t                    offset;          // Offset from the beginning of the buffer
-        uint32_t                    prevSegStart;    // Offset to the beginning of the prev. segment
-        uint32_t                    currSegStart;    // Offset to the beginning of the curr. segment
+        UploadRing                  ring;            // Allocator (reclaimed using copy fences)
+    };
+
+    // Range of a heap of the pool reserved for a placed resource.
+    struct HeapAllocation {
+        ID3D12Heap*                 heap;            // Heap containing the range
+        uint32_t                    heapIndex;       // Index of the heap within the pool
+        TlsfAllocation              range;           // Offset and size within the heap
+    };
+
+    // Pool of large heaps suballocated using TLSF allocators.
+    // Heaps are created on demand; larger resources get (a multiple of) the heap size.
+    struct GpuHeapPool {
+        RULE_OF_ZERO_MOVE_ONLY(GpuHeapPool);
+        GpuHeapPool() = default;
+        // Ctor; takes the heap flags (which restrict the types of resources) and the heap size.
+        explicit GpuHeapPool(const D3D12_HEAP_FLAGS flags, const uint64_t heapSize);
+        // Reserves a range which satisfies the allocation requirements of the resource.
+        HeapAllocation allocate(ID3D12Device* device, const D3D12_RESOURCE_ALLOCATION_INFO& info);
+        // Releases the range. The resource placed there must no longer be in use.
+        void free(const HeapAllocation& allocation);
+        // Returns the combined occupancy statistics of all heaps.
+        TlsfStats stats() const;
+    public:
+        std::vector<ComPtr<ID3D12Heap>> heaps;       // Default heaps
+        std::vector<TlsfAllocator>      allocators;  // Allocators of the heaps
+        D3D12_HEAP_FLAGS                flags    = D3D12_HEAP_FLAG_NONE; // Heap flags
+        uint64_t                        heapSize = 0;                    // Minimal heap size
     };
 
     struct VertexBuffer {
@@ -115,10 +137,16 @@ namespace D3D12 {
     };
 
     // Wrapper for a descriptor heap of capacity N.
+    // Descriptor slots are managed by the allocator; freed slots are recycled using fences.
     template <DescType T, size_t N>
     struct DescriptorPool {
         // Returns the pointer to the underlying descriptor heap.
         ID3D12DescriptorHeap* descriptorHeap();
+        // Allocates a contiguous range of 'count' descriptors. Returns the index of the first one.
+        size_t allocate(const uint32_t count = 1);
+        // Frees the range of descriptors which starts at the 'index' position.
+        // The descriptors are recycled once the fence reaches 'fenceValue'.
+        void free(const size_t index, const uint64_t fenceValue);
         // Returns the CPU handle of the descriptor stored at the 'index' position.
         D3D12_CPU_DESCRIPTOR_HANDLE cpuHandle(const size_t index);
         // Returns the GPU handle of the descriptor stored at the 'index' position.
@@ -128,7 +156,7 @@ namespace D3D12 {
         size_t computeIndex(const D3D12_GPU_DESCRIPTOR_HANDLE handle) const;
     public:
         static constexpr size_t      capacity = N;   // Maximal descriptor count
-        uint32_t                     size;           // Current descriptor count
+        DescriptorAllocator          allocator;      // Descriptor slot allocator
     private:
         uint32_t                     m_handleIncrSz; // Descriptor handle increment size
         D3D12_CPU_DESCRIPTOR_HANDLE  m_cpuBegin;     // CPU handle of the 1st descriptor of the pool
@@ -167,6 +195,12 @@ namespace D3D12 {
         // Stalls the execution of the current thread until
         // the fence with the specified value is reached.
         void syncThread(const uint64_t fenceValue);
+        // Same as syncThread(), but safe to invoke from several threads at the same time.
+        void waitForFence(const uint64_t fenceValue) const;
+        // Returns the value of the fence which will be signaled after the next submission.
+        uint64_t pendingFenceValue() const;
+        // Returns the value of the fence reached by the command queue so far.
+        uint64_t completedFenceValue() const;
         // Stalls the execution of the command queue until
         // the fence with the specified value is reached.
         void syncCommandQueue(ID3D12Fence* fence, const uint64_t fenceValue);
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <algorithm>
 #include <cassert>
+#include <cinttypes>
+#include <d3dx12.h>
 #include "HelperStructs.h"
 #include "..\Common\Utility.h"
 
@@ -116,32 +119,12 @@ namespace D3D12 {
     inline UploadRingBuffer::UploadRingBuffer()
         : resource{nullptr}
         , begin{nullptr}
-        , capacity{0}
-        , offset{0}
-        , prevSegStart{0}
-        , currSegStart{0} {}
-
-    inline auto UploadRingBuffer::remainingCapacity() const
-    -> size_t {
-        const sign_t dist = prevSegStart - offset;
-        // Account for the wrap-around.
-        return (prevSegStart <= offset) ? capacity + dist : dist;
-    }
-
-    inline auto UploadRingBuffer::previousSegmentSize() const
-    -> size_t {
-        const sign_t dist = currSegStart - prevSegStart;
-        // Account for the wrap-around.
-        return (prevSegStart <= currSegStart) ? dist : capacity + dist;
-    }
+        , ring{} {}
 
     inline UploadRingBuffer::UploadRingBuffer(UploadRingBuffer&& other) noexcept
         : resource{std::move(other.resource)}
         , begin{other.begin}
-        , capacity{other.capacity}
-        , offset{other.offset}
-        , prevSegStart{other.prevSegStart}
-        , currSegStart{other.currSegStart} {
+        , ring{std::move(other.ring)} {
         // Mark as moved.
         other.resource = nullptr;
     }
@@ -151,12 +134,9 @@ namespace D3D12 {
             resource->Unmap(0, nullptr);
         }
         // Copy the data.
-        resource     = std::move(other.resource);
-        begin        = other.begin;
-        capacity     = other.capacity;
-        offset       = other.offset;
-        prevSegStart = other.prevSegStart;
-        currSegStart = other.currSegStart;
+        resource = std::move(other.resource);
+        begin    = other.begin;
+        ring     = std::move(other.ring);
         // Mark as moved.
         other.resource = nullptr;
         return *this;
@@ -169,6 +149,66 @@ namespace D3D12 {
         }
     }
 
+    inline GpuHeapPool::GpuHeapPool(const D3D12_HEAP_FLAGS flags, const uint64_t heapSize)
+        : heaps{}
+        , allocators{}
+        , flags{flags}
+        , heapSize{heapSize} {
+        assert(0 == heapSize % D3D12_DEFAULT_MSAA_RESOURCE_PLACEMENT_ALIGNMENT);
+    }
+
+    inline auto GpuHeapPool::allocate(ID3D12Device* device,
+                                      const D3D12_RESOURCE_ALLOCATION_INFO& info)
+    -> HeapAllocation {
+        HeapAllocation allocation;
+        // Try to suballocate from the existing heaps.
+        for (size_t i = 0, n = heaps.size(); i < n; ++i) {
+            if (allocators[i].allocate(info.SizeInBytes, info.Alignment, allocation.range)) {
+                allocation.heap      = heaps[i].Get();
+                allocation.heapIndex = static_cast<uint32_t>(i);
+                return allocation;
+            }
+        }
+        // Create a new heap. Use the MSAA alignment, so that any resource can be placed there.
+        // The allocator reserves space for the worst-case alignment padding.
+        const uint64_t padding = info.Alignment - std::min<uint64_t>(info.Alignment,
+                                 D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT);
+        const uint64_t size    = (info.SizeInBytes + padding + heapSize - 1) / heapSize * heapSize;
+        const CD3DX12_HEAP_DESC heapDesc{size, D3D12_HEAP_TYPE_DEFAULT,
+                                         D3D12_DEFAULT_MSAA_RESOURCE_PLACEMENT_ALIGNMENT, flags};
+        ComPtr<ID3D12Heap> heap;
+        CHECK_CALL(device->CreateHeap(&heapDesc, IID_PPV_ARGS(&heap)),
+                   "Failed to create a heap.");
+        heaps.push_back(std::move(heap));
+        allocators.emplace_back(size, D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT);
+        if (!allocators.back().allocate(info.SizeInBytes, info.Alignment, allocation.range)) {
+            printError("Failed to place a resource of size %" PRIu64 " within a new heap.",
+                       info.SizeInBytes);
+            TERMINATE();
+        }
+        allocation.heap      = heaps.back().Get();
+        allocation.heapIndex = static_cast<uint32_t>(heaps.size() - 1);
+        return allocation;
+    }
+
+    inline void GpuHeapPool::free(const HeapAllocation& allocation) {
+        allocators[allocation.heapIndex].free(allocation.range);
+    }
+
+    inline auto GpuHeapPool::stats() const
+    -> TlsfStats {
+        TlsfStats total = {};
+        for (const TlsfAllocator& allocator : allocators) {
+            const TlsfStats stats   = allocator.stats();
+            total.capacity         += stats.capacity;
+            total.usedSize         += stats.usedSize;
+            total.largestFreeBlock  = std::max(total.largestFreeBlock, stats.largestFreeBlock);
+            total.allocationCount  += stats.allocationCount;
+            total.freeBlockCount   += stats.freeBlockCount;
+        }
+        return total;
+    }
+
     template<typename T>
     inline void ResourceViewSoA<T>::allocate(const size_t count) {
         assert(!resources && !views);
@@ -194,6 +234,17 @@ namespace D3D12 {
         return m_heap.Get();
     }
 
+    template<DescType T, size_t N>
+    inline auto DescriptorPool<T, N>::allocate(const uint32_t count)
+    -> size_t {
+        return allocator.allocate(count).index;
+    }
+
+    template<DescType T, size_t N>
+    inline void DescriptorPool<T, N>::free(const size_t index, const uint64_t fenceValue) {
+        allocator.free(allocator.range(static_cast<uint32_t>(index)), fenceValue);
+    }
+
     template<DescType T, size_t N>
     inline auto DescriptorPool<T, N>::cpuHandle(const size_t index)
     -> D3D12_CPU_DESCRIPTOR_HANDLE {
@@ -272,6 +323,27 @@ namespace D3D12 {
         }
     }
 
+    template<CmdType T, size_t N, size_t L>
+    inline void CommandContext<T, N, L>::waitForFence(const uint64_t fenceValue) const {
+        if (m_fence->GetCompletedValue() < fenceValue) {
+            // Without an event, the call blocks the thread until the fence is reached.
+            CHECK_CALL(m_fence->SetEventOnCompletion(fenceValue, nullptr),
+                       "Failed to wait for the fence.");
+        }
+    }
+
+    template<CmdType T, size_t N, size_t L>
+    inline auto CommandContext<T, N, L>::pendingFenceValue() const
+    -> uint64_t {
+        return m_fenceValue + 1;
+    }
+
+    template<CmdType T, size_t N, size_t L>
+    inline auto CommandContext<T, N, L>::completedFenceValue() const
+    -> uint64_t {
+        return m_fence->GetCompletedValue();
+    }
+
     template<CmdType T, size_t N, size_t L>
     inline void CommandContext<T, N, L>::syncCommandQueue(ID3D12Fence* fence,
                                                           const uint64_t fenceValue) {
@@ -437,7 +509,7 @@ namespace D3D12 {
         CHECK_CALL(CreateDescriptorHeap(&heapDesc, IID_PPV_ARGS(&descriptorPool->m_heap)),
                    "Failed to create a descriptor heap.");
         // Query and store the heap properties.
-        descriptorPool->size = 0;
+        descriptorPool->allocator = DescriptorAllocator{N};
         descriptorPool->m_cpuBegin = descriptorPool->m_heap->GetCPUDescriptorHandleForHeapStart();
         descriptorPool->m_gpuBegin = descriptorPool->m_heap->GetGPUDescriptorHandleForHeapStart();
         descriptorPool->m_handleIncrSz = GetDescriptorHandleIncrementSize(heapType);
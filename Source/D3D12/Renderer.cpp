@@ -1,10 +1,11 @@
 #include <algorithm>
+#include <cinttypes>
 #include <d3dcompiler.h>
 #include <d3dx12.h>
 #include <tuple>
 #include "Renderer.hpp"
-#include "..\Common\Buffer.h"
 #include "..\Common\Camera.h"
+#include "..\Common\FileView.h"
 #include "..\Common\Math.h"
 #include "..\Common\Resources.hpp"
 #include "..\Common\Scene.h"
@@ -58,6 +59,8 @@ static inline auto createHardwareDevice(IDXGIFactory4* factory)
             printInfo("- Dedicated VRAM: %zu MiB", adapterDesc.DedicatedVideoMemory / 1048576);
             printInfo("- Dedicated RAM:  %zu MiB", adapterDesc.DedicatedSystemMemory / 1048576);
             printInfo("- Shared RAM:     %zu MiB", adapterDesc.SharedSystemMemory / 1048576);
+            // Use the amount of dedicated video memory as the GPU memory budget.
+            MemoryStats::setBudget(MemHeap::GPU, adapterDesc.DedicatedVideoMemory);
             return device;
         }
     }
@@ -119,6 +122,12 @@ Renderer::Renderer()
     m_device->createDescriptorPool(&m_rtvPool);
     m_device->createDescriptorPool(&m_dsvPool);
     m_device->createDescriptorPool(&m_texPool);
+    // Create heap pools. Buffers and textures cannot share heaps on all hardware.
+    // Buffers live as long as the renderer, so the buffer heaps are intentionally monotonic:
+    // their ranges are never returned to the pool. Only textures are streamed in and out.
+    m_bufferHeaps  = GpuHeapPool{D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS, GPU_HEAP_SIZE};
+    m_textureHeaps = GpuHeapPool{D3D12_HEAP_FLAG_ALLOW_ONLY_NON_RT_DS_TEXTURES, GPU_HEAP_SIZE};
+    m_texAllocations.resize(TEX_CNT);
     // Create a buffer swap chain.
     {
         // Fill out the swap chain description.
@@ -159,7 +168,7 @@ Renderer::Renderer()
         CHECK_CALL(m_swapChain->GetBuffer(i, IID_PPV_ARGS(&m_swapChainBuffers[i])),
                    "Failed to acquire a swap chain buffer.");
         m_device->CreateRenderTargetView(m_swapChainBuffers[i].Get(), &rtvDesc,
-                                         m_rtvPool.cpuHandle(m_rtvPool.size++));
+                                         m_rtvPool.cpuHandle(m_rtvPool.allocate()));
     }
     // Configure render passes.
     configureGBufferPass();
@@ -170,8 +179,8 @@ Renderer::Renderer()
     m_graphicsContext.resetCommandList(1, m_shadingPass.pipelineState.Get());
     // Create the G-buffer resources.
     {
-        assert(m_dsvPool.size == 0);
-        assert(m_rtvPool.size == BUF_CNT);
+        assert(m_dsvPool.allocator.size() == 0);
+        assert(m_rtvPool.allocator.size() == BUF_CNT);
         // Create a depth buffer.
         m_gBuffer.depthBuffer   = createDepthBuffer(width, height, FORMAT_DSV);
         // Create a normal vector buffer.
@@ -185,16 +194,17 @@ Renderer::Renderer()
     }
     // Create a persistently mapped buffer on the upload heap.
     {
-        m_uploadBuffer.capacity   = UPLOAD_BUF_SIZE;
+        m_uploadBuffer.ring       = UploadRing{UPLOAD_BUF_SIZE};
         // Allocate the buffer on the upload heap.
         const auto heapProperties = CD3DX12_HEAP_PROPERTIES{D3D12_HEAP_TYPE_UPLOAD};
-        const auto resourceDesc   = CD3DX12_RESOURCE_DESC::Buffer(m_uploadBuffer.capacity);
+        const auto resourceDesc   = CD3DX12_RESOURCE_DESC::Buffer(UPLOAD_BUF_SIZE);
         // Upload heaps require the initial resource state to be set to 'GENERIC_READ'.
         CHECK_CALL(m_device->CreateCommittedResource(&heapProperties, D3D12_HEAP_FLAG_NONE, 
                                                      &resourceDesc,
                                                      D3D12_RESOURCE_STATE_GENERIC_READ, nullptr,
                                                      IID_PPV_ARGS(&m_uploadBuffer.resource)),
                    "Failed to allocate an upload buffer.");
+        recordGpuAllocation(resourceDesc, MemTag::UPLOAD_BUFFER);
         // Note: we don't intend to read from this resource on the CPU.
         constexpr D3D12_RANGE emptyReadRange = {0, 0};
         // Map the buffer to a range in the CPU virtual address space.
@@ -202,6 +212,15 @@ Renderer::Renderer()
                                                 reinterpret_cast<void**>(&m_uploadBuffer.begin)),
                    "Failed to map the upload buffer.");
     }
+    // Start batching the uploads on a dedicated thread.
+    const CopyBackend copyBackend = {
+        /* submit */              [this]() { return submitCopyCommands(); },
+        /* completedFenceValue */ [this]() { return m_copyContext.completedFenceValue(); },
+        /* wait */                [this](const uint64_t fenceValue) {
+                                      m_copyContext.waitForFence(fenceValue);
+                                  }
+    };
+    m_uploadQueue = UploadQueue{copyBackend, UPLOAD_BATCH_SIZE, UPLOAD_BATCH_DELAY};
     // Create a buffer for material indices.
     m_materialBuffer = createStructuredBuffer(MAT_CNT * sizeof(Material));
 }
@@ -210,12 +229,12 @@ void D3D12::Renderer::configureGBufferPass() {
     auto& rootSignature = m_gBufferPass.rootSignature;
     auto& pipelineState = m_gBufferPass.pipelineState;
     // Import the bytecode of the graphics root signature and the shaders.
-    const Buffer rsByteCode{"Shaders\\GBufferRS.cso"};
-    const Buffer vsByteCode("Shaders\\GBufferVS.cso");
-    const Buffer psByteCode("Shaders\\GBufferPS.cso");
+    const FileView rsByteCode{"Shaders\\GBufferRS.cso"};
+    const FileView vsByteCode("Shaders\\GBufferVS.cso");
+    const FileView psByteCode("Shaders\\GBufferPS.cso");
     // Create a graphics root signature.
     CHECK_CALL(m_device->CreateRootSignature(m_device->nodeMask,
-                                             rsByteCode.data(), rsByteCode.size,
+                                             rsByteCode.data(), rsByteCode.size(),
                                              IID_PPV_ARGS(&rootSignature)),
                "Failed to create a graphics root signature.");
     // Configure the rasterizer state.
@@ -287,8 +306,8 @@ void D3D12::Renderer::configureGBufferPass() {
     // Fill out the pipeline state object description.
     const D3D12_GRAPHICS_PIPELINE_STATE_DESC pipelineStateDesc = {
         /* pRootSignature */        rootSignature.Get(),
-        /* VS */                    {vsByteCode.data(), vsByteCode.size},
-        /* PS */                    {psByteCode.data(), psByteCode.size},
+        /* VS */                    {vsByteCode.data(), vsByteCode.size()},
+        /* PS */                    {psByteCode.data(), psByteCode.size()},
         /* DS, HS, GS, SO */        {}, {}, {}, {},
         /* BlendState */            CD3DX12_BLEND_DESC{D3D12_DEFAULT},
         /* SampleMask */            UINT32_MAX,
@@ -315,12 +334,12 @@ void Renderer::configureShadingPass() {
     auto& rootSignature = m_shadingPass.rootSignature;
     auto& pipelineState = m_shadingPass.pipelineState;
     // Import the bytecode of the graphics root signature and the shaders.
-    const Buffer rsByteCode{"Shaders\\ShadeRS.cso"};
-    const Buffer vsByteCode("Shaders\\ShadeVS.cso");
-    const Buffer psByteCode("Shaders\\ShadePS.cso");
+    const FileView rsByteCode{"Shaders\\ShadeRS.cso"};
+    const FileView vsByteCode("Shaders\\ShadeVS.cso");
+    const FileView psByteCode("Shaders\\ShadePS.cso");
     // Create a graphics root signature.
     CHECK_CALL(m_device->CreateRootSignature(m_device->nodeMask,
-                                             rsByteCode.data(), rsByteCode.size,
+                                             rsByteCode.data(), rsByteCode.size(),
                                              IID_PPV_ARGS(&rootSignature)),
                "Failed to create a graphics root signature.");
     // Configure the rasterizer state.
@@ -340,8 +359,8 @@ void Renderer::configureShadingPass() {
     // Fill out the pipeline state object description.
     const D3D12_GRAPHICS_PIPELINE_STATE_DESC pipelineStateDesc = {
         /* pRootSignature */        rootSignature.Get(),
-        /* VS */                    {vsByteCode.data(), vsByteCode.size},
-        /* PS */                    {psByteCode.data(), psByteCode.size},
+        /* VS */                    {vsByteCode.data(), vsByteCode.size()},
+        /* PS */                    {psByteCode.data(), psByteCode.size()},
         /* DS, HS, GS, SO */        {}, {}, {}, {},
         /* BlendState */            CD3DX12_BLEND_DESC{D3D12_DEFAULT},
         /* SampleMask */            UINT32_MAX,
@@ -389,6 +408,7 @@ ComPtr<ID3D12Resource> Renderer::createDepthBuffer(const uint32_t width, const u
                                                  &resourceDesc, D3D12_RESOURCE_STATE_DEPTH_WRITE,
                                                  &clearValue, IID_PPV_ARGS(&depthStencilBuffer)),
                "Failed to allocate a depth buffer.");
+    recordGpuAllocation(resourceDesc, MemTag::RENDER_TARGET);
     // Initialize the depth-stencil view.
     const D3D12_DEPTH_STENCIL_VIEW_DESC dsvDesc = {
         /* Format */           format,
@@ -397,11 +417,11 @@ ComPtr<ID3D12Resource> Renderer::createDepthBuffer(const uint32_t width, const u
         /* MipSlice */         0
     };
     m_device->CreateDepthStencilView(depthStencilBuffer.Get(), &dsvDesc,
-                                     m_dsvPool.cpuHandle(m_dsvPool.size++));
+                                     m_dsvPool.cpuHandle(m_dsvPool.allocate()));
     // Initialize the shader resource view.
     const D3D12_TEX2D_SRV_DESC srvDesc{getDepthSrvFormat(format), 1};
     m_device->CreateShaderResourceView(depthStencilBuffer.Get(), &srvDesc,
-                                       m_texPool.cpuHandle(m_texPool.size++));
+                                       m_texPool.cpuHandle(m_texPool.allocate()));
     return depthStencilBuffer;
 }
 
@@ -430,6 +450,7 @@ ComPtr<ID3D12Resource> Renderer::createRenderBuffer(const uint32_t width, const
                                                  &resourceDesc, D3D12_RESOURCE_STATE_RENDER_TARGET,
                                                  &clearValue, IID_PPV_ARGS(&renderBuffer)),
                "Failed to allocate a render target.");
+    recordGpuAllocation(resourceDesc, MemTag::RENDER_TARGET);
     // Initialize the render target view.
     const D3D12_RENDER_TARGET_VIEW_DESC rtvDesc = {
         /* Format */           format,
@@ -438,16 +459,17 @@ ComPtr<ID3D12Resource> Renderer::createRenderBuffer(const uint32_t width, const
         /* PlaneSlice */       0
     };
     m_device->CreateRenderTargetView(renderBuffer.Get(), &rtvDesc,
-                                     m_rtvPool.cpuHandle(m_rtvPool.size++));
+                                     m_rtvPool.cpuHandle(m_rtvPool.allocate()));
     // Initialize the shader resource view.
     const D3D12_TEX2D_SRV_DESC srvDesc{format, 1};
     m_device->CreateShaderResourceView(renderBuffer.Get(), &srvDesc,
-                                       m_texPool.cpuHandle(m_texPool.size++));
+                                       m_texPool.cpuHandle(m_texPool.allocate()));
     return renderBuffer;
 }
 
 Texture Renderer::createTexture2D(const D3D12_SUBRESOURCE_FOOTPRINT& footprint,
-                                  const uint32_t mipCount, const void* data) {
+                                  const uint32_t mipCount,
+                                  const D3D12_SUBRESOURCE_DATA* mipData) {
     const D3D12_RESOURCE_DESC resourceDesc = {
         /* Dimension */        D3D12_RESOURCE_DIMENSION_TEXTURE2D,
         /* Alignment */        0,   // Automatic
@@ -465,96 +487,147 @@ Texture Renderer::createTexture2D(const D3D12_SUBRESOURCE_FOOTPRINT& footprint,
         /* Color */            FLOAT4_ZERO
     };
     Texture texture;
-    // Allocate the texture on the default heap.
-    const auto heapProperties = CD3DX12_HEAP_PROPERTIES{D3D12_HEAP_TYPE_DEFAULT};
-    CHECK_CALL(m_device->CreateCommittedResource(&heapProperties, D3D12_HEAP_FLAG_NONE,
-                                                 &resourceDesc, D3D12_RESOURCE_STATE_COMMON,
-                                                 nullptr, IID_PPV_ARGS(&texture.resource)),
-               "Failed to allocate a texture.");
+    // Allocate the texture within a texture heap.
+    HeapAllocation allocation;
+    texture.resource = createPlacedResource(m_textureHeaps, resourceDesc, MemTag::TEXTURE,
+                                            &allocation);
     // Transition the state of the texture for the graphics/compute command queue type class.
     const D3D12_TRANSITION_BARRIER barrier{texture.resource.Get(),
                                            D3D12_RESOURCE_STATE_COMMON,
                                            D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE};
     m_graphicsContext.commandList(0)->ResourceBarrier(1, &barrier);
-    if (data) {
-        assert(0 == footprint.RowPitch % D3D12_TEXTURE_DATA_PITCH_ALIGNMENT);
-        // Upload MIP levels one by one.
-        for (size_t i = 0; i < mipCount; ++i) {
-            const uint32_t width     = std::max(1u, footprint.Width >> i);
-            const uint32_t height    = std::max(1u, footprint.Height >> i);
-            const size_t   dataPitch = std::max(1u, footprint.RowPitch >> i);
-            const size_t   rowPitch  = align<D3D12_TEXTURE_DATA_PITCH_ALIGNMENT>(dataPitch);
-            const size_t   size      = rowPitch * height;
-            // Linear subresource copying must be aligned to 512 bytes.
-            constexpr size_t alignment = D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT;
-            size_t offset;
-            // Check whether pitched copying is required.
-            if (dataPitch == rowPitch) {
-                // Copy the entire MIP level at once.
-                offset = copyToUploadBuffer<alignment>(size, data);
-                // Advance the data pointer to the next MIP level.
-                data = static_cast<const byte_t*>(data) + size;
-            } else {
-                // Reserve a chunk of memory for the entire MIP level.
-                byte_t* address;
-                std::tie(address, offset) = reserveChunkOfUploadBuffer<alignment>(size);
-                // Copy the MIP level one row at a time.
-                for (size_t row = 0; row < height; ++row) {
-                    memcpy(address, data, dataPitch);
-                    address += rowPitch;
-                    data     = static_cast<const byte_t*>(data) + dataPitch;
+    if (mipData) {
+        m_uploadQueue.upload([&]() {
+            size_t totalSize = 0;
+            // Upload MIP levels one by one.
+            for (size_t i = 0; i < mipCount; ++i) {
+                // Each MIP level has its own address and row pitch (which is not necessarily
+                // a fraction of the pitch of the base level, e.g. for NPOT or padded images).
+                const D3D12_SUBRESOURCE_DATA& levelData = mipData[i];
+                const uint32_t width     = std::max(1u, footprint.Width >> i);
+                const uint32_t height    = std::max(1u, footprint.Height >> i);
+                const size_t   dataPitch = static_cast<size_t>(levelData.RowPitch);
+                const size_t   rowCount  = static_cast<size_t>(levelData.SlicePitch) / dataPitch;
+                const size_t   rowPitch  = align<D3D12_TEXTURE_DATA_PITCH_ALIGNMENT>(dataPitch);
+                const size_t   size      = rowPitch * rowCount;
+                totalSize += size;
+                // Linear subresource copying must be aligned to 512 bytes.
+                constexpr size_t alignment = D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT;
+                size_t offset;
+                // Check whether pitched copying is required.
+                if (dataPitch == rowPitch) {
+                    // Copy the entire MIP level at once.
+                    offset = copyToUploadBuffer<alignment>(size, levelData.pData);
+                } else {
+                    // Reserve a chunk of memory for the entire MIP level.
+                    byte_t* address;
+                    std::tie(address, offset) = reserveChunkOfUploadBuffer<alignment>(size);
+                    // Copy the MIP level one row at a time.
+                    const byte_t* data = static_cast<const byte_t*>(levelData.pData);
+                    for (size_t row = 0; row < rowCount; ++row) {
+                        memcpy(address, data, dataPitch);
+                        address += rowPitch;
+                        data    += dataPitch;
+                    }
                 }
+                // Copy the data from the upload buffer into the video memory texture.
+                const D3D12_PLACED_SUBRESOURCE_FOOTPRINT levelFootprint = {
+                    /* Offset */   offset,
+                    /* Format */   footprint.Format,
+                    /* Width */    width,
+                    /* Height */   height,
+                    /* Depth */    footprint.Depth,
+                    /* RowPitch */ static_cast<uint32_t>(rowPitch)
+                };
+                const uint32_t subResId = static_cast<uint32_t>(i);
+                const CD3DX12_TEXTURE_COPY_LOCATION src{m_uploadBuffer.resource.Get(),
+                                                        levelFootprint};
+                const CD3DX12_TEXTURE_COPY_LOCATION dst{texture.resource.Get(), subResId};
+                m_copyContext.commandList(0)->CopyTextureRegion(&dst, 0, 0, 0, &src, nullptr);
             }
-            // Copy the data from the upload buffer into the video memory texture.
-            const D3D12_PLACED_SUBRESOURCE_FOOTPRINT levelFootprint = {
-                /* Offset */   offset,
-                /* Format */   footprint.Format,
-                /* Width */    width,
-                /* Height */   height,
-                /* Depth */    footprint.Depth,
-                /* RowPitch */ static_cast<uint32_t>(rowPitch)
-            };
-            const uint32_t subResId = static_cast<uint32_t>(i);
-            const CD3DX12_TEXTURE_COPY_LOCATION src{m_uploadBuffer.resource.Get(), levelFootprint};
-            const CD3DX12_TEXTURE_COPY_LOCATION dst{texture.resource.Get(), subResId};
-            m_copyContext.commandList(0)->CopyTextureRegion(&dst, 0, 0, 0, &src, nullptr);
-        }
+            return static_cast<uint64_t>(totalSize);
+        });
     }
     // Initialize the shader resource view.
     const D3D12_TEX2D_SRV_DESC srvDesc{footprint.Format, mipCount};
-    texture.view = m_texPool.gpuHandle(m_texPool.size);
+    const size_t index = m_texPool.allocate();
+    m_texAllocations[index] = allocation;
+    texture.view = m_texPool.gpuHandle(index);
     m_device->CreateShaderResourceView(texture.resource.Get(), &srvDesc,
-                                       m_texPool.cpuHandle(m_texPool.size++));
+                                       m_texPool.cpuHandle(index));
     return texture;
 }
 
+void Renderer::recordGpuAllocation(const D3D12_RESOURCE_DESC& resourceDesc,
+                                   const MemTag tag) const {
+    // Query the actual size of the allocation (including the alignment padding).
+    const D3D12_RESOURCE_ALLOCATION_INFO allocInfo =
+        m_device->GetResourceAllocationInfo(m_device->nodeMask, 1, &resourceDesc);
+    MemoryStats::recordAllocation(MemHeap::GPU, tag, allocInfo.SizeInBytes);
+}
+
+ComPtr<ID3D12Resource> Renderer::createPlacedResource(GpuHeapPool& heapPool,
+                                                      const D3D12_RESOURCE_DESC& resourceDesc,
+                                                      const MemTag tag,
+                                                      HeapAllocation* allocation) {
+    // Query the actual size and the alignment of the allocation.
+    const D3D12_RESOURCE_ALLOCATION_INFO allocInfo =
+        m_device->GetResourceAllocationInfo(m_device->nodeMask, 1, &resourceDesc);
+    const HeapAllocation placement = heapPool.allocate(m_device.Get(), allocInfo);
+    ComPtr<ID3D12Resource> resource;
+    CHECK_CALL(m_device->CreatePlacedResource(placement.heap, placement.range.offset,
+                                              &resourceDesc, D3D12_RESOURCE_STATE_COMMON,
+                                              nullptr, IID_PPV_ARGS(&resource)),
+               "Failed to create a placed resource.");
+    MemoryStats::recordAllocation(MemHeap::GPU, tag, placement.range.size);
+    if (allocation) {
+        *allocation = placement;
+    }
+    return resource;
+}
+
 size_t Renderer::getTextureIndex(const Texture& texture) const {
-    return m_texPool.computeIndex(texture.view);
+    const size_t index = m_texPool.computeIndex(texture.view);
+    assert(m_texPool.allocator.isAllocated(static_cast<uint32_t>(index)));
+    return index;
+}
+
+void Renderer::releaseTexture(Texture&& texture) {
+    // The texture may still be used by the frame being recorded.
+    const uint64_t fenceValue = m_graphicsContext.pendingFenceValue();
+    const size_t   index      = m_texPool.computeIndex(texture.view);
+    m_texPool.free(index, fenceValue);
+    m_pendingReleases.push_back(PendingRelease{std::move(texture.resource),
+                                               m_texAllocations[index], fenceValue});
+}
+
+void Renderer::reclaimResources() {
+    const uint64_t completedValue = m_graphicsContext.completedFenceValue();
+    m_texPool.allocator.reclaim(completedValue);
+    size_t count = 0;
+    while (count < m_pendingReleases.size() &&
+           m_pendingReleases[count].fenceValue <= completedValue) {
+        const HeapAllocation& allocation = m_pendingReleases[count++].allocation;
+        m_textureHeaps.free(allocation);
+        MemoryStats::recordDeallocation(MemHeap::GPU, MemTag::TEXTURE, allocation.range.size);
+    }
+    // Releasing the last references destroys the resources.
+    m_pendingReleases.erase(m_pendingReleases.begin(), m_pendingReleases.begin() + count);
 }
 
 ConstantBuffer Renderer::createConstantBuffer(const size_t size, const void* data) {
     assert(!data || size >= 4);
     ConstantBuffer buffer;
-    // Allocate the buffer on the default heap.
-    const auto heapProperties = CD3DX12_HEAP_PROPERTIES{D3D12_HEAP_TYPE_DEFAULT};
-    const auto resourceDesc   = CD3DX12_RESOURCE_DESC::Buffer(size);
-    CHECK_CALL(m_device->CreateCommittedResource(&heapProperties, D3D12_HEAP_FLAG_NONE,
-                                                 &resourceDesc, D3D12_RESOURCE_STATE_COMMON,
-                                                 nullptr, IID_PPV_ARGS(&buffer.resource)),
-               "Failed to allocate a constant buffer.");
+    // Allocate the buffer within a buffer heap.
+    const auto resourceDesc = CD3DX12_RESOURCE_DESC::Buffer(size);
+    buffer.resource = createPlacedResource(m_bufferHeaps, resourceDesc, MemTag::CONSTANT_BUFFER);
     // Transition the state of the buffer for the graphics/compute command queue type class.
     const D3D12_TRANSITION_BARRIER barrier{buffer.resource.Get(),
                                            D3D12_RESOURCE_STATE_COMMON,
                                            D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER};
     m_graphicsContext.commandList(0)->ResourceBarrier(1, &barrier);
     if (data) {
-        // Linear subresource copying must be aligned to 512 bytes.
-        constexpr size_t alignment = D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT;
-        const     size_t offset    = copyToUploadBuffer<alignment>(size, data);
-        // Copy the data from the upload buffer into the video memory buffer.
-        m_copyContext.commandList(0)->CopyBufferRegion(buffer.resource.Get(), 0,
-                                                       m_uploadBuffer.resource.Get(), offset,
-                                                       size);
+        uploadToBuffer(buffer.resource.Get(), size, data);
     }
     // Initialize the constant buffer view.
     buffer.view = buffer.resource->GetGPUVirtualAddress();
@@ -564,26 +637,16 @@ ConstantBuffer Renderer::createConstantBuffer(const size_t size, const void* dat
 StructuredBuffer Renderer::createStructuredBuffer(const size_t size, const void* data) {
     assert(!data || size >= 4);
     StructuredBuffer buffer;
-    // Allocate the buffer on the default heap.
-    const auto heapProperties = CD3DX12_HEAP_PROPERTIES{D3D12_HEAP_TYPE_DEFAULT};
-    const auto resourceDesc   = CD3DX12_RESOURCE_DESC::Buffer(size);
-    CHECK_CALL(m_device->CreateCommittedResource(&heapProperties, D3D12_HEAP_FLAG_NONE,
-                                                 &resourceDesc, D3D12_RESOURCE_STATE_COMMON,
-                                                 nullptr, IID_PPV_ARGS(&buffer.resource)),
-               "Failed to allocate a structured buffer.");
+    // Allocate the buffer within a buffer heap.
+    const auto resourceDesc = CD3DX12_RESOURCE_DESC::Buffer(size);
+    buffer.resource = createPlacedResource(m_bufferHeaps, resourceDesc, MemTag::CONSTANT_BUFFER);
     // Transition the state of the buffer for the graphics/compute command queue type class.
     const D3D12_TRANSITION_BARRIER barrier{buffer.resource.Get(),
                                            D3D12_RESOURCE_STATE_COMMON,
                                            D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE};
     m_graphicsContext.commandList(0)->ResourceBarrier(1, &barrier);
     if (data) {
-        // Linear subresource copying must be aligned to 512 bytes.
-        constexpr size_t alignment = D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT;
-        const     size_t offset    = copyToUploadBuffer<alignment>(size, data);
-        // Copy the data from the upload buffer into the video memory buffer.
-        m_copyContext.commandList(0)->CopyBufferRegion(buffer.resource.Get(), 0,
-                                                       m_uploadBuffer.resource.Get(), offset,
-                                                       size);
+        uploadToBuffer(buffer.resource.Get(), size, data);
     }
     // Initialize the shader resource view.
     buffer.view = buffer.resource->GetGPUVirtualAddress();
@@ -594,25 +657,15 @@ IndexBuffer Renderer::createIndexBuffer(const size_t count, const uint32_t* indi
     assert(indices && count >= 3);
     const size_t size = count * sizeof(uint32_t);
     IndexBuffer buffer;
-    // Allocate the buffer on the default heap.
-    const auto heapProperties = CD3DX12_HEAP_PROPERTIES{D3D12_HEAP_TYPE_DEFAULT};
-    const auto resourceDesc   = CD3DX12_RESOURCE_DESC::Buffer(size);
-    CHECK_CALL(m_device->CreateCommittedResource(&heapProperties, D3D12_HEAP_FLAG_NONE,
-                                                 &resourceDesc, D3D12_RESOURCE_STATE_COMMON,
-                                                 nullptr, IID_PPV_ARGS(&buffer.resource)),
-               "Failed to allocate an index buffer.");
+    // Allocate the buffer within a buffer heap.
+    const auto resourceDesc = CD3DX12_RESOURCE_DESC::Buffer(size);
+    buffer.resource = createPlacedResource(m_bufferHeaps, resourceDesc, MemTag::INDEX_BUFFER);
     // Transition the state of the buffer for the graphics/compute command queue type class.
     const D3D12_TRANSITION_BARRIER barrier{buffer.resource.Get(),
                                            D3D12_RESOURCE_STATE_COMMON,
                                            D3D12_RESOURCE_STATE_INDEX_BUFFER};
     m_graphicsContext.commandList(0)->ResourceBarrier(1, &barrier);
-    // Linear subresource copying must be aligned to 512 bytes.
-    constexpr size_t alignment = D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT;
-    const     size_t offset    = copyToUploadBuffer<alignment>(size, indices);
-    // Copy the data from the upload buffer into the video memory buffer.
-    m_copyContext.commandList(0)->CopyBufferRegion(buffer.resource.Get(), 0,
-                                                   m_uploadBuffer.resource.Get(), offset,
-                                                   size);
+    uploadToBuffer(buffer.resource.Get(), size, indices);
     // Initialize the index buffer view.
     buffer.view.BufferLocation = buffer.resource->GetGPUVirtualAddress(),
     buffer.view.SizeInBytes    = static_cast<uint32_t>(size);
@@ -622,39 +675,41 @@ IndexBuffer Renderer::createIndexBuffer(const size_t count, const uint32_t* indi
 
 void Renderer::setMaterials(const size_t count, const Material* materials) {
     assert(count <= MAT_CNT);
-    // Linear subresource copying must be aligned to 512 bytes.
-    constexpr size_t alignment = D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT;
-    const     size_t size      = count * sizeof(Material);
-    const     size_t offset    = copyToUploadBuffer<alignment>(size, materials);
-    // Copy the data from the upload buffer into the video memory buffer.
-    m_copyContext.commandList(0)->CopyBufferRegion(m_materialBuffer.resource.Get(), 0,
-                                                   m_uploadBuffer.resource.Get(), offset, size);
+    uploadToBuffer(m_materialBuffer.resource.Get(), count * sizeof(Material), materials);
+}
+
+void Renderer::uploadToBuffer(ID3D12Resource* buffer, const size_t size, const void* data) {
+    m_uploadQueue.upload([=]() {
+        // Linear subresource copying must be aligned to 512 bytes.
+        constexpr size_t alignment = D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT;
+        const     size_t offset    = copyToUploadBuffer<alignment>(size, data);
+        // Copy the data from the upload buffer into the video memory buffer.
+        m_copyContext.commandList(0)->CopyBufferRegion(buffer, 0, m_uploadBuffer.resource.Get(),
+                                                       offset, size);
+        return static_cast<uint64_t>(size);
+    });
+}
+
+std::future<void> Renderer::flushUploads() {
+    return m_uploadQueue.flush();
 }
 
-void D3D12::Renderer::executeCopyCommands(const bool immediateCopy) {
+uint64_t Renderer::submitCopyCommands() {
     // Finalize and execute the command list.
     ID3D12Fence* insertedFence;
     uint64_t     insertedValue;
     std::tie(insertedFence, insertedValue) = m_copyContext.executeCommandList(0);
     // Ensure synchronization between the graphics and the copy command queues.
     m_graphicsContext.syncCommandQueue(insertedFence, insertedValue);
-    if (immediateCopy) {
-        printWarning("Immediate copy requested. Thread stall imminent.");
-        m_copyContext.syncThread(insertedValue);
-    } else {
-        // For single- and double-buffered copy contexts, resetCommandAllocator() will
-        // take care of waiting until the previous copy command list has completed execution.
-        static_assert(decltype(m_copyContext)::bufferCount <= 2,
-                      "Unsupported copy context buffering mode.");
-    }
+    // The current segment of the upload buffer is consumed by the submitted copies.
+    m_uploadBuffer.ring.closeSegment(insertedValue);
     // Reset the command list allocator.
     m_copyContext.resetCommandAllocators();
     // Reset the command list to its initial state.
     m_copyContext.resetCommandList(0, nullptr);
-    // Begin a new segment of the upload buffer.
-    m_uploadBuffer.prevSegStart = immediateCopy ? m_uploadBuffer.offset
-                                                : m_uploadBuffer.currSegStart;
-    m_uploadBuffer.currSegStart = m_uploadBuffer.offset;
+    // Reclaim the segments of the upload buffer consumed by the completed copies.
+    m_uploadBuffer.ring.reclaim(m_copyContext.completedFenceValue());
+    return insertedValue;
 }
 
 void Renderer::GBuffer::setWriteBarriers(D3D12_RESOURCE_BARRIER* barriers,                          
@@ -736,10 +791,12 @@ void Renderer::recordGBufferPass(const PerspectiveCamera& pCam, const Scene& sce
     graphicsCommandList->SetGraphicsRootSignature(m_gBufferPass.rootSignature.Get());
     ID3D12DescriptorHeap* texHeap = m_texPool.descriptorHeap();
     graphicsCommandList->SetDescriptorHeaps(1, &texHeap);
+    PassStats passStats{};
     // Finish the transition of the G-buffer to the writable state.
     D3D12_RESOURCE_BARRIER barriers[5];
     m_gBuffer.setWriteBarriers(barriers, D3D12_RESOURCE_BARRIER_FLAG_END_ONLY);
     graphicsCommandList->ResourceBarrier(5, barriers);
+    passStats.barrierCount += 5;
     // Store columns 0, 1 and 3 of the view-projection matrix.
     const XMMATRIX tViewProj = XMMatrixTranspose(pCam.computeViewProjMatrix());
     XMFLOAT4A matCols[3];
@@ -748,6 +805,7 @@ void Renderer::recordGBufferPass(const PerspectiveCamera& pCam, const Scene& sce
     XMStoreFloat4A(&matCols[2], tViewProj.r[3]);
     // Set the root arguments.
     graphicsCommandList->SetGraphicsRoot32BitConstants(2, 12, matCols, 0);
+    ++passStats.rootConstChanges;
     // Set the RTVs and the DSV.
     const D3D12_CPU_DESCRIPTOR_HANDLE rtvHandles[2] = {
         m_rtvPool.cpuHandle(BUF_CNT),    // First G-buffer RTV    
@@ -767,11 +825,13 @@ void Renderer::recordGBufferPass(const PerspectiveCamera& pCam, const Scene& sce
     graphicsCommandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
     graphicsCommandList->IASetVertexBuffers(0, 3, scene.vertexAttrBuffers.views.get());
     // Issue draw calls.
-    uint16_t matId = UINT16_MAX;
+    uint16_t matId          = UINT16_MAX;
+    uint32_t matSwitchCount = 0;
     for (size_t i = 0; i < visObjCount; ++i) {
         const size_t objId = objSortPairs[i].index;
         if (matId != scene.objects.materialIndices[objId]) {
             matId = scene.objects.materialIndices[objId];
+            ++matSwitchCount;
             // Check whether the material has a valid bump map.
             uint32_t bumpMapFlag = 0;
             const uint32_t texId = scene.materials[matId].bumpTexId;
@@ -779,9 +839,11 @@ void Renderer::recordGBufferPass(const PerspectiveCamera& pCam, const Scene& sce
                 bumpMapFlag = 1u << 31;
                 const D3D12_GPU_DESCRIPTOR_HANDLE texHandle = m_texPool.gpuHandle(texId);
                 graphicsCommandList->SetGraphicsRootDescriptorTable(0, texHandle);
+                ++passStats.descTableChanges;
             }
             // Set the bump map flag and the material index.
             graphicsCommandList->SetGraphicsRoot32BitConstant(1, bumpMapFlag | matId, 0);
+            ++passStats.rootConstChanges;
         }
         // Set the index buffer.
         const D3D12_INDEX_BUFFER_VIEW ibv = scene.objects.indexBuffers.views[objId];
@@ -789,13 +851,24 @@ void Renderer::recordGBufferPass(const PerspectiveCamera& pCam, const Scene& sce
         // Draw the object.
         const uint32_t count = ibv.SizeInBytes / sizeof(uint32_t);
         graphicsCommandList->DrawIndexedInstanced(count, 1, 0, 0, 0);
+        ++passStats.drawCalls;
+        passStats.indexCount += count;
     }
+    // Store the statistics. The shading pass only writes to its own members.
+    FrameStats& frameStats    = m_frameStats.current();
+    frameStats.totalObjCount  = static_cast<uint32_t>(n);
+    frameStats.visObjCount    = static_cast<uint32_t>(visObjCount);
+    frameStats.drawnObjCount  = static_cast<uint32_t>(visObjCount);
+    frameStats.matSwitchCount = matSwitchCount;
+    frameStats.gBufferPass    = passStats;
+    frameStats.scratchBytes   = static_cast<uint32_t>(m_tempAlloca.allocatedSize());
     // Reset the allocator to reuse the memory.
     m_tempAlloca.reset();
 }
 
 void Renderer::recordShadingPass(const PerspectiveCamera& pCam) {
     ID3D12GraphicsCommandList* graphicsCommandList = m_graphicsContext.commandList(1);
+    PassStats passStats{};
     // Set the necessary command list state.
     graphicsCommandList->RSSetViewports(1, &m_viewport);
     graphicsCommandList->RSSetScissorRects(1, &m_scissorRect);
@@ -810,16 +883,20 @@ void Renderer::recordShadingPass(const PerspectiveCamera& pCam) {
     barriers[5] = D3D12_TRANSITION_BARRIER{backBuffer, D3D12_RESOURCE_STATE_PRESENT,
                                                        D3D12_RESOURCE_STATE_RENDER_TARGET};
     graphicsCommandList->ResourceBarrier(6, barriers);
+    passStats.barrierCount += 6;
     // Store the 3x3 part of the raster-to-view-direction matrix.
     XMFLOAT3X3 rasterToViewDir;
     XMStoreFloat3x3(&rasterToViewDir, pCam.computeRasterToViewDirMatrix());
     // Set the root arguments.
     graphicsCommandList->SetGraphicsRoot32BitConstants(0, 9, &rasterToViewDir, 0);
+    ++passStats.rootConstChanges;
     graphicsCommandList->SetGraphicsRootShaderResourceView(1, m_materialBuffer.view);
     // Set the SRVs of the G-buffer.
     graphicsCommandList->SetGraphicsRootDescriptorTable(2, m_texPool.gpuHandle(0));
+    ++passStats.descTableChanges;
     // Set the SRVs of all textures.
     graphicsCommandList->SetGraphicsRootDescriptorTable(3, m_texPool.gpuHandle(0));
+    ++passStats.descTableChanges;
     // Set the RTV.
     const D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle = m_rtvPool.cpuHandle(m_backBufferIndex);
     graphicsCommandList->OMSetRenderTargets(1, &rtvHandle, false, nullptr);
@@ -827,23 +904,33 @@ void Renderer::recordShadingPass(const PerspectiveCamera& pCam) {
     graphicsCommandList->DiscardResource(backBuffer, nullptr);
     // Perform the screen space pass using a single triangle.
     graphicsCommandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-    graphicsCommandList->DrawInstanced(3, 1, 0, 0);
+    const uint32_t vertexCount = 3;
+    graphicsCommandList->DrawInstanced(vertexCount, 1, 0, 0);
+    ++passStats.drawCalls;
+    passStats.indexCount += vertexCount;
     // Start the transition of the G-buffer to the writable state.
     m_gBuffer.setWriteBarriers(barriers, D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY);
     // Transition the state of the back buffer: Render Target -> Presenting.
     barriers[5] = D3D12_TRANSITION_BARRIER{backBuffer, D3D12_RESOURCE_STATE_RENDER_TARGET,
                                                        D3D12_RESOURCE_STATE_PRESENT};
     graphicsCommandList->ResourceBarrier(6, barriers);
+    passStats.barrierCount += 6;
+    // Store the statistics. The G-buffer pass only writes to its own members.
+    m_frameStats.current().shadingPass = passStats;
 }
 
 void Renderer::renderFrame() {
     // Finalize and execute command lists.
     m_graphicsContext.executeCommandLists();
+    // Commit the statistics of the recorded frame.
+    m_frameStats.advance();
     // Present the frame, and update the index of the render (back) buffer.
     CHECK_CALL(m_swapChain->Present(VSYNC_INTERVAL, 0), "Failed to display the frame buffer.");
     m_backBufferIndex = m_swapChain->GetCurrentBackBufferIndex();
     // Reset the graphics command (frame) allocator.
     m_graphicsContext.resetCommandAllocators();
+    // Release the textures which are no longer in use.
+    reclaimResources();
     // Reset command lists to their initial states.
     m_graphicsContext.resetCommandList(0, m_gBufferPass.pipelineState.Get());
     m_graphicsContext.resetCommandList(1, m_shadingPass.pipelineState.Get());
@@ -856,7 +943,30 @@ std::pair<uint64_t, uint64_t> Renderer::getTime() const {
     return m_graphicsContext.getTime();
 }
 
+const FrameStatsHistory& Renderer::frameStats() const {
+    return m_frameStats;
+}
+
+// Prints the occupancy and the fragmentation of the heaps of the pool.
+static inline void printHeapStats(const char* name, const TlsfStats& stats) {
+    printInfo("%s heaps: %" PRIu64 " KiB used out of %" PRIu64 " KiB, %u allocations, "
+              "%u free blocks (largest: %" PRIu64 " KiB), fragmentation: %.1f%%.", name,
+              stats.usedSize / 1024, stats.capacity / 1024, stats.allocationCount,
+              stats.freeBlockCount, stats.largestFreeBlock / 1024,
+              100.f * stats.fragmentation());
+}
+
+void Renderer::printHeapReport() const {
+    printHeapStats("Buffer",  m_bufferHeaps.stats());
+    printHeapStats("Texture", m_textureHeaps.stats());
+    // The size of a descriptor heap is driver-defined, so we only report the descriptor counts.
+    printInfo("Descriptor heaps: %zu RTV, %zu DSV, %zu CBV/SRV/UAV descriptors.",
+              m_rtvPool.capacity, m_dsvPool.capacity, m_texPool.capacity);
+}
+
 void Renderer::stop() {
+    // Complete the pending uploads, and shut down the upload thread.
+    m_uploadQueue = UploadQueue{};
     m_copyContext.destroy();
     m_graphicsContext.destroy();
 }
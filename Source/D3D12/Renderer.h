@@ -3,7 +3,10 @@
 #include <DirectXMathSSE4.h>
 #include "HelperStructs.h"
 #include "..\Common\Constants.h"
+#include "..\Common\FrameStats.h"
+#include "..\Common\MemoryStats.h"
 #include "..\Common\Resources.h"
+#include "..\Common\UploadQueue.h"
 
 struct Material;
 class  PerspectiveCamera;
@@ -12,14 +15,20 @@ class  Scene;
 namespace D3D12 {
     class Renderer {
     public:
-        RULE_OF_ZERO_MOVE_ONLY(Renderer);
+        // Immovable: the upload queue calls back into the renderer via 'this'.
+        RULE_OF_ZERO_IMMOVABLE(Renderer);
         Renderer();
         // Creates a 2D texture according to the provided description of the base MIP image.
         // Multi-sample textures and texture arrays are not supported.
+        // If provided, 'mipData' must contain the data of all 'mipCount' MIP levels;
+        // the row pitch of the footprint is ignored.
         Texture createTexture2D(const D3D12_SUBRESOURCE_FOOTPRINT& footprint,
-                                const uint32_t mipCount, const void* data);
+                                const uint32_t mipCount,
+                                const D3D12_SUBRESOURCE_DATA* mipData);
         // Returns the index of the SRV within the texture pool.
         size_t getTextureIndex(const Texture& texture) const;
+        // Releases the texture (including its memory and SRV) once the GPU stops using it.
+        void releaseTexture(Texture&& texture);
         // Creates a constant buffer for the data of the specified size (in bytes).
         ConstantBuffer createConstantBuffer(const size_t size, const void* data = nullptr);
         // Creates a structured buffer for the data of the specified size (in bytes).
@@ -31,12 +40,10 @@ namespace D3D12 {
         VertexBuffer createVertexBuffer(const size_t count, const T* elements);
         // Sets materials (represented by texture indices) in shaders.
         void setMaterials(const size_t count, const Material* materials);
-        // Submits all pending copy commands for execution, and begins a new segment
-        // of the upload buffer. As a result, the previous segment of the buffer becomes
-        // available for writing. 'immediateCopy' flag ensures that all copies from the
-        // current segment are also completed during this call (at the cost of blocking
-        // the thread), therefore making the entire buffer free and available for writing.
-        void executeCopyCommands(const bool immediateCopy = false);
+        // Submits the pending uploads without waiting for the batching deadline.
+        // Returns the future which becomes ready once all uploads so far are complete.
+        // The graphics queue waits for the submitted uploads, so waiting on the CPU is optional.
+        std::future<void> flushUploads();
         // Records commands within the G-buffer generation pass.
         // Input: the camera and opaque scene objects.
         void recordGBufferPass(const PerspectiveCamera& pCam, const Scene& scene);
@@ -46,6 +53,10 @@ namespace D3D12 {
         void renderFrame();
         // Returns the current time of the CPU thread and the GPU queue in microseconds.
         std::pair<uint64_t, uint64_t> getTime() const;
+        // Returns the rendering statistics of the recent frames.
+        const FrameStatsHistory& frameStats() const;
+        // Prints the occupancy and the fragmentation of the GPU heaps, and the descriptor counts.
+        void printHeapReport() const;
         // Terminates the rendering process.
         void stop();
     private:
@@ -63,6 +74,11 @@ namespace D3D12 {
             ComPtr<ID3D12RootSignature> rootSignature;
             ComPtr<ID3D12PipelineState> pipelineState;
         };
+        struct PendingRelease {
+            ComPtr<ID3D12Resource>      resource;
+            HeapAllocation              allocation;
+            uint64_t                    fenceValue;  // Graphics fence value of the last use
+        };
         // Configures the G-buffer generation pass.
         void configureGBufferPass();
         // Configures the shading pass.
@@ -73,11 +89,30 @@ namespace D3D12 {
         // Creates a render buffer with descriptors in both RTV and texture pools.
         ComPtr<ID3D12Resource> createRenderBuffer(const uint32_t width, const uint32_t height,
                                                   const DXGI_FORMAT format);
+        // Creates a resource (in the 'COMMON' state) placed within a heap of the pool.
+        // Optionally, returns the range of the heap occupied by the resource.
+        // Records the allocation; recording the deallocation is the responsibility of the caller.
+        ComPtr<ID3D12Resource> createPlacedResource(GpuHeapPool& heapPool,
+                                                    const D3D12_RESOURCE_DESC& resourceDesc,
+                                                    const MemTag tag,
+                                                    HeapAllocation* allocation = nullptr);
+        // Releases the resources (and descriptors) no longer used by the completed GPU work.
+        void reclaimResources();
+        // Records the GPU memory allocation of the resource with the specified description.
+        void recordGpuAllocation(const D3D12_RESOURCE_DESC& resourceDesc, const MemTag tag) const;
+        // Records the upload of the data of the specified size (in bytes) into the buffer.
+        void uploadToBuffer(ID3D12Resource* buffer, const size_t size, const void* data);
+        // Submits all pending copy commands for execution, and begins a new segment
+        // of the upload buffer. Segments become available for writing once the copies
+        // which read from them complete. Must be invoked while holding the upload queue lock.
+        // Returns the fence value signaled once the copies complete.
+        uint64_t submitCopyCommands();
         // Copies the data of the specified size (in bytes) and alignment into the upload buffer.
         // Returns the offset into the upload buffer which corresponds to the location of the data.
         template<size_t alignment>
         size_t copyToUploadBuffer(const size_t size, const void* data);
         // Reserves a contiguous chunk of memory of the specified size within the upload buffer.
+        // If the buffer is full, submits the pending copies and/or waits for their completion.
         // The reservation is guaranteed to be valid only until any other member function call.
         // Returns the address of and the offset to the beginning of the chunk of the upload buffer.
         template<size_t alignment>
@@ -99,11 +134,18 @@ namespace D3D12 {
         D3D12_RECT                    m_scissorRect;
         GBuffer                       m_gBuffer;
         StructuredBuffer              m_materialBuffer;
+        GpuHeapPool                   m_bufferHeaps;     // Monotonic: buffers are never freed
+        GpuHeapPool                   m_textureHeaps;
+        std::vector<HeapAllocation>   m_texAllocations;  // Heap ranges of textures (by SRV)
+        std::vector<PendingRelease>   m_pendingReleases; // Released textures (from the oldest)
         LinearAllocator               m_tempAlloca;
         RenderPassConfig              m_gBufferPass;
         RenderPassConfig              m_shadingPass;
         // Copying infrastructure.
         CopyContext<2, 1>             m_copyContext;
         UploadRingBuffer              m_uploadBuffer;
+        UploadQueue                   m_uploadQueue;
+        // Statistics.
+        FrameStatsHistory             m_frameStats;
     };
 } // namespace D3D12
@@ -1,5 +1,6 @@
 #include <future>
 #include "Common\Camera.h"
+#include "Common\FrameTimeStats.h"
 #include "Common\Scene.h"
 #include "D3D12\Renderer.hpp"
 #include "UI\Window.h"
@@ -35,6 +36,10 @@ int __cdecl main(const int argc, const char* argv[]) {
     D3D12::Renderer engine;
     // Provide the scene description.
     Scene scene{"..\\..\\Assets\\Sponza\\", "sponza.obj", engine};
+    // Report the uploads recorded while loading the scene (they are not charged to any frame).
+    const UploadStats& loadUploads = engine.frameStats().loadUploads();
+    printInfo("Uploaded %.2f MiB while loading the scene (%u upload buffer stalls).",
+              loadUploads.bytes / (1024.0 * 1024.0), loadUploads.stalls);
     // Set up the camera.
     PerspectiveCamera pCam{static_cast<float>(Window::width()),
                            static_cast<float>(Window::height()),
@@ -48,6 +53,7 @@ int __cdecl main(const int argc, const char* argv[]) {
     float  timeDelta = 0.f;
     uint64_t cpuTime0, gpuTime0;
     std::tie(cpuTime0, gpuTime0) = engine.getTime();
+    FrameTimeStats frameTimeStats;
     // Main loop.
     while (true) {
         // Drain the message queue.
@@ -73,7 +79,17 @@ int __cdecl main(const int argc, const char* argv[]) {
                     }
                     break;
                 case WM_QUIT:
+                    // Close the frame time windows at the time of exit.
+                    const uint64_t quitTime = engine.getTime().first;
                     engine.stop();
+                    // Dump the rendering statistics of the recent frames.
+                    engine.frameStats().writeCsv("FrameStats.csv");
+                    engine.frameStats().writeJson("FrameStats.json");
+                    // Report the frame time distribution.
+                    frameTimeStats.printReport(quitTime);
+                    // Report the memory usage.
+                    MemoryStats::printReport();
+                    engine.printHeapReport();
                     // Return this part of the WM_QUIT message to Windows.
                     return static_cast<int>(msg.wParam);
             }
@@ -113,6 +129,7 @@ int __cdecl main(const int argc, const char* argv[]) {
             std::tie(cpuTime1, gpuTime1) = engine.getTime();
             const uint64_t cpuFrameTime  = cpuTime1 - cpuTime0;
             const uint64_t gpuFrameTime  = gpuTime1 - gpuTime0;
+            frameTimeStats.record(cpuFrameTime, gpuFrameTime, cpuTime1);
             // Convert the frame times from microseconds to milliseconds.
             Window::displayInfo(cpuFrameTime * 1e-3f, gpuFrameTime * 1e-3f);
             // Convert the frame time from microseconds to seconds.
@@ -0,0 +1,133 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <thread>
+#include "Test.h"
+#include "..\Common\AssetPack.h"
+#include "..\Common\Utility.h"
+
+static const char* PACK_FILE = "AssetPackTest.pack";
+
+// Generates compressible contents (random words from a small dictionary).
+static auto generateText(const size_t size, const uint32_t seed)
+-> std::vector<byte_t> {
+    static const char* words[] = {"vertex ", "normal ", "texture ", "material ", "0.125 ",
+                                  "-1.5 ", "42 ", "mip ", "chunk ", "\n"};
+    std::mt19937 rng{seed};
+    std::vector<byte_t> contents(size);
+    for (size_t i = 0; i < size; ) {
+        const char*  word   = words[rng() % _countof(words)];
+        const size_t length = std::min(strlen(word), size - i);
+        memcpy(&contents[i], word, length);
+        i += length;
+    }
+    return contents;
+}
+
+// Writes the files, and packs them (with compression enabled).
+static void buildPack(const std::vector<std::string>& fileNames,
+                      const std::vector<std::vector<byte_t>>& contents) {
+    for (size_t i = 0; i < fileNames.size(); ++i) {
+        FILE* file;
+        if (fopen_s(&file, fileNames[i].c_str(), "wb")) {
+            printError("Failed to create the file: %s", fileNames[i].c_str());
+            TERMINATE();
+        }
+        if (!contents[i].empty()) {
+            fwrite(contents[i].data(), 1, contents[i].size(), file);
+        }
+        fclose(file);
+    }
+    AssetPack::build(PACK_FILE, "", fileNames, true);
+    for (const auto& fileName : fileNames) {
+        remove(fileName.c_str());
+    }
+}
+
+// Packs compressible (multi-chunk), incompressible and empty files, and reads them back.
+TEST(assetPackRoundTrip) {
+    const std::vector<std::string> fileNames = {"AssetPackTest0.obj", "AssetPackTest1.tga",
+                                                "AssetPackTest2.mtl"};
+    std::vector<std::vector<byte_t>> contents(3);
+    // Not a multiple of the chunk size.
+    contents[0] = generateText(5 * 1024 * 1024 + 12345, 1);
+    contents[1].resize(700 * 1024);
+    std::mt19937 rng{2};
+    for (auto& b : contents[1]) {
+        b = static_cast<byte_t>(rng());
+    }
+    buildPack(fileNames, contents);
+    {
+        const AssetPack pack{PACK_FILE};
+        CHECK(3 == pack.size());
+        for (size_t i = 0; i < fileNames.size(); ++i) {
+            AssetRange range;
+            CHECK(pack.find(fileNames[i].c_str(), range));
+            CHECK(contents[i].size() == range.size);
+            std::vector<byte_t> result(contents[i].size());
+            pack.read(range, result.data());
+            CHECK(result == contents[i]);
+        }
+        AssetRange range;
+        CHECK(pack.find("ASSETPACKTEST0.OBJ", range) && range.isCompressed);
+    }
+    remove(PACK_FILE);
+}
+
+// Compares the throughput of decompressing a single-chunk asset (on the calling thread)
+// with the throughput of decompressing a large asset (on the shared executor), both with
+// a single caller and with several concurrent callers (like the I/O threads).
+BENCHMARK(assetPackDecompressScaling) {
+    constexpr size_t LARGE_SIZE = 64 * 1024 * 1024;
+    constexpr size_t SMALL_SIZE = 256 * 1024;
+    constexpr int    REPEAT     = 5;
+    const std::vector<std::string> fileNames = {"AssetPackLarge.bin", "AssetPackSmall.bin"};
+    buildPack(fileNames, {generateText(LARGE_SIZE, 3), generateText(SMALL_SIZE, 4)});
+    {
+        const AssetPack pack{PACK_FILE};
+        AssetRange large, small;
+        CHECK(pack.find(fileNames[0].c_str(), large) && large.isCompressed);
+        CHECK(pack.find(fileNames[1].c_str(), small) && small.isCompressed);
+        // Decompresses the asset 'count' times on each of 'threadCount' threads.
+        // Returns the throughput (in GB/s of decompressed data).
+        auto measure = [&pack](const AssetRange& range, const size_t count,
+                               const size_t threadCount) {
+            double bestTime = 1e9;
+            for (int r = 0; r < REPEAT; ++r) {
+                const auto startTime = std::chrono::steady_clock::now();
+                std::vector<std::thread> threads;
+                for (size_t t = 0; t < threadCount; ++t) {
+                    threads.emplace_back([&pack, &range, count]() {
+                        // Write to distinct memory, so that the cache does not favor small assets.
+                        const size_t size = static_cast<size_t>(range.size);
+                        std::vector<byte_t> dst(size * count);
+                        for (size_t i = 0; i < count; ++i) {
+                            AssetPack::decompress(pack.data(range), range, &dst[i * size]);
+                        }
+                    });
+                }
+                for (auto& thread : threads) {
+                    thread.join();
+                }
+                const std::chrono::duration<double> time = std::chrono::steady_clock::now() -
+                                                           startTime;
+                bestTime = std::min(bestTime, time.count());
+            }
+            return range.size * count * threadCount / bestTime * 1e-9;
+        };
+        const size_t threadCount   = std::max(1u, std::thread::hardware_concurrency());
+        const double serial        = measure(small, LARGE_SIZE / SMALL_SIZE, 1);
+        const double parallel      = measure(large, 1, 1);
+        const double concurrent    = measure(large, 1, 4);
+        printInfo("%zu hardware threads, compression ratio %.2f", threadCount,
+                  static_cast<double>(large.size) / large.storedSize);
+        printInfo("Serial (single chunk assets):    %5.2f GB/s", serial);
+        printInfo("Parallel (1 caller):             %5.2f GB/s, speedup %.2fx", parallel,
+                  parallel / serial);
+        printInfo("Parallel (4 concurrent callers): %5.2f GB/s, speedup %.2fx", concurrent,
+                  concurrent / serial);
+    }
+    remove(PACK_FILE);
+}
@@ -0,0 +1,135 @@
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <thread>
+#include "Test.h"
+#include "..\Common\AtomicDynBitSet.h"
+#include "..\Common\Utility.h"
+
+// Packs 'count' bits of the reference starting with 'first' into 64-bit words.
+static auto packBits(const std::vector<bool>& reference, const size_t first, const size_t count)
+-> std::vector<uint64_t> {
+    std::vector<uint64_t> words((count + 63) / 64);
+    for (size_t i = 0; i < count; ++i) {
+        if (reference[first + i]) words[i / 64] |= uint64_t{1} << (i % 64);
+    }
+    return words;
+}
+
+// Concurrent writers publish disjoint, arbitrarily aligned ranges which share boundary words.
+TEST(atomicDynBitSetPublishRange) {
+    constexpr size_t SIZE = 10007;
+    std::mt19937 rng{3};
+    std::vector<bool> reference(SIZE);
+    for (size_t i = 0; i < SIZE; ++i) {
+        reference[i] = 0 != (rng() & 1);
+    }
+    for (int iter = 0; iter < 200; ++iter) {
+        AtomicDynBitSet bitSet{SIZE};
+        // The initial contents must be overwritten.
+        bitSet.reset(0 != (iter & 1));
+        // Split the set into ranges.
+        std::vector<size_t> cuts = {0, SIZE};
+        for (int k = 0; k < 15; ++k) {
+            cuts.push_back(rng() % SIZE);
+        }
+        std::sort(cuts.begin(), cuts.end());
+        std::vector<std::thread> writers;
+        for (size_t t = 0; t + 1 < cuts.size(); ++t) {
+            writers.emplace_back([&bitSet, &reference, &cuts, t]() {
+                const size_t first = cuts[t], count = cuts[t + 1] - cuts[t];
+                const std::vector<uint64_t> bits = packBits(reference, first, count);
+                bitSet.publishRange(first, count, bits.data());
+            });
+        }
+        for (auto& writer : writers) {
+            writer.join();
+        }
+        size_t popCount = 0, mismatchCount = 0;
+        for (size_t i = 0; i < SIZE; ++i) {
+            popCount      += reference[i];
+            mismatchCount += reference[i] != bitSet.testBit(i);
+        }
+        CHECK(0 == mismatchCount);
+        CHECK(popCount == bitSet.popCount());
+    }
+}
+
+// Concurrent writers set and clear interleaved bits of the same words.
+TEST(atomicDynBitSetSetClearBits) {
+    constexpr size_t SIZE = 100003;
+    constexpr size_t THREAD_CNT = 8;
+    AtomicDynBitSet bitSet{SIZE};
+    std::vector<std::thread> writers;
+    for (size_t t = 0; t < THREAD_CNT; ++t) {
+        writers.emplace_back([&bitSet, t]() {
+            for (size_t i = t; i < SIZE; i += THREAD_CNT) {
+                CHECK(!bitSet.setBit(i));
+            }
+        });
+    }
+    for (auto& writer : writers) {
+        writer.join();
+    }
+    CHECK(SIZE == bitSet.popCount());
+    // Odd threads clear their bits while even threads toggle theirs twice.
+    writers.clear();
+    for (size_t t = 0; t < THREAD_CNT; ++t) {
+        writers.emplace_back([&bitSet, t]() {
+            for (size_t i = t; i < SIZE; i += THREAD_CNT) {
+                if (t & 1) {
+                    CHECK(bitSet.clearBit(i));
+                } else {
+                    CHECK(bitSet.clearBit(i));
+                    CHECK(!bitSet.setBit(i));
+                }
+            }
+        });
+    }
+    for (auto& writer : writers) {
+        writer.join();
+    }
+    size_t mismatchCount = 0;
+    for (size_t i = 0; i < SIZE; ++i) {
+        mismatchCount += bitSet.testBit(i) != (0 == (i % THREAD_CNT) % 2);
+    }
+    CHECK(0 == mismatchCount);
+}
+
+// Measures the throughput of publishing the visibility of 16M objects from 1 to N threads.
+// Each thread owns a contiguous range of objects (a culling job).
+BENCHMARK(atomicDynBitSetPublishScaling) {
+    constexpr size_t SIZE     = 16 * 1024 * 1024;
+    constexpr int    REPEAT   = 20;
+    const size_t     maxCount = std::max(1u, std::thread::hardware_concurrency());
+    AtomicDynBitSet bitSet{SIZE};
+    std::vector<uint64_t> bits(SIZE / 64);
+    std::mt19937_64 rng{5};
+    for (auto& word : bits) {
+        word = rng();
+    }
+    double singleTime = 0;
+    for (size_t threadCount = 1; threadCount <= maxCount; threadCount *= 2) {
+        // Ranges are deliberately not word-aligned.
+        const size_t rangeSize = SIZE / threadCount - 3;
+        double bestTime = 1e9;
+        for (int r = 0; r < REPEAT; ++r) {
+            const auto startTime = std::chrono::steady_clock::now();
+            std::vector<std::thread> writers;
+            for (size_t t = 0; t < threadCount; ++t) {
+                writers.emplace_back([&bitSet, &bits, rangeSize, t]() {
+                    bitSet.publishRange(t * rangeSize, rangeSize, bits.data());
+                });
+            }
+            for (auto& writer : writers) {
+                writer.join();
+            }
+            const std::chrono::duration<double> time = std::chrono::steady_clock::now() - startTime;
+            bestTime = std::min(bestTime, time.count());
+        }
+        if (1 == threadCount) singleTime = bestTime;
+        printInfo("%2zu threads: %7.3f ms, %6.2f Gbit/s, speedup %.2fx", threadCount,
+                  bestTime * 1e3, rangeSize * threadCount / bestTime * 1e-9,
+                  singleTime / bestTime);
+    }
+}
@@ -0,0 +1,85 @@
+#include <algorithm>
+#include <random>
+#include "Test.h"
+#include "..\Common\DescriptorAllocator.h"
+
+// Freed slots are invalidated immediately, but only recycled once the fence is reached.
+TEST(descriptorAllocatorFenceRecycling) {
+    DescriptorAllocator allocator{256};
+    for (uint32_t i = 0; i < 8; ++i) {
+        const DescriptorRange range = allocator.allocate();
+        CHECK(i == range.index && 1 == range.count);
+    }
+    const DescriptorRange table = allocator.allocate(16);
+    CHECK(8 == table.index && 16 == table.count);
+    for (uint32_t i = table.index; i < table.index + table.count; ++i) {
+        CHECK(allocator.isAllocated(i));
+    }
+    const DescriptorRange range = allocator.range(3);
+    CHECK(allocator.isValid(range));
+    allocator.free(range, 5);
+    CHECK(!allocator.isValid(range));
+    CHECK(!allocator.isAllocated(3));
+    // The slot awaits recycling.
+    CHECK(24 == allocator.size());
+    allocator.reclaim(4);
+    const DescriptorRange early = allocator.allocate();
+    CHECK(3 != early.index);
+    allocator.free(early, 6);
+    allocator.reclaim(6);
+    CHECK(23 == allocator.size());
+    // The recycled slot gets a new generation, so the old handle remains stale.
+    const DescriptorRange late = allocator.allocate();
+    CHECK(3 == late.index && range.generation != late.generation);
+    CHECK(allocator.isValid(late) && !allocator.isValid(range));
+}
+
+// Random allocations and deallocations of ranges with a lagging fence.
+// Live ranges must remain valid and disjoint, and slots awaiting the fence must not be reused.
+TEST(descriptorAllocatorRandomized) {
+    constexpr uint32_t CAPACITY = 256;
+    DescriptorAllocator allocator{CAPACITY};
+    std::mt19937 rng{3};
+    std::vector<DescriptorRange> liveRanges;
+    // Fence value for each slot awaiting recycling (0 if not pending).
+    std::vector<uint64_t> pendingFences(CAPACITY, 0);
+    std::vector<bool>     liveSlots(CAPACITY, false);
+    uint64_t fenceValue = 10, completedFenceValue = 0;
+    uint32_t conflictCount = 0, invalidCount = 0;
+    for (int i = 0; i < 100000; ++i) {
+        if (liveRanges.empty() || (0 != rng() % 2 && allocator.size() < CAPACITY - 56)) {
+            const DescriptorRange range = allocator.allocate(1 + rng() % 4);
+            for (uint32_t s = range.index; s < range.index + range.count; ++s) {
+                conflictCount += liveSlots[s] || pendingFences[s] > completedFenceValue;
+                liveSlots[s] = true;
+            }
+            liveRanges.push_back(range);
+        } else {
+            const size_t index = rng() % liveRanges.size();
+            const DescriptorRange range = liveRanges[index];
+            allocator.free(range, fenceValue);
+            invalidCount += allocator.isValid(range);
+            for (uint32_t s = range.index; s < range.index + range.count; ++s) {
+                liveSlots[s]     = false;
+                pendingFences[s] = fenceValue;
+            }
+            liveRanges[index] = liveRanges.back();
+            liveRanges.pop_back();
+        }
+        if (0 == rng() % 4) {
+            // The GPU lags behind by a few fence values.
+            completedFenceValue = std::max(completedFenceValue, fenceValue++ - rng() % 3);
+            allocator.reclaim(completedFenceValue);
+        }
+        for (const DescriptorRange& range : liveRanges) {
+            invalidCount += !allocator.isValid(range);
+        }
+    }
+    CHECK(0 == conflictCount);
+    CHECK(0 == invalidCount);
+    for (const DescriptorRange& range : liveRanges) {
+        allocator.free(range, fenceValue);
+    }
+    allocator.reclaim(fenceValue);
+    CHECK(0 == allocator.size());
+}
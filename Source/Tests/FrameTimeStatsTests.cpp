@@ -0,0 +1,67 @@
+#include "Test.h"
+#include "..\Common\FrameTimeStats.h"
+
+using Metric = FrameTimeStats::Metric;
+using Window = FrameTimeStats::Window;
+
+// Records frames of the specified duration (in microseconds) from 'begin' until 'end'.
+// Returns the time stamp of the last frame.
+static auto recordFrames(FrameTimeStats& stats, const uint64_t begin, const uint64_t end,
+                         const uint64_t frameTime)
+-> uint64_t {
+    uint64_t timeStamp = begin;
+    for (uint64_t t = begin + frameTime; t <= end; t += frameTime) {
+        stats.record(frameTime, frameTime / 2, t);
+        timeStamp = t;
+    }
+    return timeStamp;
+}
+
+// Returns the number of frames within the window ending at 'timeStamp'.
+static auto frameCount(const FrameTimeStats& stats, const Window window, const uint64_t timeStamp)
+-> uint64_t {
+    return stats.histogram(Metric::CPU, window, timeStamp).count();
+}
+
+// Checks that rolling windows span their full duration, regardless of the slot boundaries.
+TEST(frameTimeStatsRollingWindows) {
+    FrameTimeStats stats;
+    // 20 seconds at 100 frames per second, starting mid-slot.
+    const uint64_t frameTime = 10000;
+    const uint64_t begin     = 12345;
+    const uint64_t last      = recordFrames(stats, begin, begin + 20000000, frameTime);
+    // Query at several offsets within a slot.
+    for (uint64_t offset = 0; offset < FrameTimeStats::SLOT_DURATION; offset += 25000) {
+        const uint64_t now = last + offset;
+        // The window is accurate up to a slot (10 frames).
+        const uint64_t count1s  = frameCount(stats, Window::LAST_1S,  now);
+        const uint64_t count10s = frameCount(stats, Window::LAST_10S, now);
+        CHECK(90   <= count1s  && count1s  <= 110);
+        CHECK(990  <= count10s && count10s <= 1010);
+        CHECK(2000 == frameCount(stats, Window::SESSION, now));
+    }
+    CHECK(10000 == stats.percentile(Metric::CPU, Window::LAST_1S, last, 50.0));
+    CHECK(5000  == stats.percentile(Metric::GPU, Window::LAST_1S, last, 50.0));
+}
+
+// Checks that frames recorded before a pause leave the rolling windows once they age out,
+// including the slots which are reused after the pause.
+TEST(frameTimeStatsPause) {
+    FrameTimeStats stats;
+    const uint64_t frameTime = 20000;
+    const uint64_t last      = recordFrames(stats, 0, 5050000, frameTime);
+    // 9.5 seconds later, only the 10 second window still overlaps the frames before the pause.
+    CHECK(0 == frameCount(stats, Window::LAST_1S, last + 9500000));
+    CHECK(0 <  frameCount(stats, Window::LAST_10S, last + 9500000));
+    // Nothing is left 20 seconds later.
+    CHECK(0 == frameCount(stats, Window::LAST_1S,  last + 20000000));
+    CHECK(0 == frameCount(stats, Window::LAST_10S, last + 20000000));
+    CHECK(0 == stats.percentile(Metric::CPU, Window::LAST_10S, last + 20000000, 99.0));
+    // Resume in the slot which reuses the storage of the slot of the last frame.
+    const uint64_t resume = last + FrameTimeStats::SLOT_CNT * FrameTimeStats::SLOT_DURATION;
+    stats.record(40000, 40000, resume);
+    CHECK(1 == frameCount(stats, Window::LAST_1S,  resume));
+    CHECK(1 == frameCount(stats, Window::LAST_10S, resume));
+    CHECK(40000 == stats.histogram(Metric::CPU, Window::LAST_1S, resume).maxValue());
+    CHECK(frameCount(stats, Window::SESSION, resume) == 5050000 / frameTime + 1);
+}
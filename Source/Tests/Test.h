@@ -0,0 +1,42 @@
+#pragma once
+
+#include <vector>
+#include "..\Common\Definitions.h"
+
+// Unit test (or benchmark) registered during static initialization.
+struct TestCase {
+    const char* name;
+    void      (*func)();
+    bool        isBenchmark;
+};
+
+// Returns the registered test cases.
+std::vector<TestCase>& testCases();
+
+// Registers the test case during static initialization.
+struct TestRegistrar {
+    TestRegistrar(const char* name, void (*func)(), const bool isBenchmark);
+};
+
+// Records the failure of the check 'expr' (thread-safe).
+void reportFailure(const char* expr, const char* file, const int line);
+
+// Defines and registers a unit test. Tests are headless, and do not use the GPU.
+#define TEST(name)                                                 \
+    static void name();                                            \
+    static const TestRegistrar name##Registrar{#name, name, false}; \
+    static void name()
+
+// Defines and registers a benchmark. Benchmarks only run when requested ('-b').
+#define BENCHMARK(name)                                           \
+    static void name();                                           \
+    static const TestRegistrar name##Registrar{#name, name, true}; \
+    static void name()
+
+// Records a failure (and continues) if the expression evaluates to 'false'.
+#define CHECK(expr)                                   \
+    do {                                              \
+        if (!(expr)) {                                \
+            reportFailure(#expr, __FILE__, __LINE__); \
+        }                                             \
+    } while (0)
@@ -0,0 +1,47 @@
+#include <atomic>
+#include <cstring>
+#include "Test.h"
+#include "..\Common\Utility.h"
+
+static std::atomic<uint32_t> failureCount{0};
+
+std::vector<TestCase>& testCases() {
+    static std::vector<TestCase> cases;
+    return cases;
+}
+
+TestRegistrar::TestRegistrar(const char* name, void (*func)(), const bool isBenchmark) {
+    testCases().push_back(TestCase{name, func, isBenchmark});
+}
+
+void reportFailure(const char* expr, const char* file, const int line) {
+    ++failureCount;
+    printWarning("Check failed: %s (%s : %i)", expr, file, line);
+}
+
+int __cdecl main(const int argc, const char* argv[]) {
+    // Parse command line arguments.
+    const bool runBenchmarks = argc == 2 && 0 == strcmp(argv[1], "-b");
+    if (argc != 1 && !runBenchmarks) {
+        printError("Usage: Tests [-b]");
+        return -1;
+    }
+    // Run either the unit tests or the benchmarks.
+    uint32_t runCount = 0, failedCount = 0;
+    for (const TestCase& test : testCases()) {
+        if (test.isBenchmark != runBenchmarks) continue;
+        const uint32_t prevFailureCount = failureCount;
+        test.func();
+        ++runCount;
+        if (prevFailureCount == failureCount) {
+            printInfo("[  OK  ] %s", test.name);
+        } else {
+            printInfo("[FAILED] %s", test.name);
+            ++failedCount;
+        }
+    }
+    printInfo("%u of %u %s passed.", runCount - failedCount, runCount,
+              runBenchmarks ? "benchmarks" : "tests");
+    Logger::flush();
+    return static_cast<int>(failedCount);
+}
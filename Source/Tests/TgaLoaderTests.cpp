@@ -0,0 +1,84 @@
+#include <algorithm>
+#include <DirectXTex\DirectXTex.h>
+#include "Test.h"
+
+// Encodes an 8-bit grayscale or a 24-bit truecolor TGA image (raw or RLE compressed)
+// with the origin in the top-left or the bottom-left corner.
+// The value of each pixel is the index of its row, counting from the top of the image.
+static auto encodeTga(const size_t width, const size_t height, const size_t bytesPerPixel,
+                      const bool isRle, const bool isTopLeft)
+-> std::vector<byte_t> {
+    std::vector<byte_t> file(18, 0);
+    // Image type: (RLE) black and white, or (RLE) truecolor.
+    file[2]  = static_cast<byte_t>((1 == bytesPerPixel ? 3 : 2) + (isRle ? 8 : 0));
+    file[12] = static_cast<byte_t>(width);
+    file[13] = static_cast<byte_t>(width >> 8);
+    file[14] = static_cast<byte_t>(height);
+    file[15] = static_cast<byte_t>(height >> 8);
+    file[16] = static_cast<byte_t>(8 * bytesPerPixel);
+    file[17] = isTopLeft ? 0x20 : 0;
+    const auto pushPixel = [&](const size_t row) {
+        file.insert(file.end(), bytesPerPixel, static_cast<byte_t>(row));
+    };
+    for (size_t y = 0; y < height; ++y) {
+        const size_t row = isTopLeft ? y : height - 1 - y;
+        for (size_t x = 0; x < width; ) {
+            if (isRle) {
+                // Alternate between literal and run-length packets (of up to 3 pixels).
+                const size_t count = std::min<size_t>(3, width - x);
+                if (x % 2) {
+                    file.push_back(static_cast<byte_t>(0x80 | (count - 1)));
+                    pushPixel(row);
+                } else {
+                    file.push_back(static_cast<byte_t>(count - 1));
+                    for (size_t i = 0; i < count; ++i) {
+                        pushPixel(row);
+                    }
+                }
+                x += count;
+            } else {
+                pushPixel(row);
+                ++x;
+            }
+        }
+    }
+    return file;
+}
+
+// Decodes raw and RLE images with either origin, with and without flipping them vertically.
+// Spans several bands of scanlines, which are decoded in parallel.
+TEST(tgaLoaderOrigin) {
+    const size_t width = 37, height = 150;
+    for (const size_t bytesPerPixel : {1, 3}) {
+        for (const bool isRle : {false, true}) {
+            for (const bool isTopLeft : {false, true}) {
+                for (const bool isFlipped : {false, true}) {
+                    const auto file = encodeTga(width, height, bytesPerPixel, isRle, isTopLeft);
+                    const DWORD flags = isFlipped ? DirectX::TGA_FLAGS_FLIP_VERTICAL
+                                                  : DirectX::TGA_FLAGS_NONE;
+                    DirectX::TexMetadata  metadata;
+                    DirectX::ScratchImage image;
+                    const HRESULT hr = DirectX::LoadFromTGAMemory(file.data(), file.size(), flags,
+                                                                  &metadata, image);
+                    CHECK(SUCCEEDED(hr));
+                    if (FAILED(hr)) {
+                        continue;
+                    }
+                    CHECK(width == metadata.width && height == metadata.height);
+                    // Both formats store the red channel in the first byte.
+                    const DirectX::Image* img = image.GetImage(0, 0, 0);
+                    bool isOrdered = true;
+                    for (size_t y = 0; y < height; ++y) {
+                        const size_t row = isFlipped ? height - 1 - y : y;
+                        for (size_t x = 0; x < width; ++x) {
+                            const byte_t* pixel = img->pixels + y * img->rowPitch
+                                                + x * (1 == bytesPerPixel ? 1 : 4);
+                            isOrdered &= static_cast<byte_t>(row) == pixel[0];
+                        }
+                    }
+                    CHECK(isOrdered);
+                }
+            }
+        }
+    }
+}
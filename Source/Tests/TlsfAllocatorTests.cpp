@@ -0,0 +1,122 @@
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include "Test.h"
+#include "..\Common\TlsfAllocator.h"
+#include "..\Common\Utility.h"
+
+static constexpr uint64_t GRANULE = 64 * 1024;
+
+// Allocations of the whole address space, freed in various orders, must coalesce.
+TEST(tlsfAllocatorCoalesce) {
+    constexpr uint64_t COUNT = 1000;
+    TlsfAllocator allocator{COUNT * GRANULE, GRANULE};
+    TlsfAllocation whole;
+    // Sizes which are not on a list boundary must fit exactly.
+    CHECK(allocator.allocate(COUNT * GRANULE, GRANULE, whole));
+    CHECK(0 == whole.offset && COUNT * GRANULE == whole.size);
+    TlsfAllocation extra;
+    CHECK(!allocator.allocate(1, 1, extra));
+    allocator.free(whole);
+    std::vector<TlsfAllocation> allocations(COUNT);
+    for (auto& allocation : allocations) {
+        CHECK(allocator.allocate(GRANULE, GRANULE, allocation));
+    }
+    CHECK(COUNT * GRANULE == allocator.stats().usedSize);
+    // Free every other allocation, then the rest in the reverse order.
+    for (size_t i = 0; i < COUNT; i += 2) {
+        allocator.free(allocations[i]);
+    }
+    CHECK(COUNT / 2 == allocator.stats().freeBlockCount);
+    CHECK(GRANULE == allocator.stats().largestFreeBlock);
+    for (size_t i = COUNT - 1; i < COUNT; i -= 2) {
+        allocator.free(allocations[i]);
+    }
+    const TlsfStats stats = allocator.stats();
+    CHECK(0 == stats.usedSize && 0 == stats.allocationCount);
+    CHECK(1 == stats.freeBlockCount && COUNT * GRANULE == stats.largestFreeBlock);
+    CHECK(0.f == stats.fragmentation());
+}
+
+// Random allocations and deallocations with mixed sizes and alignments.
+// Checks the alignment, the bounds, overlaps, and the statistics.
+TEST(tlsfAllocatorRandomized) {
+    constexpr uint64_t CAPACITY = 4096 * GRANULE;
+    TlsfAllocator allocator{CAPACITY, GRANULE};
+    std::mt19937_64 rng{7};
+    std::vector<TlsfAllocation> allocations;
+    uint64_t failureCount = 0, invalidCount = 0, overlapCount = 0, statsMismatchCount = 0;
+    for (int i = 0; i < 300000; ++i) {
+        if (allocations.empty() || rng() % 100 < 55) {
+            const uint64_t size      = 1 + rng() % (GRANULE * (0 == rng() % 4 ? 200 : 8));
+            const uint64_t alignment = (0 == rng() % 16) ? 4 * 1024 * 1024 : GRANULE;
+            TlsfAllocation allocation;
+            if (allocator.allocate(size, alignment, allocation)) {
+                invalidCount += (0 != allocation.offset % alignment) || (allocation.size < size) ||
+                                (allocation.offset + allocation.size > CAPACITY);
+                allocations.push_back(allocation);
+            } else {
+                ++failureCount;
+            }
+        } else {
+            const size_t index = rng() % allocations.size();
+            allocator.free(allocations[index]);
+            allocations[index] = allocations.back();
+            allocations.pop_back();
+        }
+        if (0 == i % 1000) {
+            std::vector<TlsfAllocation> sorted = allocations;
+            std::sort(sorted.begin(), sorted.end(),
+                      [](const TlsfAllocation& a, const TlsfAllocation& b) {
+                          return a.offset < b.offset;
+                      });
+            uint64_t usedSize = 0;
+            for (size_t k = 0; k < sorted.size(); ++k) {
+                usedSize += sorted[k].size;
+                overlapCount += k > 0 &&
+                                sorted[k].offset < sorted[k - 1].offset + sorted[k - 1].size;
+            }
+            const TlsfStats stats = allocator.stats();
+            statsMismatchCount += stats.usedSize != usedSize ||
+                                  stats.allocationCount != sorted.size();
+        }
+    }
+    CHECK(0 == invalidCount);
+    CHECK(0 == overlapCount);
+    CHECK(0 == statsMismatchCount);
+    // The address space is oversubscribed, so some allocations must fail.
+    CHECK(0 != failureCount);
+    for (const auto& allocation : allocations) {
+        allocator.free(allocation);
+    }
+    const TlsfStats stats = allocator.stats();
+    CHECK(0 == stats.usedSize && 1 == stats.freeBlockCount && CAPACITY == stats.largestFreeBlock);
+}
+
+// Measures the cost of random allocations and deallocations in a large address space.
+BENCHMARK(tlsfAllocatorAllocFree) {
+    constexpr int OP_COUNT = 5000000;
+    TlsfAllocator allocator{uint64_t{1} << 40, GRANULE};
+    std::mt19937_64 rng{7};
+    std::vector<TlsfAllocation> allocations;
+    allocations.reserve(OP_COUNT);
+    const auto startTime = std::chrono::steady_clock::now();
+    for (int i = 0; i < OP_COUNT; ++i) {
+        if (allocations.empty() || (rng() & 1)) {
+            TlsfAllocation allocation;
+            if (allocator.allocate(1 + rng() % (GRANULE * 64), GRANULE, allocation)) {
+                allocations.push_back(allocation);
+            }
+        } else {
+            const size_t index = rng() % allocations.size();
+            allocator.free(allocations[index]);
+            allocations[index] = allocations.back();
+            allocations.pop_back();
+        }
+    }
+    const std::chrono::duration<double> time = std::chrono::steady_clock::now() - startTime;
+    const TlsfStats stats = allocator.stats();
+    printInfo("%.1f ns per operation, %u live allocations, %u free blocks, fragmentation %.3f",
+              time.count() * 1e9 / OP_COUNT, stats.allocationCount, stats.freeBlockCount,
+              stats.fragmentation());
+}
@@ -0,0 +1,159 @@
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include "Test.h"
+#include "..\Common\UploadQueue.h"
+
+// Simulated copy engine. Executes the submitted batches one by one (each takes 'latency'),
+// unless it is paused. Not copyable or movable (owns a thread).
+class MockCopyEngine {
+public:
+    explicit MockCopyEngine(const std::chrono::microseconds latency)
+        : m_latency{latency}
+        , m_thread{&MockCopyEngine::execute, this} {}
+    ~MockCopyEngine() {
+        {
+            std::lock_guard<std::mutex> lock{m_mutex};
+            m_isPaused  = false;
+            m_isRunning = false;
+        }
+        m_cond.notify_all();
+        m_thread.join();
+    }
+    // Returns the backend of an upload queue.
+    CopyBackend backend() {
+        return CopyBackend{
+            /* submit */              [this]() {
+                                          std::lock_guard<std::mutex> lock{m_mutex};
+                                          m_cond.notify_all();
+                                          return ++m_signaledValue;
+                                      },
+            /* completedFenceValue */ [this]() {
+                                          std::lock_guard<std::mutex> lock{m_mutex};
+                                          return m_completedValue;
+                                      },
+            /* wait */                [this](const uint64_t fenceValue) {
+                                          std::unique_lock<std::mutex> lock{m_mutex};
+                                          m_cond.wait(lock, [this, fenceValue]() {
+                                              return m_completedValue >= fenceValue;
+                                          });
+                                      }
+        };
+    }
+    // Stops (or resumes) the execution of the submitted batches.
+    void pause(const bool isPaused) {
+        {
+            std::lock_guard<std::mutex> lock{m_mutex};
+            m_isPaused = isPaused;
+        }
+        m_cond.notify_all();
+    }
+private:
+    void execute() {
+        std::unique_lock<std::mutex> lock{m_mutex};
+        while (m_isRunning || m_completedValue < m_signaledValue) {
+            m_cond.wait(lock, [this]() {
+                return !m_isRunning || (!m_isPaused && m_completedValue < m_signaledValue);
+            });
+            if (m_completedValue < m_signaledValue) {
+                lock.unlock();
+                std::this_thread::sleep_for(m_latency);
+                lock.lock();
+                ++m_completedValue;
+                m_cond.notify_all();
+            }
+        }
+    }
+private:
+    std::mutex                m_mutex;
+    std::condition_variable   m_cond;
+    uint64_t                  m_signaledValue  = 0;
+    uint64_t                  m_completedValue = 0;
+    bool                      m_isPaused       = false;
+    bool                      m_isRunning      = true;
+    std::chrono::microseconds m_latency;
+    std::thread               m_thread;
+};
+
+// Returns 'true' if the future is ready (or becomes ready within the timeout).
+static bool isReady(const std::future<void>& future,
+                    const std::chrono::milliseconds timeout = std::chrono::milliseconds{0}) {
+    return std::future_status::ready == future.wait_for(timeout);
+}
+
+// Waits (for at most 5 seconds) until the number of submitted batches reaches 'count'.
+static bool waitForBatchCount(const UploadQueue& queue, const uint64_t count) {
+    const auto endTime = std::chrono::steady_clock::now() + std::chrono::seconds{5};
+    while (queue.batchCount() < count) {
+        if (std::chrono::steady_clock::now() >= endTime) return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+    return true;
+}
+
+// Batches which are due (by size or by deadline) are submitted while the copies
+// of the previous batches are still in flight.
+TEST(uploadQueueSubmitWhileInFlight) {
+    MockCopyEngine copyEngine{std::chrono::microseconds{100}};
+    copyEngine.pause(true);
+    UploadQueue queue{copyEngine.backend(), 1000, 2000};
+    const std::future<void> first = queue.upload([]() { return uint64_t{1}; });
+    queue.flush();
+    CHECK(1 == queue.batchCount());
+    // Size-triggered submission.
+    const std::future<void> large = queue.upload([]() { return uint64_t{1000}; });
+    CHECK(waitForBatchCount(queue, 2));
+    // Deadline-triggered submission.
+    const std::future<void> small = queue.upload([]() { return uint64_t{1}; });
+    CHECK(waitForBatchCount(queue, 3));
+    CHECK(!isReady(first) && !isReady(large) && !isReady(small));
+    copyEngine.pause(false);
+    CHECK(isReady(first, std::chrono::milliseconds{5000}));
+    CHECK(isReady(large, std::chrono::milliseconds{5000}));
+    CHECK(isReady(small, std::chrono::milliseconds{5000}));
+}
+
+// Concurrent uploads, flushes, and the destruction of the queue with uploads in flight.
+TEST(uploadQueueConcurrentUploads) {
+    constexpr int THREAD_CNT = 4, UPLOAD_CNT = 500;
+    MockCopyEngine copyEngine{std::chrono::microseconds{300}};
+    UploadQueue queue{copyEngine.backend(), 1000, 2000};
+    std::mutex futuresMutex;
+    std::vector<std::future<void>> futures;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREAD_CNT; ++t) {
+        threads.emplace_back([&queue, &futures, &futuresMutex]() {
+            for (int i = 0; i < UPLOAD_CNT; ++i) {
+                std::future<void> future = queue.upload([]() { return uint64_t{7}; });
+                {
+                    std::lock_guard<std::mutex> lock{futuresMutex};
+                    futures.push_back(std::move(future));
+                }
+                if (0 == i % 50) std::this_thread::sleep_for(std::chrono::milliseconds{3});
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    queue.wait();
+    size_t pendingCount = 0;
+    for (const auto& future : futures) {
+        pendingCount += !isReady(future);
+    }
+    CHECK(0 == pendingCount);
+    // Each batch holds at most 143 uploads of 7 bytes.
+    CHECK(queue.batchCount() >= THREAD_CNT * UPLOAD_CNT / 143);
+    // Flushing right after recording must never hang.
+    size_t hangCount = 0;
+    for (int i = 0; i < 1000; ++i) {
+        queue.upload([]() { return uint64_t{1}; });
+        hangCount += !isReady(queue.flush(), std::chrono::milliseconds{5000});
+    }
+    CHECK(0 == hangCount);
+    // Destroying the queue completes the outstanding uploads.
+    const std::future<void> last = queue.upload([]() { return uint64_t{1}; });
+    queue = UploadQueue{};
+    CHECK(isReady(last));
+}
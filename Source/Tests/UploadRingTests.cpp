@@ -0,0 +1,103 @@
+#include <algorithm>
+#include <random>
+#include <thread>
+#include "Test.h"
+#include "..\Common\UploadRing.h"
+
+// Chunk reserved by the test, and the fence value of the segment which contains it.
+struct Chunk {
+    uint64_t offset;
+    uint64_t size;
+    uint64_t fenceValue;
+};
+
+// Simulates the GPU with a fence which lags behind the CPU by a random number of segments.
+// Checks that live chunks never overlap, and that the space is eventually reclaimed.
+TEST(uploadRingSimulatedFence) {
+    UploadRing ring{1 << 16};
+    std::mt19937 rng{1};
+    std::vector<Chunk> liveChunks, openChunks;
+    uint64_t fenceValue = 0, completedFenceValue = 0;
+    // Closes the current segment.
+    auto closeSegment = [&]() {
+        ring.closeSegment(++fenceValue);
+        for (Chunk& chunk : openChunks) {
+            chunk.fenceValue = fenceValue;
+            liveChunks.push_back(chunk);
+        }
+        openChunks.clear();
+    };
+    // Advances the simulated fence.
+    auto complete = [&](const uint64_t value) {
+        completedFenceValue = value;
+        ring.reclaim(completedFenceValue);
+        liveChunks.erase(std::remove_if(liveChunks.begin(), liveChunks.end(),
+                                        [&](const Chunk& chunk) {
+                                            return chunk.fenceValue <= completedFenceValue;
+                                        }), liveChunks.end());
+    };
+    uint64_t overlapCount = 0, misplacedCount = 0;
+    for (int i = 0; i < 200000; ++i) {
+        const uint64_t size = 1 + rng() % 9000, alignment = uint64_t{1} << (rng() % 10);
+        uint64_t offset, waitFenceValue;
+        while (!ring.reserve(size, alignment, offset, waitFenceValue)) {
+            if (0 == waitFenceValue) {
+                closeSegment();
+            } else {
+                CHECK(waitFenceValue > completedFenceValue && waitFenceValue <= fenceValue);
+                complete(waitFenceValue);
+            }
+        }
+        misplacedCount += (0 != offset % alignment) || (offset + size > ring.capacity());
+        for (const std::vector<Chunk>* chunks : {&liveChunks, &openChunks}) {
+            for (const Chunk& chunk : *chunks) {
+                overlapCount += offset < chunk.offset + chunk.size &&
+                                chunk.offset < offset + size;
+            }
+        }
+        openChunks.push_back(Chunk{offset, size, 0});
+        if (0 == rng() % 8) closeSegment();
+        if (0 == rng() % 5 && completedFenceValue < fenceValue) complete(completedFenceValue + 1);
+    }
+    CHECK(0 == misplacedCount);
+    CHECK(0 == overlapCount);
+    CHECK(0 != ring.stallCount());
+    // Once the GPU catches up, only the current segment remains in use.
+    closeSegment();
+    complete(fenceValue);
+    CHECK(0 == ring.usedSize());
+}
+
+// Concurrent reservations from multiple threads must not overlap.
+TEST(uploadRingConcurrentReserve) {
+    constexpr size_t   THREAD_CNT = 4;
+    constexpr uint64_t CHUNK_SIZE = 1000;
+    UploadRing ring{1 << 24};
+    std::vector<std::vector<uint64_t>> offsets(THREAD_CNT);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < THREAD_CNT; ++t) {
+        threads.emplace_back([&ring, &offsets, t]() {
+            for (int i = 0; i < 1000; ++i) {
+                uint64_t offset, waitFenceValue;
+                if (ring.reserve(CHUNK_SIZE, 256, offset, waitFenceValue)) {
+                    offsets[t].push_back(offset);
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    std::vector<uint64_t> allOffsets;
+    for (const auto& threadOffsets : offsets) {
+        allOffsets.insert(allOffsets.end(), threadOffsets.begin(), threadOffsets.end());
+    }
+    std::sort(allOffsets.begin(), allOffsets.end());
+    size_t overlapCount = 0;
+    for (size_t i = 1; i < allOffsets.size(); ++i) {
+        overlapCount += allOffsets[i] < allOffsets[i - 1] + CHUNK_SIZE;
+    }
+    CHECK(0 == overlapCount);
+    // 4000 chunks of 1024 bytes (with the alignment) fit into the buffer.
+    CHECK(THREAD_CNT * 1000 == allOffsets.size());
+}
@@ -60,6 +60,8 @@ enum BC_FLAGS
     BC_FLAGS_DITHER_A   = 0x20000,  // Enables dithering for Alpha channel for BC1-3
     BC_FLAGS_UNIFORM    = 0x40000,  // By default, uses perceptual weighting for BC1-3; this flag makes it a uniform weighting
     BC_FLAGS_USE_3SUBSETS = 0x80000,// By default, BC7 skips mode 0 & 2; this flag adds those modes back
+    BC_FLAGS_FAST       = 0x100000, // Uses the fast BC7 preset: subsets of the modes, preselected partitions, and least-squares endpoints
+    BC_FLAGS_BC7_QUICK  = 0x200000, // Uses the fastest BC7 preset, which only tries mode 6
 };
 
 //-------------------------------------------------------------------------------------
@@ -624,7 +626,7 @@ class D3DX_BC7 : private CBits< 16 >
 {
 public:
     void Decode(_Out_writes_(NUM_PIXELS_PER_BLOCK) HDRColorA* pOut) const;
-    void Encode(bool skip3subsets, _In_reads_(NUM_PIXELS_PER_BLOCK) const HDRColorA* const pIn);
+    void Encode(_In_ DWORD flags, _In_reads_(NUM_PIXELS_PER_BLOCK) const HDRColorA* const pIn);
 
 private:
     struct ModeInfo
@@ -640,6 +642,13 @@ private:
         LDRColorA RGBAPrecWithP;
     };
 
+    struct Preset
+    {
+        uint8_t uOpaqueModes;
+        uint8_t uAlphaModes;
+        uint8_t uShapes;
+    };
+
 #pragma warning(push)
 #pragma warning(disable : 4512)
     struct EncodeParams
@@ -717,8 +726,19 @@ private:
                     _In_ const LDREndPntPair& endPts, _In_ float fMinErr) const;
     static float RoughMSE(_Inout_ EncodeParams* pEP, _In_ size_t uShape, _In_ size_t uIndexMode);
 
+    void EncodeFast(_In_ DWORD flags, _In_reads_(NUM_PIXELS_PER_BLOCK) const HDRColorA* const pIn);
+    static void RankShapes(_In_ const EncodeParams* pEP, _In_ size_t uItems, _Out_writes_(BC7_MAX_SHAPES) size_t auShape[]);
+    static void FitEndPoints(_Inout_ EncodeParams* pEP, _In_ size_t uShape);
+    void FitEndPointsLS(_In_ const EncodeParams* pEP, _In_ size_t uShape,
+                        _In_reads_(BC7_MAX_REGIONS) const LDREndPntPair aOrgEndPts[],
+                        _In_reads_(NUM_PIXELS_PER_BLOCK) const size_t aIndices[],
+                        _In_reads_(NUM_PIXELS_PER_BLOCK) const size_t aIndices2[],
+                        _Out_writes_(BC7_MAX_REGIONS) LDREndPntPair aOptEndPts[]) const;
+    float RefineFast(_In_ const EncodeParams* pEP, _In_ size_t uShape);
+
 private:
     const static ModeInfo ms_aInfo[];
+    const static Preset ms_aPresets[];
 };
 
 //-------------------------------------------------------------------------------------
@@ -888,4 +908,14 @@ void D3DXEncodeBC6HU(_Out_writes_(16) uint8_t *pBC, _In_reads_(NUM_PIXELS_PER_BL
 void D3DXEncodeBC6HS(_Out_writes_(16) uint8_t *pBC, _In_reads_(NUM_PIXELS_PER_BLOCK) const XMVECTOR *pColor, _In_ DWORD flags);
 void D3DXEncodeBC7(_Out_writes_(16) uint8_t *pBC, _In_reads_(NUM_PIXELS_PER_BLOCK) const XMVECTOR *pColor, _In_ DWORD flags);
 
+// Fast (range fit) encoders of 8-bit RGBA texels (R in the least significant byte); see BCFast.cpp
+typedef void (*BC_ENCODE_FAST)(uint8_t *pBC, const uint32_t *pColor);
+
+void D3DXEncodeBC1Fast(_Out_writes_(8) uint8_t *pBC, _In_reads_(NUM_PIXELS_PER_BLOCK) const uint32_t *pColor, _In_ float alphaRef, _In_ DWORD flags);
+    // Blocks with texels below the alpha reference are delegated to D3DXEncodeBC1
+
+void D3DXEncodeBC3Fast(_Out_writes_(16) uint8_t *pBC, _In_reads_(NUM_PIXELS_PER_BLOCK) const uint32_t *pColor);
+void D3DXEncodeBC4UFast(_Out_writes_(8) uint8_t *pBC, _In_reads_(NUM_PIXELS_PER_BLOCK) const uint32_t *pColor);
+void D3DXEncodeBC5UFast(_Out_writes_(16) uint8_t *pBC, _In_reads_(NUM_PIXELS_PER_BLOCK) const uint32_t *pColor);
+
 }; // namespace
@@ -554,6 +554,15 @@ const D3DX_BC7::ModeInfo D3DX_BC7::ms_aInfo[] =
         // Mode 7: Color+Alpha, 2 Subsets, RGBAP 55551 (unique P-bit), 2-bit indices, 64 partitions
 };
 
+// BC7 fast compression: uOpaqueModes, uAlphaModes (bit masks of the modes to try), uShapes (partitions refined per mode)
+const D3DX_BC7::Preset D3DX_BC7::ms_aPresets[] =
+{
+    {0x40, 0x40, 1},
+        // BC_FLAGS_BC7_QUICK: Mode 6
+    {0x4A, 0xE0, 4},
+        // BC_FLAGS_FAST: Modes 1, 3, 6 for opaque blocks, modes 5, 6, 7 for blocks with alpha
+};
+
 
 //-------------------------------------------------------------------------------------
 // Helper functions
@@ -979,6 +988,82 @@ static float OptimizeRGBA(_In_reads_(NUM_PIXELS_PER_BLOCK) const HDRColorA* cons
 }
 
 
+//-------------------------------------------------------------------------------------
+// Sums of the colors, and of their products: the squares (rr, gg, bb, aa), and the cross terms (rg, gb, ba, ar) and (rb, ga)
+struct ColorMoments
+{
+    XMVECTOR vSum;
+    XMVECTOR vDiag;
+    XMVECTOR vOff1;
+    XMVECTOR vOff2;
+};
+
+inline static void AddMoments(_Inout_ ColorMoments& m, _In_ FXMVECTOR v)
+{
+    m.vSum = XMVectorAdd(m.vSum, v);
+    m.vDiag = XMVectorMultiplyAdd(v, v, m.vDiag);
+    m.vOff1 = XMVectorMultiplyAdd(v, XMVectorSwizzle<1, 2, 3, 0>(v), m.vOff1);
+    m.vOff2 = XMVectorMultiplyAdd(v, XMVectorSwizzle<2, 3, 0, 1>(v), m.vOff2);
+}
+
+// Finds the principal axis of the colors (using power iterations).
+// Returns the squared error of the projection of the colors onto the axis.
+static float FitPrincipalAxis(_In_ const ColorMoments& m, _In_ size_t np, _Out_writes_(4) float* pAxis)
+{
+    assert( np > 0 );
+
+    // Compute the scatter matrix
+    const XMVECTOR vMean = XMVectorScale(m.vSum, 1.0f / float(np));
+    XMFLOAT4 d, o1, o2;
+    XMStoreFloat4(&d, XMVectorSubtract(m.vDiag, XMVectorMultiply(m.vSum, vMean)));
+    XMStoreFloat4(&o1, XMVectorSubtract(m.vOff1, XMVectorMultiply(m.vSum, XMVectorSwizzle<1, 2, 3, 0>(vMean))));
+    XMStoreFloat4(&o2, XMVectorSubtract(m.vOff2, XMVectorMultiply(m.vSum, XMVectorSwizzle<2, 3, 0, 1>(vMean))));
+    const float C[4][4] =
+    {
+        { d.x,  o1.x, o2.x, o1.w },
+        { o1.x, d.y,  o1.y, o2.y },
+        { o2.x, o1.y, d.z,  o1.z },
+        { o1.w, o2.y, o1.z, d.w  },
+    };
+
+    // Start with the column of the channel with the largest variance
+    size_t k = 0;
+    for(size_t ch = 1; ch < 4; ++ch)
+    {
+        if(C[ch][ch] > C[k][k])
+            k = ch;
+    }
+
+    float v[4] = { C[0][k], C[1][k], C[2][k], C[3][k] };
+    float fLambda = 0.0f;
+    for(size_t iter = 0; iter < 4; ++iter)
+    {
+        float w[4];
+        for(size_t ch = 0; ch < 4; ++ch)
+            w[ch] = C[ch][0] * v[0] + C[ch][1] * v[1] + C[ch][2] * v[2] + C[ch][3] * v[3];
+
+        // Rayleigh quotient of the current estimate
+        const float fLength2 = v[0] * v[0] + v[1] * v[1] + v[2] * v[2] + v[3] * v[3];
+        if(fLength2 < fEpsilon)
+            break;
+        fLambda = (v[0] * w[0] + v[1] * w[1] + v[2] * w[2] + v[3] * w[3]) / fLength2;
+
+        const float fMax = std::max(std::max(fabsf(w[0]), fabsf(w[1])), std::max(fabsf(w[2]), fabsf(w[3])));
+        if(fMax < fEpsilon)
+            break;
+        for(size_t ch = 0; ch < 4; ++ch)
+            v[ch] = w[ch] / fMax;
+    }
+
+    const float fLength2 = v[0] * v[0] + v[1] * v[1] + v[2] * v[2] + v[3] * v[3];
+    const float fScale = (fLength2 < fEpsilon) ? 0.0f : 1.0f / sqrtf(fLength2);
+    for(size_t ch = 0; ch < 4; ++ch)
+        pAxis[ch] = v[ch] * fScale;
+
+    return std::max(0.0f, d.x + d.y + d.z + d.w - fLambda);
+}
+
+
 //-------------------------------------------------------------------------------------
 
 static float ComputeError(_Inout_ const LDRColorA& pixel, _In_reads_(1 << uIndexPrec) const LDRColorA aPalette[],
@@ -2143,10 +2228,17 @@ void D3DX_BC7::Decode(HDRColorA* pOut) const
 }
 
 _Use_decl_annotations_
-void D3DX_BC7::Encode(bool skip3subsets, const HDRColorA* const pIn)
+void D3DX_BC7::Encode(DWORD flags, const HDRColorA* const pIn)
 {
     assert( pIn );
 
+    if(flags & (BC_FLAGS_FAST | BC_FLAGS_BC7_QUICK))
+    {
+        EncodeFast(flags, pIn);
+        return;
+    }
+
+    const bool skip3subsets = !(flags & BC_FLAGS_USE_3SUBSETS);
     D3DX_BC7 final = *this;
     EncodeParams EP(pIn);
     float fMSEBest = FLT_MAX;
@@ -2234,6 +2326,310 @@ void D3DX_BC7::Encode(bool skip3subsets, const HDRColorA* const pIn)
 }
 
 
+_Use_decl_annotations_
+void D3DX_BC7::EncodeFast(DWORD flags, const HDRColorA* const pIn)
+{
+    assert( pIn );
+
+    const Preset& preset = ms_aPresets[(flags & BC_FLAGS_BC7_QUICK) ? 0 : 1];
+    D3DX_BC7 final = *this;
+    EncodeParams EP(pIn);
+    float fMSEBest = FLT_MAX;
+
+    bool bOpaque = true;
+    bool bSolid = true;
+    for(size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
+    {
+        EP.aLDRPixels[i].r = uint8_t( std::max<float>( 0.0f, std::min<float>( 255.0f, pIn[i].r * 255.0f + 0.01f ) ) );
+        EP.aLDRPixels[i].g = uint8_t( std::max<float>( 0.0f, std::min<float>( 255.0f, pIn[i].g * 255.0f + 0.01f ) ) );
+        EP.aLDRPixels[i].b = uint8_t( std::max<float>( 0.0f, std::min<float>( 255.0f, pIn[i].b * 255.0f + 0.01f ) ) );
+        EP.aLDRPixels[i].a = uint8_t( std::max<float>( 0.0f, std::min<float>( 255.0f, pIn[i].a * 255.0f + 0.01f ) ) );
+        bOpaque = bOpaque && (EP.aLDRPixels[i].a == 255);
+        bSolid = bSolid && (memcmp(&EP.aLDRPixels[i], &EP.aLDRPixels[0], sizeof(LDRColorA)) == 0);
+    }
+
+    // Modes with an alpha channel are of no use for opaque blocks, and a single color is best represented
+    // by the mode with the highest precision
+    const size_t uModes = bSolid ? 0x40 : (bOpaque ? preset.uOpaqueModes : preset.uAlphaModes);
+
+    for(EP.uMode = 0; EP.uMode < 8 && fMSEBest > 0; ++EP.uMode)
+    {
+        if(!(uModes & (size_t(1) << EP.uMode)))
+            continue;
+
+        const size_t uShapes = size_t(1) << ms_aInfo[EP.uMode].uPartitionBits;
+        assert( uShapes <= BC7_MAX_SHAPES );
+        _Analysis_assume_( uShapes <= BC7_MAX_SHAPES );
+
+        // Refine the partitions which fit the colors best
+        const size_t uItems = std::min<size_t>(uShapes, preset.uShapes);
+        size_t auShape[BC7_MAX_SHAPES];
+        RankShapes(&EP, uItems, auShape);
+
+        for(size_t i = 0; i < uItems && fMSEBest > 0; i++)
+        {
+            FitEndPoints(&EP, auShape[i]);
+            float fMSE = RefineFast(&EP, auShape[i]);
+            if(fMSE < fMSEBest)
+            {
+                final = *this;
+                fMSEBest = fMSE;
+            }
+        }
+    }
+
+    *this = final;
+}
+
+_Use_decl_annotations_
+void D3DX_BC7::RankShapes(const EncodeParams* pEP, size_t uItems, size_t auShape[])
+{
+    assert( pEP );
+    const uint8_t uPartitions = ms_aInfo[pEP->uMode].uPartitions;
+    assert( uPartitions < BC7_MAX_REGIONS );
+    _Analysis_assume_( uPartitions < BC7_MAX_REGIONS );
+
+    const size_t uShapes = size_t(1) << ms_aInfo[pEP->uMode].uPartitionBits;
+    for(size_t s = 0; s < uShapes; s++)
+        auShape[s] = s;
+
+    if(uItems >= uShapes)
+        return;
+
+    ColorMoments aPixels[NUM_PIXELS_PER_BLOCK];
+    ColorMoments total = { XMVectorZero(), XMVectorZero(), XMVectorZero(), XMVectorZero() };
+    for(size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
+    {
+        const XMVECTOR v = XMLoadUByte4( reinterpret_cast<const XMUBYTE4*>( &pEP->aLDRPixels[i] ) );
+        aPixels[i].vSum = v;
+        aPixels[i].vDiag = XMVectorMultiply(v, v);
+        aPixels[i].vOff1 = XMVectorMultiply(v, XMVectorSwizzle<1, 2, 3, 0>(v));
+        aPixels[i].vOff2 = XMVectorMultiply(v, XMVectorSwizzle<2, 3, 0, 1>(v));
+        AddMoments(total, v);
+    }
+
+    // Estimate the error of each partition by the distance of the colors to the principal axes of the subsets.
+    // The moments of the last subset are the remainder of the moments of the block.
+    float afError[BC7_MAX_SHAPES];
+    for(size_t s = 0; s < uShapes; s++)
+    {
+        ColorMoments aSubsets[BC7_MAX_REGIONS];
+        size_t anp[BC7_MAX_REGIONS] = {};
+        for(size_t p = 0; p < uPartitions; p++)
+            aSubsets[p].vSum = aSubsets[p].vDiag = aSubsets[p].vOff1 = aSubsets[p].vOff2 = XMVectorZero();
+
+        for(register size_t i = 0; i < NUM_PIXELS_PER_BLOCK; i++)
+        {
+            const uint8_t p = g_aPartitionTable[uPartitions][s][i];
+            if(p < uPartitions)
+            {
+                aSubsets[p].vSum = XMVectorAdd(aSubsets[p].vSum, aPixels[i].vSum);
+                aSubsets[p].vDiag = XMVectorAdd(aSubsets[p].vDiag, aPixels[i].vDiag);
+                aSubsets[p].vOff1 = XMVectorAdd(aSubsets[p].vOff1, aPixels[i].vOff1);
+                aSubsets[p].vOff2 = XMVectorAdd(aSubsets[p].vOff2, aPixels[i].vOff2);
+            }
+            anp[p]++;
+        }
+
+        aSubsets[uPartitions] = total;
+        for(size_t p = 0; p < uPartitions; p++)
+        {
+            aSubsets[uPartitions].vSum = XMVectorSubtract(aSubsets[uPartitions].vSum, aSubsets[p].vSum);
+            aSubsets[uPartitions].vDiag = XMVectorSubtract(aSubsets[uPartitions].vDiag, aSubsets[p].vDiag);
+            aSubsets[uPartitions].vOff1 = XMVectorSubtract(aSubsets[uPartitions].vOff1, aSubsets[p].vOff1);
+            aSubsets[uPartitions].vOff2 = XMVectorSubtract(aSubsets[uPartitions].vOff2, aSubsets[p].vOff2);
+        }
+
+        afError[s] = 0;
+        for(size_t p = 0; p <= uPartitions; p++)
+        {
+            float afAxis[4];
+            afError[s] += FitPrincipalAxis(aSubsets[p], anp[p], afAxis);
+        }
+    }
+
+    // Bubble up the first uItems items
+    for(size_t i = 0; i < uItems; i++)
+    {
+        for(size_t j = i + 1; j < uShapes; j++)
+        {
+            if(afError[i] > afError[j])
+            {
+                std::swap(afError[i], afError[j]);
+                std::swap(auShape[i], auShape[j]);
+            }
+        }
+    }
+}
+
+_Use_decl_annotations_
+void D3DX_BC7::FitEndPoints(EncodeParams* pEP, size_t uShape)
+{
+    assert( pEP );
+    assert( uShape < BC7_MAX_SHAPES );
+    _Analysis_assume_( uShape < BC7_MAX_SHAPES );
+    LDREndPntPair* aEndPts = pEP->aEndPts[uShape];
+
+    const uint8_t uPartitions = ms_aInfo[pEP->uMode].uPartitions;
+    assert( uPartitions < BC7_MAX_REGIONS );
+    _Analysis_assume_( uPartitions < BC7_MAX_REGIONS );
+
+    // With separate alpha indices, the axis spans the colors, and the alpha range is fit independently
+    const bool bSeparateAlpha = ms_aInfo[pEP->uMode].uIndexPrec2 != 0;
+
+    XMVECTOR aColors[NUM_PIXELS_PER_BLOCK];
+    for(size_t p = 0; p <= uPartitions; p++)
+    {
+        size_t np = 0;
+        uint8_t uMinAlpha = 255, uMaxAlpha = 0;
+        ColorMoments m = { XMVectorZero(), XMVectorZero(), XMVectorZero(), XMVectorZero() };
+        for(register size_t i = 0; i < NUM_PIXELS_PER_BLOCK; i++)
+        {
+            if(g_aPartitionTable[uPartitions][uShape][i] == p)
+            {
+                XMVECTOR v = XMLoadUByte4( reinterpret_cast<const XMUBYTE4*>( &pEP->aLDRPixels[i] ) );
+                aColors[np] = bSeparateAlpha ? XMVectorAndInt(v, g_XMMask3) : v;
+                AddMoments(m, aColors[np++]);
+                uMinAlpha = std::min<uint8_t>(uMinAlpha, pEP->aLDRPixels[i].a);
+                uMaxAlpha = std::max<uint8_t>(uMaxAlpha, pEP->aLDRPixels[i].a);
+            }
+        }
+
+        // Fit the range of the projections of the colors onto the principal axis
+        float afAxis[4];
+        FitPrincipalAxis(m, np, afAxis);
+        const XMVECTOR vMean = XMVectorScale(m.vSum, 1.0f / float(np));
+        const XMVECTOR vAxis = XMVectorSet(afAxis[0], afAxis[1], afAxis[2], afAxis[3]);
+
+        float fMin = FLT_MAX, fMax = -FLT_MAX;
+        for(size_t i = 0; i < np; i++)
+        {
+            const float t = XMVectorGetX(XMVector4Dot(XMVectorSubtract(aColors[i], vMean), vAxis));
+            fMin = std::min(fMin, t);
+            fMax = std::max(fMax, t);
+        }
+
+        XMStoreUByte4( reinterpret_cast<XMUBYTE4*>( &aEndPts[p].A ), XMVectorMultiplyAdd(vAxis, XMVectorReplicate(fMin), vMean) );
+        XMStoreUByte4( reinterpret_cast<XMUBYTE4*>( &aEndPts[p].B ), XMVectorMultiplyAdd(vAxis, XMVectorReplicate(fMax), vMean) );
+        if(bSeparateAlpha)
+        {
+            aEndPts[p].A.a = uMinAlpha;
+            aEndPts[p].B.a = uMaxAlpha;
+        }
+    }
+}
+
+_Use_decl_annotations_
+void D3DX_BC7::FitEndPointsLS(const EncodeParams* pEP, size_t uShape, const LDREndPntPair aOrgEndPts[],
+                              const size_t aIndices[], const size_t aIndices2[], LDREndPntPair aOptEndPts[]) const
+{
+    assert( pEP );
+    assert( uShape < BC7_MAX_SHAPES );
+    _Analysis_assume_( uShape < BC7_MAX_SHAPES );
+
+    const ModeInfo& info = ms_aInfo[pEP->uMode];
+    const uint8_t uPartitions = info.uPartitions;
+    assert( uPartitions < BC7_MAX_REGIONS );
+    _Analysis_assume_( uPartitions < BC7_MAX_REGIONS );
+
+    // Alpha uses the second set of indices (if present)
+    const int* aWeights = (info.uIndexPrec == 2) ? g_aWeights2 : ((info.uIndexPrec == 3) ? g_aWeights3 : g_aWeights4);
+    const int* aWeights2 = (info.uIndexPrec2 == 0) ? aWeights : ((info.uIndexPrec2 == 2) ? g_aWeights2 : g_aWeights3);
+    const size_t* aAlphaIndices = (info.uIndexPrec2 == 0) ? aIndices : aIndices2;
+
+    const XMVECTOR vOne = XMVectorSplatOne();
+    const XMVECTOR vScale = XMVectorReplicate(1.0f / 64.0f);
+    for(size_t p = 0; p <= uPartitions; p++)
+    {
+        // Solve the least-squares problem for each channel in parallel
+        XMVECTOR vAA = XMVectorZero(), vAB = XMVectorZero(), vBB = XMVectorZero();
+        XMVECTOR vAX = XMVectorZero(), vBX = XMVectorZero();
+        for(register size_t i = 0; i < NUM_PIXELS_PER_BLOCK; i++)
+        {
+            if(g_aPartitionTable[uPartitions][uShape][i] != p)
+                continue;
+
+            const float w = float(aWeights[aIndices[i]]);
+            const XMVECTOR vB = XMVectorMultiply(XMVectorSet(w, w, w, float(aWeights2[aAlphaIndices[i]])), vScale);
+            const XMVECTOR vA = XMVectorSubtract(vOne, vB);
+            const XMVECTOR vX = XMLoadUByte4( reinterpret_cast<const XMUBYTE4*>( &pEP->aLDRPixels[i] ) );
+            vAA = XMVectorMultiplyAdd(vA, vA, vAA);
+            vAB = XMVectorMultiplyAdd(vA, vB, vAB);
+            vBB = XMVectorMultiplyAdd(vB, vB, vBB);
+            vAX = XMVectorMultiplyAdd(vA, vX, vAX);
+            vBX = XMVectorMultiplyAdd(vB, vX, vBX);
+        }
+
+        const XMVECTOR vDet = XMVectorSubtract(XMVectorMultiply(vAA, vBB), XMVectorMultiply(vAB, vAB));
+        XMVECTOR vEndPtA = XMVectorDivide(XMVectorSubtract(XMVectorMultiply(vAX, vBB), XMVectorMultiply(vBX, vAB)), vDet);
+        XMVECTOR vEndPtB = XMVectorDivide(XMVectorSubtract(XMVectorMultiply(vBX, vAA), XMVectorMultiply(vAX, vAB)), vDet);
+
+        // Keep the original endpoints of the channels which use a single index
+        const XMVECTOR vSolved = XMVectorGreater(vDet, XMVectorReplicate(fEpsilon));
+        const LDRColorA orgA = Unquantize(aOrgEndPts[p].A, info.RGBAPrecWithP);
+        const LDRColorA orgB = Unquantize(aOrgEndPts[p].B, info.RGBAPrecWithP);
+        vEndPtA = XMVectorSelect(XMLoadUByte4( reinterpret_cast<const XMUBYTE4*>( &orgA ) ), vEndPtA, vSolved);
+        vEndPtB = XMVectorSelect(XMLoadUByte4( reinterpret_cast<const XMUBYTE4*>( &orgB ) ), vEndPtB, vSolved);
+
+        LDRColorA a, b;
+        XMStoreUByte4( reinterpret_cast<XMUBYTE4*>( &a ), vEndPtA );
+        XMStoreUByte4( reinterpret_cast<XMUBYTE4*>( &b ), vEndPtB );
+        aOptEndPts[p].A = Quantize(a, info.RGBAPrecWithP);
+        aOptEndPts[p].B = Quantize(b, info.RGBAPrecWithP);
+    }
+}
+
+_Use_decl_annotations_
+float D3DX_BC7::RefineFast(const EncodeParams* pEP, size_t uShape)
+{
+    assert( pEP );
+    assert( uShape < BC7_MAX_SHAPES );
+    _Analysis_assume_( uShape < BC7_MAX_SHAPES );
+    const LDREndPntPair* aEndPts = pEP->aEndPts[uShape];
+
+    const size_t uPartitions = ms_aInfo[pEP->uMode].uPartitions;
+    assert( uPartitions < BC7_MAX_REGIONS );
+    _Analysis_assume_( uPartitions < BC7_MAX_REGIONS );
+
+    LDREndPntPair aOrgEndPts[BC7_MAX_REGIONS];
+    LDREndPntPair aOptEndPts[BC7_MAX_REGIONS];
+    size_t aOrgIdx[NUM_PIXELS_PER_BLOCK];
+    size_t aOrgIdx2[NUM_PIXELS_PER_BLOCK];
+    size_t aOptIdx[NUM_PIXELS_PER_BLOCK];
+    size_t aOptIdx2[NUM_PIXELS_PER_BLOCK];
+    float aOrgErr[BC7_MAX_REGIONS];
+    float aOptErr[BC7_MAX_REGIONS];
+
+    for(register size_t p = 0; p <= uPartitions; p++)
+    {
+        aOrgEndPts[p].A = Quantize(aEndPts[p].A, ms_aInfo[pEP->uMode].RGBAPrecWithP);
+        aOrgEndPts[p].B = Quantize(aEndPts[p].B, ms_aInfo[pEP->uMode].RGBAPrecWithP);
+    }
+
+    // Replace the perturbation search of Refine() by a single least-squares step
+    AssignIndices(pEP, uShape, 0, aOrgEndPts, aOrgIdx, aOrgIdx2, aOrgErr);
+    FitEndPointsLS(pEP, uShape, aOrgEndPts, aOrgIdx, aOrgIdx2, aOptEndPts);
+    AssignIndices(pEP, uShape, 0, aOptEndPts, aOptIdx, aOptIdx2, aOptErr);
+
+    float fOrgTotErr = 0, fOptTotErr = 0;
+    for(register size_t p = 0; p <= uPartitions; p++)
+    {
+        fOrgTotErr += aOrgErr[p];
+        fOptTotErr += aOptErr[p];
+    }
+    if(fOptTotErr < fOrgTotErr)
+    {
+        EmitBlock(pEP, uShape, 0, 0, aOptEndPts, aOptIdx, aOptIdx2);
+        return fOptTotErr;
+    }
+    else
+    {
+        EmitBlock(pEP, uShape, 0, 0, aOrgEndPts, aOrgIdx, aOrgIdx2);
+        return fOrgTotErr;
+    }
+}
+
+
 //-------------------------------------------------------------------------------------
 _Use_decl_annotations_
 void D3DX_BC7::GeneratePaletteQuantized(const EncodeParams* pEP, size_t uIndexMode, const LDREndPntPair& endPts, LDRColorA aPalette[]) const
@@ -2868,7 +3264,7 @@ void D3DXEncodeBC7(uint8_t *pBC, const XMVECTOR *pColor, DWORD flags)
 {
     assert( pBC && pColor );
     static_assert( sizeof(D3DX_BC7) == 16, "D3DX_BC7 should be 16 bytes" );
-    reinterpret_cast< D3DX_BC7* >( pBC )->Encode( !(flags& BC_FLAGS_USE_3SUBSETS), reinterpret_cast<const HDRColorA*>(pColor));
+    reinterpret_cast< D3DX_BC7* >( pBC )->Encode( flags, reinterpret_cast<const HDRColorA*>(pColor));
 }
 
 } // namespace
@@ -0,0 +1,512 @@
+//-------------------------------------------------------------------------------------
+// BCFast.cpp
+//
+// Fast block-compression (BC) encoders for BC1, BC3, BC4 and BC5
+//
+// THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A
+// PARTICULAR PURPOSE.
+//
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// http://go.microsoft.com/fwlink/?LinkId=248926
+//-------------------------------------------------------------------------------------
+
+#include "directxtexp.h"
+
+#include "BC.h"
+
+#include <smmintrin.h>
+
+using namespace DirectX::PackedVector;
+
+namespace DirectX
+{
+
+//-------------------------------------------------------------------------------------
+// Constants
+//-------------------------------------------------------------------------------------
+
+// Number of power iterations used to find the principal axis of the block colors
+static const int POWER_ITERATIONS = 4;
+
+//-------------------------------------------------------------------------------------
+// Helpers
+//
+// The encoders operate on 8-bit RGBA texels (with R in the least significant byte).
+// A block of 16 texels is held in 4 registers of 4 texels each; the color channels are
+// unpacked into separate registers (structure of arrays), so that all SIMD lanes do useful
+// work. Endpoints are chosen by range fitting along the principal axis of the colors,
+// followed by a least-squares refinement, and indices by projecting onto the endpoint axis.
+//-------------------------------------------------------------------------------------
+namespace
+{
+    template<int shift>
+    inline __m128 _ExtractChannel( _In_ __m128i texels )
+    {
+        return _mm_cvtepi32_ps( _mm_and_si128( _mm_srli_epi32( texels, shift ), _mm_set1_epi32( 0xFF ) ) );
+    }
+
+    inline float _HorizontalSum( _In_ __m128 v )
+    {
+        v = _mm_add_ps( v, _mm_movehl_ps( v, v ) );
+        v = _mm_add_ss( v, _mm_shuffle_ps( v, v, 1 ) );
+        return _mm_cvtss_f32( v );
+    }
+
+    inline float _HorizontalMin( _In_ __m128 v )
+    {
+        v = _mm_min_ps( v, _mm_movehl_ps( v, v ) );
+        v = _mm_min_ss( v, _mm_shuffle_ps( v, v, 1 ) );
+        return _mm_cvtss_f32( v );
+    }
+
+    inline float _HorizontalMax( _In_ __m128 v )
+    {
+        v = _mm_max_ps( v, _mm_movehl_ps( v, v ) );
+        v = _mm_max_ss( v, _mm_shuffle_ps( v, v, 1 ) );
+        return _mm_cvtss_f32( v );
+    }
+
+    inline __m128i _HorizontalMinU8( _In_ __m128i v )
+    {
+        v = _mm_min_epu8( v, _mm_shuffle_epi32( v, _MM_SHUFFLE( 1, 0, 3, 2 ) ) );
+        v = _mm_min_epu8( v, _mm_shuffle_epi32( v, _MM_SHUFFLE( 2, 3, 0, 1 ) ) );
+        v = _mm_min_epu8( v, _mm_srli_epi32( v, 16 ) );
+        return _mm_min_epu8( v, _mm_srli_epi16( v, 8 ) );
+    }
+
+    inline __m128i _HorizontalMaxU8( _In_ __m128i v )
+    {
+        v = _mm_max_epu8( v, _mm_shuffle_epi32( v, _MM_SHUFFLE( 1, 0, 3, 2 ) ) );
+        v = _mm_max_epu8( v, _mm_shuffle_epi32( v, _MM_SHUFFLE( 2, 3, 0, 1 ) ) );
+        v = _mm_max_epu8( v, _mm_srli_epi32( v, 16 ) );
+        return _mm_max_epu8( v, _mm_srli_epi16( v, 8 ) );
+    }
+
+    // Packs 16 values (one per 32-bit lane of 4 registers) into bytes
+    inline __m128i _PackBytes( _In_reads_(4) const __m128i* v )
+    {
+        return _mm_packus_epi16( _mm_packus_epi32( v[0], v[1] ), _mm_packus_epi32( v[2], v[3] ) );
+    }
+
+    // Block texels in the structure of arrays layout
+    struct ColorBlock
+    {
+        __m128 r[4];
+        __m128 g[4];
+        __m128 b[4];
+    };
+
+    // Color endpoint quantized to the 5:6:5 format
+    struct Endpoint565
+    {
+        uint16_t    packed;
+        float       rgb[3];     // Expanded to 8 bits per channel
+    };
+
+    inline void _QuantizeEndpoint( _In_reads_(3) const float* color, _Out_ Endpoint565& e )
+    {
+        static const float scale[3] = { 31.f / 255.f, 63.f / 255.f, 31.f / 255.f };
+        static const int maxValue[3] = { 31, 63, 31 };
+
+        int q[3];
+        for( size_t c = 0; c < 3; ++c )
+        {
+            q[c] = std::min( std::max( static_cast<int>( color[c] * scale[c] + 0.5f ), 0 ), maxValue[c] );
+        }
+
+        e.packed = static_cast<uint16_t>( ( q[0] << 11 ) | ( q[1] << 5 ) | q[2] );
+        e.rgb[0] = static_cast<float>( ( q[0] << 3 ) | ( q[0] >> 2 ) );
+        e.rgb[1] = static_cast<float>( ( q[1] << 2 ) | ( q[1] >> 4 ) );
+        e.rgb[2] = static_cast<float>( ( q[2] << 3 ) | ( q[2] >> 2 ) );
+    }
+
+    // Selects the nearest of the 4 colors interpolated between the endpoints for each texel.
+    // Returns the positions along the axis (0..3) and the total squared error.
+    float _FitColorIndices( _In_ const ColorBlock& block, _In_ const Endpoint565& e0, _In_ const Endpoint565& e1, _Out_writes_(4) __m128i* positions )
+    {
+        const float dr = e1.rgb[0] - e0.rgb[0];
+        const float dg = e1.rgb[1] - e0.rgb[1];
+        const float db = e1.rgb[2] - e0.rgb[2];
+        const float dd = dr * dr + dg * dg + db * db;
+
+        const __m128 vdr = _mm_set1_ps( dr );
+        const __m128 vdg = _mm_set1_ps( dg );
+        const __m128 vdb = _mm_set1_ps( db );
+        const __m128 r0 = _mm_set1_ps( e0.rgb[0] );
+        const __m128 g0 = _mm_set1_ps( e0.rgb[1] );
+        const __m128 b0 = _mm_set1_ps( e0.rgb[2] );
+        const __m128 scale = _mm_set1_ps( ( dd > 0.f ) ? 3.f / dd : 0.f );
+        const __m128 third = _mm_set1_ps( 1.f / 3.f );
+
+        __m128 error = _mm_setzero_ps();
+        for( size_t i = 0; i < 4; ++i )
+        {
+            const __m128 pr = _mm_sub_ps( block.r[i], r0 );
+            const __m128 pg = _mm_sub_ps( block.g[i], g0 );
+            const __m128 pb = _mm_sub_ps( block.b[i], b0 );
+
+            // Project onto the axis, and round to the nearest of the 4 colors
+            __m128 t = _mm_add_ps( _mm_add_ps( _mm_mul_ps( pr, vdr ), _mm_mul_ps( pg, vdg ) ), _mm_mul_ps( pb, vdb ) );
+            t = _mm_min_ps( _mm_max_ps( _mm_mul_ps( t, scale ), _mm_setzero_ps() ), _mm_set1_ps( 3.f ) );
+            positions[i] = _mm_cvtps_epi32( t );
+
+            // Accumulate the error of the interpolated color
+            const __m128 f = _mm_mul_ps( _mm_cvtepi32_ps( positions[i] ), third );
+            const __m128 er = _mm_sub_ps( pr, _mm_mul_ps( vdr, f ) );
+            const __m128 eg = _mm_sub_ps( pg, _mm_mul_ps( vdg, f ) );
+            const __m128 eb = _mm_sub_ps( pb, _mm_mul_ps( vdb, f ) );
+            error = _mm_add_ps( error, _mm_add_ps( _mm_add_ps( _mm_mul_ps( er, er ), _mm_mul_ps( eg, eg ) ), _mm_mul_ps( eb, eb ) ) );
+        }
+
+        return _HorizontalSum( error );
+    }
+
+    // Solves for the endpoints which minimize the squared error for the given positions
+    bool _RefineEndpoints( _In_ const ColorBlock& block, _In_reads_(4) const __m128i* positions, _Out_writes_(3) float* c0, _Out_writes_(3) float* c1 )
+    {
+        const __m128 third = _mm_set1_ps( 1.f / 3.f );
+        const __m128 one = _mm_set1_ps( 1.f );
+
+        __m128 aa = _mm_setzero_ps(), ab = _mm_setzero_ps(), bb = _mm_setzero_ps();
+        __m128 ax[3] = { _mm_setzero_ps(), _mm_setzero_ps(), _mm_setzero_ps() };
+        __m128 bx[3] = { _mm_setzero_ps(), _mm_setzero_ps(), _mm_setzero_ps() };
+        for( size_t i = 0; i < 4; ++i )
+        {
+            // Weights of the endpoints
+            const __m128 beta = _mm_mul_ps( _mm_cvtepi32_ps( positions[i] ), third );
+            const __m128 alpha = _mm_sub_ps( one, beta );
+            aa = _mm_add_ps( aa, _mm_mul_ps( alpha, alpha ) );
+            ab = _mm_add_ps( ab, _mm_mul_ps( alpha, beta ) );
+            bb = _mm_add_ps( bb, _mm_mul_ps( beta, beta ) );
+
+            const __m128 channels[3] = { block.r[i], block.g[i], block.b[i] };
+            for( size_t c = 0; c < 3; ++c )
+            {
+                ax[c] = _mm_add_ps( ax[c], _mm_mul_ps( alpha, channels[c] ) );
+                bx[c] = _mm_add_ps( bx[c], _mm_mul_ps( beta, channels[c] ) );
+            }
+        }
+
+        const float saa = _HorizontalSum( aa );
+        const float sab = _HorizontalSum( ab );
+        const float sbb = _HorizontalSum( bb );
+        const float det = saa * sbb - sab * sab;
+        if ( fabsf( det ) < 1e-4f )
+            return false;
+
+        const float invDet = 1.f / det;
+        for( size_t c = 0; c < 3; ++c )
+        {
+            const float sax = _HorizontalSum( ax[c] );
+            const float sbx = _HorizontalSum( bx[c] );
+            c0[c] = std::min( std::max( ( sax * sbb - sbx * sab ) * invDet, 0.f ), 255.f );
+            c1[c] = std::min( std::max( ( sbx * saa - sax * sab ) * invDet, 0.f ), 255.f );
+        }
+        return true;
+    }
+
+    // Encodes the colors of the block in the 4-color mode
+    void _EncodeColorBlock( _Out_ D3DX_BC1* pBC, _In_reads_(4) const __m128i* texels )
+    {
+        ColorBlock block;
+        __m128 sum[3] = { _mm_setzero_ps(), _mm_setzero_ps(), _mm_setzero_ps() };
+        for( size_t i = 0; i < 4; ++i )
+        {
+            block.r[i] = _ExtractChannel<0>( texels[i] );
+            block.g[i] = _ExtractChannel<8>( texels[i] );
+            block.b[i] = _ExtractChannel<16>( texels[i] );
+            sum[0] = _mm_add_ps( sum[0], block.r[i] );
+            sum[1] = _mm_add_ps( sum[1], block.g[i] );
+            sum[2] = _mm_add_ps( sum[2], block.b[i] );
+        }
+
+        float mean[3];
+        for( size_t c = 0; c < 3; ++c )
+        {
+            mean[c] = _HorizontalSum( sum[c] ) * ( 1.f / NUM_PIXELS_PER_BLOCK );
+        }
+
+        // Compute the covariance matrix of the colors
+        const __m128 mr = _mm_set1_ps( mean[0] );
+        const __m128 mg = _mm_set1_ps( mean[1] );
+        const __m128 mb = _mm_set1_ps( mean[2] );
+        __m128 crr = _mm_setzero_ps(), cgg = _mm_setzero_ps(), cbb = _mm_setzero_ps();
+        __m128 crg = _mm_setzero_ps(), crb = _mm_setzero_ps(), cgb = _mm_setzero_ps();
+        __m128 minR = block.r[0], maxR = block.r[0];
+        __m128 minG = block.g[0], maxG = block.g[0];
+        __m128 minB = block.b[0], maxB = block.b[0];
+        for( size_t i = 0; i < 4; ++i )
+        {
+            const __m128 pr = _mm_sub_ps( block.r[i], mr );
+            const __m128 pg = _mm_sub_ps( block.g[i], mg );
+            const __m128 pb = _mm_sub_ps( block.b[i], mb );
+            crr = _mm_add_ps( crr, _mm_mul_ps( pr, pr ) );
+            cgg = _mm_add_ps( cgg, _mm_mul_ps( pg, pg ) );
+            cbb = _mm_add_ps( cbb, _mm_mul_ps( pb, pb ) );
+            crg = _mm_add_ps( crg, _mm_mul_ps( pr, pg ) );
+            crb = _mm_add_ps( crb, _mm_mul_ps( pr, pb ) );
+            cgb = _mm_add_ps( cgb, _mm_mul_ps( pg, pb ) );
+            minR = _mm_min_ps( minR, block.r[i] ); maxR = _mm_max_ps( maxR, block.r[i] );
+            minG = _mm_min_ps( minG, block.g[i] ); maxG = _mm_max_ps( maxG, block.g[i] );
+            minB = _mm_min_ps( minB, block.b[i] ); maxB = _mm_max_ps( maxB, block.b[i] );
+        }
+
+        const float cov[6] = { _HorizontalSum( crr ), _HorizontalSum( cgg ), _HorizontalSum( cbb ),
+                               _HorizontalSum( crg ), _HorizontalSum( crb ), _HorizontalSum( cgb ) };
+
+        // Find the principal axis using power iterations (starting with the color range)
+        float axis[3] = { _HorizontalMax( maxR ) - _HorizontalMin( minR ),
+                          _HorizontalMax( maxG ) - _HorizontalMin( minG ),
+                          _HorizontalMax( maxB ) - _HorizontalMin( minB ) };
+        for( int iter = 0; iter < POWER_ITERATIONS; ++iter )
+        {
+            const float r = axis[0] * cov[0] + axis[1] * cov[3] + axis[2] * cov[4];
+            const float g = axis[0] * cov[3] + axis[1] * cov[1] + axis[2] * cov[5];
+            const float b = axis[0] * cov[4] + axis[1] * cov[5] + axis[2] * cov[2];
+            const float m = std::max( fabsf( r ), std::max( fabsf( g ), fabsf( b ) ) );
+            if ( m < 1e-6f )
+                break;
+            const float invM = 1.f / m;
+            axis[0] = r * invM;
+            axis[1] = g * invM;
+            axis[2] = b * invM;
+        }
+
+        float c0[3], c1[3];
+        const float len2 = axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2];
+        if ( len2 < 1e-6f )
+        {
+            // Solid color
+            for( size_t c = 0; c < 3; ++c )
+            {
+                c0[c] = c1[c] = mean[c];
+            }
+        }
+        else
+        {
+            // Fit the range of the projections onto the axis
+            const float invLen = 1.f / sqrtf( len2 );
+            const __m128 ar = _mm_set1_ps( axis[0] * invLen );
+            const __m128 ag = _mm_set1_ps( axis[1] * invLen );
+            const __m128 ab = _mm_set1_ps( axis[2] * invLen );
+            __m128 tmin = _mm_set1_ps( FLT_MAX ), tmax = _mm_set1_ps( -FLT_MAX );
+            for( size_t i = 0; i < 4; ++i )
+            {
+                const __m128 t = _mm_add_ps( _mm_add_ps( _mm_mul_ps( _mm_sub_ps( block.r[i], mr ), ar ),
+                                                         _mm_mul_ps( _mm_sub_ps( block.g[i], mg ), ag ) ),
+                                             _mm_mul_ps( _mm_sub_ps( block.b[i], mb ), ab ) );
+                tmin = _mm_min_ps( tmin, t );
+                tmax = _mm_max_ps( tmax, t );
+            }
+
+            // Inset the range, since the extreme colors are rarely reproduced exactly
+            float t0 = _HorizontalMin( tmin );
+            float t1 = _HorizontalMax( tmax );
+            const float inset = ( t1 - t0 ) / 16.f;
+            t0 += inset;
+            t1 -= inset;
+
+            const float dir[3] = { axis[0] * invLen, axis[1] * invLen, axis[2] * invLen };
+            for( size_t c = 0; c < 3; ++c )
+            {
+                c0[c] = std::min( std::max( mean[c] + t0 * dir[c], 0.f ), 255.f );
+                c1[c] = std::min( std::max( mean[c] + t1 * dir[c], 0.f ), 255.f );
+            }
+        }
+
+        Endpoint565 e0, e1;
+        _QuantizeEndpoint( c0, e0 );
+        _QuantizeEndpoint( c1, e1 );
+
+        __m128i positions[4];
+        const float error = _FitColorIndices( block, e0, e1, positions );
+
+        // Refine the endpoints once
+        if ( error > 0.f && _RefineEndpoints( block, positions, c0, c1 ) )
+        {
+            Endpoint565 r0, r1;
+            _QuantizeEndpoint( c0, r0 );
+            _QuantizeEndpoint( c1, r1 );
+
+            __m128i refined[4];
+            if ( _FitColorIndices( block, r0, r1, refined ) < error )
+            {
+                e0 = r0;
+                e1 = r1;
+                for( size_t i = 0; i < 4; ++i )
+                {
+                    positions[i] = refined[i];
+                }
+            }
+        }
+
+        // The 4-color mode requires the first endpoint to be greater
+        __m128i order = _mm_setzero_si128();
+        if ( e0.packed < e1.packed )
+        {
+            std::swap( e0, e1 );
+            order = _mm_set1_epi8( 3 );
+        }
+        else if ( e0.packed == e1.packed )
+        {
+            for( size_t i = 0; i < 4; ++i )
+            {
+                positions[i] = _mm_setzero_si128();
+            }
+        }
+
+        // Map the positions along the axis to the indices of the palette {e0, e1, 2/3 e0 + 1/3 e1, 1/3 e0 + 2/3 e1}
+        __m128i indices = _mm_abs_epi8( _mm_sub_epi8( order, _PackBytes( positions ) ) );
+        indices = _mm_shuffle_epi8( _mm_setr_epi8( 0, 2, 3, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 ), indices );
+
+        // Pack 2-bit indices: 4 indices per byte
+        __m128i bits = _mm_maddubs_epi16( indices, _mm_set1_epi16( 0x0401 ) );
+        bits = _mm_madd_epi16( bits, _mm_set1_epi32( 0x00100001 ) );
+        bits = _mm_packus_epi16( _mm_packus_epi32( bits, bits ), bits );
+
+        pBC->rgb[0] = e0.packed;
+        pBC->rgb[1] = e1.packed;
+        pBC->bitmap = static_cast<uint32_t>( _mm_cvtsi128_si32( bits ) );
+    }
+
+    // Encodes 16 8-bit values as a BC4 (or BC3 alpha) block in the 8-value mode
+    void _EncodeValueBlock( _Out_writes_(8) uint8_t* pBC, _In_ __m128i values )
+    {
+        const int minValue = _mm_cvtsi128_si32( _HorizontalMinU8( values ) ) & 0xFF;
+        const int maxValue = _mm_cvtsi128_si32( _HorizontalMaxU8( values ) ) & 0xFF;
+
+        pBC[0] = static_cast<uint8_t>( maxValue );
+        pBC[1] = static_cast<uint8_t>( minValue );
+
+        if ( maxValue == minValue )
+        {
+            memset( pBC + 2, 0, 6 );
+            return;
+        }
+
+        // Round the positions along the range to the nearest of the 8 values
+        const __m128 vmax = _mm_set1_ps( static_cast<float>( maxValue ) );
+        const __m128 scale = _mm_set1_ps( 7.f / static_cast<float>( maxValue - minValue ) );
+        __m128i positions[4];
+        for( size_t i = 0; i < 4; ++i )
+        {
+            const __m128 v = _mm_cvtepi32_ps( _mm_cvtepu8_epi32( values ) );
+            positions[i] = _mm_cvtps_epi32( _mm_mul_ps( _mm_sub_ps( vmax, v ), scale ) );
+            values = _mm_srli_si128( values, 4 );
+        }
+
+        // Map the positions to the indices of the palette {max, min, 6/7 max + 1/7 min, ...}
+        __m128i indices = _mm_shuffle_epi8( _mm_setr_epi8( 0, 2, 3, 4, 5, 6, 7, 1, 0, 0, 0, 0, 0, 0, 0, 0 ), _PackBytes( positions ) );
+
+        // Pack 3-bit indices: 4 indices per 12 bits
+        indices = _mm_maddubs_epi16( indices, _mm_set1_epi16( 0x0801 ) );
+        indices = _mm_madd_epi16( indices, _mm_set1_epi32( 0x00400001 ) );
+
+        const uint64_t bits = static_cast<uint64_t>( _mm_extract_epi32( indices, 0 ) )
+                            | ( static_cast<uint64_t>( _mm_extract_epi32( indices, 1 ) ) << 12 )
+                            | ( static_cast<uint64_t>( _mm_extract_epi32( indices, 2 ) ) << 24 )
+                            | ( static_cast<uint64_t>( _mm_extract_epi32( indices, 3 ) ) << 36 );
+        for( size_t i = 0; i < 6; ++i )
+        {
+            pBC[2 + i] = static_cast<uint8_t>( bits >> ( 8 * i ) );
+        }
+    }
+
+    inline void _LoadBlock( _In_reads_(NUM_PIXELS_PER_BLOCK) const uint32_t* pColor, _Out_writes_(4) __m128i* texels )
+    {
+        for( size_t i = 0; i < 4; ++i )
+        {
+            texels[i] = _mm_loadu_si128( reinterpret_cast<const __m128i*>( pColor + 4 * i ) );
+        }
+    }
+
+    // Gathers a channel of the texels into bytes
+    template<int shift>
+    inline __m128i _GatherChannel( _In_reads_(4) const __m128i* texels )
+    {
+        const __m128i mask = _mm_set1_epi32( 0xFF );
+        const __m128i channel[4] = { _mm_and_si128( _mm_srli_epi32( texels[0], shift ), mask ),
+                                     _mm_and_si128( _mm_srli_epi32( texels[1], shift ), mask ),
+                                     _mm_and_si128( _mm_srli_epi32( texels[2], shift ), mask ),
+                                     _mm_and_si128( _mm_srli_epi32( texels[3], shift ), mask ) };
+        return _PackBytes( channel );
+    }
+}
+
+
+//-------------------------------------------------------------------------------------
+// Entry points
+//-------------------------------------------------------------------------------------
+
+_Use_decl_annotations_
+void D3DXEncodeBC1Fast(uint8_t *pBC, const uint32_t *pColor, float alphaRef, DWORD flags)
+{
+    assert( pBC && pColor );
+
+    __m128i texels[4];
+    _LoadBlock( pColor, texels );
+
+    // Blocks with transparent texels require the 3-color mode, which the reference encoder handles
+    const __m128i threshold = _mm_set1_epi32( static_cast<int>( alphaRef * 255.f + 0.5f ) );
+    __m128i transparent = _mm_setzero_si128();
+    for( size_t i = 0; i < 4; ++i )
+    {
+        transparent = _mm_or_si128( transparent, _mm_cmplt_epi32( _mm_srli_epi32( texels[i], 24 ), threshold ) );
+    }
+
+    if ( _mm_movemask_epi8( transparent ) )
+    {
+        XMVECTOR temp[NUM_PIXELS_PER_BLOCK];
+        for( size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i )
+        {
+            XMUBYTEN4 texel;
+            texel.v = pColor[i];
+            temp[i] = XMLoadUByteN4( &texel );
+        }
+        D3DXEncodeBC1( pBC, temp, alphaRef, flags );
+        return;
+    }
+
+    _EncodeColorBlock( reinterpret_cast<D3DX_BC1*>( pBC ), texels );
+}
+
+_Use_decl_annotations_
+void D3DXEncodeBC3Fast(uint8_t *pBC, const uint32_t *pColor)
+{
+    assert( pBC && pColor );
+
+    __m128i texels[4];
+    _LoadBlock( pColor, texels );
+
+    auto pBC3 = reinterpret_cast<D3DX_BC3*>( pBC );
+    _EncodeValueBlock( pBC3->alpha, _GatherChannel<24>( texels ) );
+    _EncodeColorBlock( &pBC3->bc1, texels );
+}
+
+_Use_decl_annotations_
+void D3DXEncodeBC4UFast(uint8_t *pBC, const uint32_t *pColor)
+{
+    assert( pBC && pColor );
+
+    __m128i texels[4];
+    _LoadBlock( pColor, texels );
+
+    _EncodeValueBlock( pBC, _GatherChannel<0>( texels ) );
+}
+
+_Use_decl_annotations_
+void D3DXEncodeBC5UFast(uint8_t *pBC, const uint32_t *pColor)
+{
+    assert( pBC && pColor );
+
+    __m128i texels[4];
+    _LoadBlock( pColor, texels );
+
+    _EncodeValueBlock( pBC, _GatherChannel<0>( texels ) );
+    _EncodeValueBlock( pBC + 8, _GatherChannel<8>( texels ) );
+}
+
+} // namespace
@@ -169,6 +169,14 @@ namespace DirectX
             // DDS_FLAGS_FORCE_DX10_EXT including miscFlags2 information (result may not be compatible with D3DX10 or D3DX11)
     };
 
+    enum TGA_FLAGS
+    {
+        TGA_FLAGS_NONE                  = 0x0,
+
+        TGA_FLAGS_FLIP_VERTICAL         = 0x1,
+            // Writes the scanlines in the opposite vertical order while decoding (same result as TEX_FR_FLIP_VERTICAL, without the extra image)
+    };
+
     enum WIC_FLAGS
     {
         WIC_FLAGS_NONE                  = 0x0,
@@ -238,10 +246,12 @@ namespace DirectX
     {
     public:
         ScratchImage()
-            : _nimages(0), _size(0), _image(nullptr), _memory(nullptr) {}
+            : _nimages(0), _size(0), _image(nullptr), _memory(nullptr),
+              _retain(false), _spareImageCount(0), _spareSize(0), _spareImage(nullptr), _spareMemory(nullptr) {}
         ScratchImage(ScratchImage&& moveFrom)
-            : _nimages(0), _size(0), _image(nullptr), _memory(nullptr) { *this = std::move(moveFrom); }
-        ~ScratchImage() { Release(); }
+            : _nimages(0), _size(0), _image(nullptr), _memory(nullptr),
+              _retain(false), _spareImageCount(0), _spareSize(0), _spareImage(nullptr), _spareMemory(nullptr) { *this = std::move(moveFrom); }
+        ~ScratchImage() { Release(); RetainBuffers( false ); }
 
         ScratchImage& __cdecl operator= (ScratchImage&& moveFrom);
 
@@ -259,6 +269,10 @@ namespace DirectX
 
         void __cdecl Release();
 
+        void __cdecl RetainBuffers( _In_ bool retain );
+            // While enabled, Release() keeps the image array and the pixel buffer, and the Initialize methods reuse them
+            // (growing them as needed), so a ScratchImage used for a sequence of images only allocates for the largest one
+
         bool __cdecl OverrideFormat( _In_ DXGI_FORMAT f );
 
         const TexMetadata& __cdecl GetMetadata() const { return _metadata; }
@@ -269,6 +283,7 @@ namespace DirectX
 
         uint8_t* __cdecl GetPixels() const { return _memory; }
         size_t __cdecl GetPixelsSize() const { return _size; }
+        size_t __cdecl GetPixelsCapacity() const { return std::max( _size, _spareSize ); }
 
         bool __cdecl IsAlphaAllOpaque() const;
 
@@ -279,11 +294,71 @@ namespace DirectX
         Image*      _image;
         uint8_t*    _memory;
 
+        // Buffers kept across Release() (see RetainBuffers)
+        bool        _retain;
+        size_t      _spareImageCount;
+        size_t      _spareSize;
+        Image*      _spareImage;
+        uint8_t*    _spareMemory;
+
+        bool __cdecl _AllocateImages( _In_ size_t nimages );
+        bool __cdecl _AllocatePixels( _In_ size_t pixelSize );
+
         // Hide copy constructor and assignment operator
         ScratchImage( const ScratchImage& );
         ScratchImage& operator=( const ScratchImage& );
     };
 
+    //---------------------------------------------------------------------------------
+    // Image container which refers to pixels stored elsewhere (e.g. in a memory-mapped file)
+    class ImageView
+    {
+    public:
+        ImageView()
+            : _nimages(0), _size(0), _metadata(), _image(nullptr), _pixels(nullptr), _mapping(nullptr) {}
+        ImageView(ImageView&& moveFrom)
+            : _nimages(0), _size(0), _metadata(), _image(nullptr), _pixels(nullptr), _mapping(nullptr) { *this = std::move(moveFrom); }
+        ~ImageView() { Release(); }
+
+        ImageView& __cdecl operator= (ImageView&& moveFrom);
+
+        HRESULT __cdecl Initialize( _In_ const TexMetadata& mdata, _In_reads_bytes_(size) LPCVOID pixels, _In_ size_t size, _In_ DWORD flags = CP_FLAGS_NONE );
+            // Describes pixels laid out as by ScratchImage::Initialize without copying them, so they must outlive the view
+            // The image pixels must not be written to, since they may reside in read-only memory
+
+        HRESULT __cdecl Initialize( _Inout_ ScratchImage&& image );
+            // Takes ownership of the image (for pixels which had to be converted)
+
+        void __cdecl Release();
+
+        const TexMetadata& __cdecl GetMetadata() const { return _metadata; }
+        const Image* __cdecl GetImage(_In_ size_t mip, _In_ size_t item, _In_ size_t slice) const;
+
+        const Image* __cdecl GetImages() const { return _image; }
+        size_t __cdecl GetImageCount() const { return _nimages; }
+
+        const uint8_t* __cdecl GetPixels() const { return _pixels; }
+        size_t __cdecl GetPixelsSize() const { return _size; }
+
+        bool __cdecl IsCopy() const { return _copy.GetPixels() != nullptr; }
+
+    private:
+        size_t          _nimages;
+        size_t          _size;
+        TexMetadata     _metadata;
+        Image*          _image;
+        const uint8_t*  _pixels;
+        ScratchImage    _copy;      // Converted pixels (if any)
+        LPCVOID         _mapping;   // Mapped file view owned by the container (if any)
+
+        friend HRESULT __cdecl LoadFromDDSFile( _In_z_ LPCWSTR szFile, _In_ DWORD flags,
+                                                _Out_opt_ TexMetadata* metadata, _Out_ ImageView& view );
+
+        // Hide copy constructor and assignment operator
+        ImageView( const ImageView& );
+        ImageView& operator=( const ImageView& );
+    };
+
     //---------------------------------------------------------------------------------
     // Memory blob (allocated buffer pointer is always 16-byte aligned)
     class Blob
@@ -320,6 +395,13 @@ namespace DirectX
     HRESULT __cdecl LoadFromDDSFile( _In_z_ LPCWSTR szFile, _In_ DWORD flags,
                                      _Out_opt_ TexMetadata* metadata, _Out_ ScratchImage& image );
 
+    HRESULT __cdecl LoadFromDDSMemory( _In_reads_bytes_(size) LPCVOID pSource, _In_ size_t size, _In_ DWORD flags,
+                                       _Out_opt_ TexMetadata* metadata, _Out_ ImageView& view );
+    HRESULT __cdecl LoadFromDDSFile( _In_z_ LPCWSTR szFile, _In_ DWORD flags,
+                                     _Out_opt_ TexMetadata* metadata, _Out_ ImageView& view );
+        // The view refers to the pixels within the source memory (which must outlive it) or the memory-mapped file,
+        // and only holds a copy of them if the format of the file requires conversion
+
     HRESULT __cdecl SaveToDDSMemory( _In_ const Image& image, _In_ DWORD flags,
                                      _Out_ Blob& blob );
     HRESULT __cdecl SaveToDDSMemory( _In_reads_(nimages) const Image* images, _In_ size_t nimages, _In_ const TexMetadata& metadata, _In_ DWORD flags,
@@ -333,6 +415,10 @@ namespace DirectX
                                        _Out_opt_ TexMetadata* metadata, _Out_ ScratchImage& image );
     HRESULT __cdecl LoadFromTGAFile( _In_z_ LPCWSTR szFile,
                                      _Out_opt_ TexMetadata* metadata, _Out_ ScratchImage& image );
+    HRESULT __cdecl LoadFromTGAMemory( _In_reads_bytes_(size) LPCVOID pSource, _In_ size_t size, _In_ DWORD flags,
+                                       _Out_opt_ TexMetadata* metadata, _Out_ ScratchImage& image );
+    HRESULT __cdecl LoadFromTGAFile( _In_z_ LPCWSTR szFile, _In_ DWORD flags,
+                                     _Out_opt_ TexMetadata* metadata, _Out_ ScratchImage& image );
 
     HRESULT __cdecl SaveToTGAMemory( _In_ const Image& image, _Out_ Blob& blob );
     HRESULT __cdecl SaveToTGAFile( _In_ const Image& image, _In_z_ LPCWSTR szFile );
@@ -411,6 +497,7 @@ namespace DirectX
         TEX_FILTER_BOX              = 0x400000,
         TEX_FILTER_FANT             = 0x400000, // Equiv to Box filtering for mipmap generation
         TEX_FILTER_TRIANGLE         = 0x500000,
+        TEX_FILTER_LANCZOS3         = 0x600000, // Resize only
             // Filtering mode to use for any required image resizing
 
         TEX_FILTER_SRGB_IN          = 0x1000000,
@@ -496,6 +583,14 @@ namespace DirectX
         TEX_COMPRESS_BC7_USE_3SUBSETS = 0x80000,
             // Enables exhaustive search for BC7 compress for mode 0 and 2; by default skips trying these modes
 
+        TEX_COMPRESS_FAST           = 0x100000,
+            // Uses the fast (range fit) encoders for BC1, BC3, BC4_UNORM, and BC5_UNORM at the cost of quality
+            // Ignored for other formats, when converting between sRGB and linear, or when dithering or uniform weighting is requested
+            // For BC7, tries a subset of the modes and the partitions which best fit the colors
+
+        TEX_COMPRESS_BC7_QUICK      = 0x200000,
+            // Only tries BC7 mode 6, which is the fastest BC7 preset
+
         TEX_COMPRESS_SRGB_IN        = 0x1000000,
         TEX_COMPRESS_SRGB_OUT       = 0x2000000,
         TEX_COMPRESS_SRGB           = ( TEX_COMPRESS_SRGB_IN | TEX_COMPRESS_SRGB_OUT ),
@@ -506,11 +601,27 @@ namespace DirectX
             // Compress is free to use multithreading to improve performance (by default it does not use multithreading)
     };
 
+    class ITaskExecutor
+    {
+    public:
+        virtual void __cdecl Run( _In_ size_t count, _In_ const std::function<void __cdecl(size_t)>& task ) = 0;
+            // Invokes task( index ) for each index in [0, count), possibly concurrently, and returns once all have completed
+
+    protected:
+        ~ITaskExecutor() {}
+    };
+
+    ITaskExecutor* __cdecl GetSharedTaskExecutor();
+        // Returns the process-wide executor; its worker threads are shared by all concurrent callers,
+        // and the calling thread also executes tasks while it waits for them to complete
+
     HRESULT __cdecl Compress( _In_ const Image& srcImage, _In_ DXGI_FORMAT format, _In_ DWORD compress, _In_ float alphaRef,
-                              _Out_ ScratchImage& cImage );
+                              _Out_ ScratchImage& cImage, _In_opt_ ITaskExecutor* executor = nullptr );
     HRESULT __cdecl Compress( _In_reads_(nimages) const Image* srcImages, _In_ size_t nimages, _In_ const TexMetadata& metadata,
-                              _In_ DXGI_FORMAT format, _In_ DWORD compress, _In_ float alphaRef, _Out_ ScratchImage& cImages );
+                              _In_ DXGI_FORMAT format, _In_ DWORD compress, _In_ float alphaRef, _Out_ ScratchImage& cImages,
+                              _In_opt_ ITaskExecutor* executor = nullptr );
         // Note that alphaRef is only used by BC1. 0.5f is a typical value to use
+        // With TEX_COMPRESS_PARALLEL, strips of block rows are submitted as tasks to the executor (by default, the shared one)
 
     HRESULT __cdecl Compress( _In_ ID3D11Device* pDevice, _In_ const Image& srcImage, _In_ DXGI_FORMAT format, _In_ DWORD compress,
                               _In_ float alphaWeight, _Out_ ScratchImage& image );
@@ -15,10 +15,7 @@
 
 #include "directxtexp.h"
 
-#ifdef _OPENMP
-#include <omp.h>
-#pragma warning(disable : 4616 6993)
-#endif
+#include <atomic>
 
 #include "bc.h"
 
@@ -33,7 +30,9 @@ inline static DWORD _GetBCFlags( _In_ DWORD compress )
     static_assert( TEX_COMPRESS_DITHER == (BC_FLAGS_DITHER_RGB | BC_FLAGS_DITHER_A), "TEX_COMPRESS_* flags should match BC_FLAGS_*"  );
     static_assert( TEX_COMPRESS_UNIFORM == BC_FLAGS_UNIFORM, "TEX_COMPRESS_* flags should match BC_FLAGS_*"  );
     static_assert( TEX_COMPRESS_BC7_USE_3SUBSETS == BC_FLAGS_USE_3SUBSETS, "TEX_COMPRESS_* flags should match BC_FLAGS_*"  );
-    return ( compress & (BC_FLAGS_DITHER_RGB|BC_FLAGS_DITHER_A|BC_FLAGS_UNIFORM|BC_FLAGS_USE_3SUBSETS) );
+    static_assert( TEX_COMPRESS_FAST == BC_FLAGS_FAST, "TEX_COMPRESS_* flags should match BC_FLAGS_*"  );
+    static_assert( TEX_COMPRESS_BC7_QUICK == BC_FLAGS_BC7_QUICK, "TEX_COMPRESS_* flags should match BC_FLAGS_*"  );
+    return ( compress & (BC_FLAGS_DITHER_RGB|BC_FLAGS_DITHER_A|BC_FLAGS_UNIFORM|BC_FLAGS_USE_3SUBSETS|BC_FLAGS_FAST|BC_FLAGS_BC7_QUICK) );
 }
 
 inline static DWORD _GetSRGBFlags( _In_ DWORD compress )
@@ -194,9 +193,194 @@ static HRESULT _CompressBC( _In_ const Image& image, _In_ const Image& result, _
 
 
 //-------------------------------------------------------------------------------------
-#ifdef _OPENMP
+// Splits the rows of blocks into strips, and runs them as tasks on the executor
+//-------------------------------------------------------------------------------------
+static void _ForEachBlockStrip( _In_opt_ ITaskExecutor* executor, _In_ size_t nbWidth, _In_ size_t nbHeight,
+                                _In_ const std::function<void __cdecl(size_t rowBegin, size_t rowEnd)>& func )
+{
+    // Strips of at least this many blocks amortize the cost of scheduling a task
+    const size_t STRIP_BLOCKS = 256;
+
+    const size_t rowsPerStrip = std::max<size_t>( 1, STRIP_BLOCKS / nbWidth );
+    const size_t nstrips = ( nbHeight + rowsPerStrip - 1 ) / rowsPerStrip;
+
+    if ( !executor )
+        executor = GetSharedTaskExecutor();
+
+    executor->Run( nstrips, [&]( size_t strip )
+    {
+        func( strip * rowsPerStrip, std::min<size_t>( nbHeight, ( strip + 1 ) * rowsPerStrip ) );
+    } );
+}
+
+
+//-------------------------------------------------------------------------------------
+// Fast compression (of 8-bit RGBA texels)
+//-------------------------------------------------------------------------------------
+static bool _UseFastEncoder( _In_ DXGI_FORMAT srcFormat, _In_ DXGI_FORMAT format, _In_ DWORD compress )
+{
+    if ( !(compress & TEX_COMPRESS_FAST) )
+        return false;
+
+    // The fast encoders neither dither nor support uniform (non-perceptual) weighting, so leave
+    // these requests to the reference encoders
+    if ( compress & ( TEX_COMPRESS_DITHER | TEX_COMPRESS_UNIFORM ) )
+        return false;
+
+    switch( format )
+    {
+    case DXGI_FORMAT_BC1_UNORM:
+    case DXGI_FORMAT_BC1_UNORM_SRGB:
+    case DXGI_FORMAT_BC3_UNORM:
+    case DXGI_FORMAT_BC3_UNORM_SRGB:
+    case DXGI_FORMAT_BC4_UNORM:
+    case DXGI_FORMAT_BC5_UNORM:
+        break;
+
+    default:
+        return false;
+    }
+
+    // The fast encoders operate on the stored values, so they cannot convert between sRGB and linear
+    const bool srgbIn = IsSRGB( srcFormat ) || ( compress & TEX_COMPRESS_SRGB_IN );
+    const bool srgbOut = IsSRGB( format ) || ( compress & TEX_COMPRESS_SRGB_OUT );
+    return ( srgbIn == srgbOut );
+}
+
+static void _CompressBlockRowFast( _In_ const Image& image, _In_ const Image& result, _In_ size_t row, _In_ bool bgra,
+                                   _In_ DWORD bcflags, _In_ float alphaRef )
+{
+    BC_ENCODE_FAST pfEncode;
+    size_t blocksize;
+    switch( result.format )
+    {
+    case DXGI_FORMAT_BC3_UNORM:
+    case DXGI_FORMAT_BC3_UNORM_SRGB:    pfEncode = D3DXEncodeBC3Fast;   blocksize = 16; break;
+    case DXGI_FORMAT_BC4_UNORM:         pfEncode = D3DXEncodeBC4UFast;  blocksize = 8;  break;
+    case DXGI_FORMAT_BC5_UNORM:         pfEncode = D3DXEncodeBC5UFast;  blocksize = 16; break;
+    default:                            pfEncode = nullptr;             blocksize = 8;  break;
+    }
+
+    const size_t h = row * 4;
+    const size_t ph = std::min<size_t>( 4, image.height - h );
+    uint8_t* dptr = result.pixels + row * result.rowPitch;
+
+    uint32_t temp[16];
+    for( size_t w = 0; w < image.width; w += 4, dptr += blocksize )
+    {
+        const size_t pw = std::min<size_t>( 4, image.width - w );
+        assert( pw > 0 && ph > 0 );
+
+        for( size_t t = 0; t < ph; ++t )
+        {
+            memcpy( &temp[ t << 2 ], image.pixels + ( h + t ) * image.rowPitch + w * 4, pw * 4 );
+        }
+
+        if ( pw != 4 || ph != 4 )
+        {
+            // Replicate pixels for partial block
+            static const size_t uSrc[] = { 0, 0, 0, 1 };
+
+            for( size_t t = 0; t < ph; ++t )
+            {
+                for( size_t s = pw; s < 4; ++s )
+                {
+                    temp[ (t << 2) | s ] = temp[ (t << 2) | uSrc[s] ];
+                }
+            }
+
+            for( size_t t = ph; t < 4; ++t )
+            {
+                for( size_t s = 0; s < 4; ++s )
+                {
+                    temp[ (t << 2) | s ] = temp[ (uSrc[t] << 2) | s ];
+                }
+            }
+        }
+
+        if ( bgra )
+        {
+            for( size_t i = 0; i < 16; ++i )
+            {
+                const uint32_t t = temp[i];
+                temp[i] = ( t & 0xFF00FF00 ) | ( ( t >> 16 ) & 0xFF ) | ( ( t & 0xFF ) << 16 );
+            }
+        }
+
+        if ( pfEncode )
+            pfEncode( dptr, temp );
+        else
+            D3DXEncodeBC1Fast( dptr, temp, alphaRef, bcflags );
+    }
+}
+
+static HRESULT _CompressBCFast( _In_ const Image& image, _In_ const Image& result, _In_ DWORD compress, _In_ float alphaRef,
+                                _In_opt_ ITaskExecutor* executor )
+{
+    if ( !image.pixels || !result.pixels )
+        return E_POINTER;
+
+    assert( image.width == result.width );
+    assert( image.height == result.height );
+
+    // Convert the source to 8-bit RGBA, unless it already is
+    ScratchImage converted;
+    const Image* src = &image;
+    bool bgra = false;
+    switch( image.format )
+    {
+    case DXGI_FORMAT_R8G8B8A8_UNORM:
+    case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:
+        break;
+
+    case DXGI_FORMAT_B8G8R8A8_UNORM:
+    case DXGI_FORMAT_B8G8R8A8_UNORM_SRGB:
+        bgra = true;
+        break;
+
+    default:
+        {
+            const DXGI_FORMAT tformat = IsSRGB( image.format ) ? DXGI_FORMAT_R8G8B8A8_UNORM_SRGB : DXGI_FORMAT_R8G8B8A8_UNORM;
+            HRESULT hr = Convert( image, tformat, TEX_FILTER_DEFAULT, 0.5f, converted );
+            if ( FAILED(hr) )
+                return hr;
+
+            src = converted.GetImage( 0, 0, 0 );
+            if ( !src )
+                return E_POINTER;
+        }
+        break;
+    }
+
+    const DWORD bcflags = _GetBCFlags( compress );
+    const size_t nbWidth = std::max<size_t>( 1, ( image.width + 3 ) / 4 );
+    const size_t nbHeight = std::max<size_t>( 1, ( image.height + 3 ) / 4 );
+
+    if ( compress & TEX_COMPRESS_PARALLEL )
+    {
+        _ForEachBlockStrip( executor, nbWidth, nbHeight, [&]( size_t rowBegin, size_t rowEnd )
+        {
+            for( size_t row = rowBegin; row < rowEnd; ++row )
+            {
+                _CompressBlockRowFast( *src, result, row, bgra, bcflags, alphaRef );
+            }
+        } );
+    }
+    else
+    {
+        for( size_t row = 0; row < nbHeight; ++row )
+        {
+            _CompressBlockRowFast( *src, result, row, bgra, bcflags, alphaRef );
+        }
+    }
+
+    return S_OK;
+}
+
+
+//-------------------------------------------------------------------------------------
 static HRESULT _CompressBC_Parallel( _In_ const Image& image, _In_ const Image& result, _In_ DWORD bcflags,
-                                     _In_ DWORD srgb, _In_ float alphaRef )
+                                     _In_ DWORD srgb, _In_ float alphaRef, _In_opt_ ITaskExecutor* executor )
 {
     if ( !image.pixels || !result.pixels )
         return E_POINTER;
@@ -228,101 +412,100 @@ static HRESULT _CompressBC_Parallel( _In_ const Image& image, _In_ const Image&
         return HRESULT_FROM_WIN32( ERROR_NOT_SUPPORTED );
 
     // Refactored version of loop to support parallel independance
-    const size_t nBlocks = std::max<size_t>(1, (image.width + 3) / 4 ) * std::max<size_t>(1, (image.height + 3) / 4 );
+    const size_t nbWidth = std::max<size_t>(1, (image.width + 3) / 4 );
+    const size_t nbHeight = std::max<size_t>(1, (image.height + 3) / 4 );
 
-    bool fail = false;
+    std::atomic<bool> fail( false );
 
-#pragma omp parallel for
-    for( int nb=0; nb < static_cast<int>( nBlocks ); ++nb )
+    _ForEachBlockStrip( executor, nbWidth, nbHeight, [&]( size_t rowBegin, size_t rowEnd )
     {
-        int nbWidth = std::max<int>(1, int( (image.width + 3) / 4 ) );
-
-        int y = nb / nbWidth;
-        int x = ( nb - (y*nbWidth) ) * 4;
-        y *= 4;
-
-        assert( (x >= 0) && (x < int(image.width)) );
-        assert( (y >= 0) && (y < int(image.height)) );
+        for( size_t nb = rowBegin * nbWidth; nb < rowEnd * nbWidth; ++nb )
+        {
+            size_t y = nb / nbWidth;
+            size_t x = ( nb - (y*nbWidth) ) * 4;
+            y *= 4;
 
-        size_t rowPitch = image.rowPitch;
-        const uint8_t *pSrc = image.pixels + (y*rowPitch) + (x*sbpp);
+            assert( x < image.width );
+            assert( y < image.height );
 
-        uint8_t *pDest = result.pixels + (nb*blocksize);
+            size_t rowPitch = image.rowPitch;
+            const uint8_t *pSrc = image.pixels + (y*rowPitch) + (x*sbpp);
 
-        size_t ph = std::min<size_t>( 4, image.height - y );
-        size_t pw = std::min<size_t>( 4, image.width - x );
-        assert( pw > 0 && ph > 0 );
+            uint8_t *pDest = result.pixels + (nb*blocksize);
 
-        ptrdiff_t bytesLeft = pEnd - pSrc;
-        assert( bytesLeft > 0 );
-        size_t bytesToRead = std::min<size_t>( rowPitch, bytesLeft );
+            size_t ph = std::min<size_t>( 4, image.height - y );
+            size_t pw = std::min<size_t>( 4, image.width - x );
+            assert( pw > 0 && ph > 0 );
 
-        XMVECTOR temp[16];
-        if ( !_LoadScanline( &temp[0], pw, pSrc, bytesToRead, format ) )
-            fail = true;
+            ptrdiff_t bytesLeft = pEnd - pSrc;
+            assert( bytesLeft > 0 );
+            size_t bytesToRead = std::min<size_t>( rowPitch, bytesLeft );
 
-        if ( ph > 1 )
-        {
-            bytesToRead = std::min<size_t>( rowPitch, bytesLeft - rowPitch );
-            if ( !_LoadScanline( &temp[4], pw, pSrc + rowPitch, bytesToRead, format ) )
+            XMVECTOR temp[16];
+            if ( !_LoadScanline( &temp[0], pw, pSrc, bytesToRead, format ) )
                 fail = true;
 
-            if ( ph > 2 )
+            if ( ph > 1 )
             {
-                bytesToRead = std::min<size_t>( rowPitch, bytesLeft - rowPitch * 2 );
-                if ( !_LoadScanline( &temp[8], pw, pSrc + rowPitch*2, bytesToRead, format ) )
+                bytesToRead = std::min<size_t>( rowPitch, bytesLeft - rowPitch );
+                if ( !_LoadScanline( &temp[4], pw, pSrc + rowPitch, bytesToRead, format ) )
                     fail = true;
 
-                if ( ph > 3 )
+                if ( ph > 2 )
                 {
-                    bytesToRead = std::min<size_t>( rowPitch, bytesLeft - rowPitch * 3 );
-                    if ( !_LoadScanline( &temp[12], pw, pSrc + rowPitch*3, bytesToRead, format ) )
+                    bytesToRead = std::min<size_t>( rowPitch, bytesLeft - rowPitch * 2 );
+                    if ( !_LoadScanline( &temp[8], pw, pSrc + rowPitch*2, bytesToRead, format ) )
                         fail = true;
+
+                    if ( ph > 3 )
+                    {
+                        bytesToRead = std::min<size_t>( rowPitch, bytesLeft - rowPitch * 3 );
+                        if ( !_LoadScanline( &temp[12], pw, pSrc + rowPitch*3, bytesToRead, format ) )
+                            fail = true;
+                    }
                 }
             }
-        }
-
-        if ( pw != 4 || ph != 4 )
-        {
-            // Replicate pixels for partial block
-            static const size_t uSrc[] = { 0, 0, 0, 1 };
 
-            if ( pw < 4 )
+            if ( pw != 4 || ph != 4 )
             {
-                for( size_t t = 0; t < ph && t < 4; ++t )
+                // Replicate pixels for partial block
+                static const size_t uSrc[] = { 0, 0, 0, 1 };
+
+                if ( pw < 4 )
                 {
-                    for( size_t s = pw; s < 4; ++s )
+                    for( size_t t = 0; t < ph && t < 4; ++t )
                     {
-                        temp[ (t << 2) | s ] = temp[ (t << 2) | uSrc[s] ]; 
+                        for( size_t s = pw; s < 4; ++s )
+                        {
+                            temp[ (t << 2) | s ] = temp[ (t << 2) | uSrc[s] ]; 
+                        }
                     }
                 }
-            }
 
-            if ( ph < 4 )
-            {
-                for( size_t t = ph; t < 4; ++t )
+                if ( ph < 4 )
                 {
-                    for( size_t s = 0; s < 4; ++s )
+                    for( size_t t = ph; t < 4; ++t )
                     {
-                        temp[ (t << 2) | s ] = temp[ (uSrc[t] << 2) | s ]; 
+                        for( size_t s = 0; s < 4; ++s )
+                        {
+                            temp[ (t << 2) | s ] = temp[ (uSrc[t] << 2) | s ]; 
+                        }
                     }
                 }
             }
-        }
 
-        _ConvertScanline( temp, 16, result.format, format, cflags | srgb );
+            _ConvertScanline( temp, 16, result.format, format, cflags | srgb );
             
-        if ( pfEncode )
-            pfEncode( pDest, temp, bcflags );
-        else
-            D3DXEncodeBC1( pDest, temp, alphaRef, bcflags );
-    }
+            if ( pfEncode )
+                pfEncode( pDest, temp, bcflags );
+            else
+                D3DXEncodeBC1( pDest, temp, alphaRef, bcflags );
+        }
+    } );
 
     return (fail) ? E_FAIL : S_OK;
 }
 
-#endif // _OPENMP
-
 
 //-------------------------------------------------------------------------------------
 static DXGI_FORMAT _DefaultDecompress( _In_ DXGI_FORMAT format )
@@ -580,7 +763,8 @@ bool _IsAlphaAllOpaqueBC( _In_ const Image& cImage )
 // Compression
 //-------------------------------------------------------------------------------------
 _Use_decl_annotations_
-HRESULT Compress( const Image& srcImage, DXGI_FORMAT format, DWORD compress, float alphaRef, ScratchImage& image )
+HRESULT Compress( const Image& srcImage, DXGI_FORMAT format, DWORD compress, float alphaRef, ScratchImage& image,
+                  ITaskExecutor* executor )
 {
     if ( IsCompressed(srcImage.format) || !IsCompressed(format) )
         return E_INVALIDARG;
@@ -602,13 +786,13 @@ HRESULT Compress( const Image& srcImage, DXGI_FORMAT format, DWORD compress, flo
     }
 
     // Compress single image
-    if (compress & TEX_COMPRESS_PARALLEL)
+    if ( _UseFastEncoder( srcImage.format, format, compress ) )
     {
-#ifndef _OPENMP
-        return E_NOTIMPL;
-#else
-        hr = _CompressBC_Parallel( srcImage, *img, _GetBCFlags( compress ), _GetSRGBFlags( compress ), alphaRef );
-#endif // _OPENMP
+        hr = _CompressBCFast( srcImage, *img, compress, alphaRef, executor );
+    }
+    else if (compress & TEX_COMPRESS_PARALLEL)
+    {
+        hr = _CompressBC_Parallel( srcImage, *img, _GetBCFlags( compress ), _GetSRGBFlags( compress ), alphaRef, executor );
     }
     else
     {
@@ -623,7 +807,7 @@ HRESULT Compress( const Image& srcImage, DXGI_FORMAT format, DWORD compress, flo
 
 _Use_decl_annotations_
 HRESULT Compress( const Image* srcImages, size_t nimages, const TexMetadata& metadata,
-                  DXGI_FORMAT format, DWORD compress, float alphaRef, ScratchImage& cImages )
+                  DXGI_FORMAT format, DWORD compress, float alphaRef, ScratchImage& cImages, ITaskExecutor* executor )
 {
     if ( !srcImages || !nimages )
         return E_INVALIDARG;
@@ -668,21 +852,23 @@ HRESULT Compress( const Image* srcImages, size_t nimages, const TexMetadata& met
             return E_FAIL;
         }
 
-        if ( (compress & TEX_COMPRESS_PARALLEL) )
+        if ( _UseFastEncoder( src.format, format, compress ) )
         {
-#ifndef _OPENMP
-            return E_NOTIMPL;
-#else
-            if ( compress & TEX_COMPRESS_PARALLEL )
+            hr = _CompressBCFast( src, dest[ index ], compress, alphaRef, executor );
+            if ( FAILED(hr) )
             {
-                hr = _CompressBC_Parallel( src, dest[ index ], _GetBCFlags( compress ), _GetSRGBFlags( compress ), alphaRef );
-                if ( FAILED(hr) )
-                {
-                    cImages.Release();
-                    return  hr;
-                }
+                cImages.Release();
+                return hr;
+            }
+        }
+        else if ( (compress & TEX_COMPRESS_PARALLEL) )
+        {
+            hr = _CompressBC_Parallel( src, dest[ index ], _GetBCFlags( compress ), _GetSRGBFlags( compress ), alphaRef, executor );
+            if ( FAILED(hr) )
+            {
+                cImages.Release();
+                return  hr;
             }
-#endif // _OPENMP
         }
         else
         {
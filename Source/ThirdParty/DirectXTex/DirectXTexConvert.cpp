@@ -15,6 +15,8 @@
 
 #include "directxtexp.h"
 
+#include <smmintrin.h>
+
 using namespace DirectX::PackedVector;
 using Microsoft::WRL::ComPtr;
 
@@ -4072,6 +4074,468 @@ bool _StoreScanlineDither( LPVOID pDestination, size_t size, DXGI_FORMAT format,
 #undef STORE_SCANLINE1
 
 
+//-------------------------------------------------------------------------------------
+// Specialized conversions
+//
+// Common conversions from 8-bit UNORM formats compute each destination channel from a
+// single source byte, so they can skip the XMVECTOR round-trip. Each conversion is
+// described by the source byte which feeds each destination channel. On first use the
+// generic path output is captured for every byte value, SIMD kernels are enabled for
+// the channels they reproduce exactly (with a table lookup for anything else), and the
+// result is checked against the generic path on a second row. The output is therefore
+// bit-exact with _LoadScanline/_ConvertScanline/_StoreScanline.
+//-------------------------------------------------------------------------------------
+struct FastConvertData
+{
+    DXGI_FORMAT inFormat;
+    DXGI_FORMAT outFormat;
+    size_t      inBytes;            // Bytes per source pixel
+    size_t      outChannels;
+    size_t      outChannelBytes;    // 1 (UNORM), 2 (half) or 4 (float)
+    uint8_t     channelSource[4];   // Source byte read for each destination channel
+};
+
+static const FastConvertData g_FastConvertTable[] = {
+    // Red/blue swizzles and alpha fills
+    { DXGI_FORMAT_R8G8B8A8_UNORM,       DXGI_FORMAT_B8G8R8A8_UNORM,         4, 4, 1, { 2, 1, 0, 3 } },
+    { DXGI_FORMAT_R8G8B8A8_UNORM,       DXGI_FORMAT_B8G8R8X8_UNORM,         4, 4, 1, { 2, 1, 0, 3 } },
+    { DXGI_FORMAT_R8G8B8A8_UNORM_SRGB,  DXGI_FORMAT_B8G8R8A8_UNORM_SRGB,    4, 4, 1, { 2, 1, 0, 3 } },
+    { DXGI_FORMAT_R8G8B8A8_UNORM_SRGB,  DXGI_FORMAT_B8G8R8X8_UNORM_SRGB,    4, 4, 1, { 2, 1, 0, 3 } },
+    { DXGI_FORMAT_B8G8R8A8_UNORM,       DXGI_FORMAT_R8G8B8A8_UNORM,         4, 4, 1, { 2, 1, 0, 3 } },
+    { DXGI_FORMAT_B8G8R8A8_UNORM,       DXGI_FORMAT_B8G8R8X8_UNORM,         4, 4, 1, { 0, 1, 2, 3 } },
+    { DXGI_FORMAT_B8G8R8A8_UNORM_SRGB,  DXGI_FORMAT_R8G8B8A8_UNORM_SRGB,    4, 4, 1, { 2, 1, 0, 3 } },
+    { DXGI_FORMAT_B8G8R8A8_UNORM_SRGB,  DXGI_FORMAT_B8G8R8X8_UNORM_SRGB,    4, 4, 1, { 0, 1, 2, 3 } },
+    { DXGI_FORMAT_B8G8R8X8_UNORM,       DXGI_FORMAT_R8G8B8A8_UNORM,         4, 4, 1, { 2, 1, 0, 3 } },
+    { DXGI_FORMAT_B8G8R8X8_UNORM,       DXGI_FORMAT_B8G8R8A8_UNORM,         4, 4, 1, { 0, 1, 2, 3 } },
+    { DXGI_FORMAT_B8G8R8X8_UNORM_SRGB,  DXGI_FORMAT_R8G8B8A8_UNORM_SRGB,    4, 4, 1, { 2, 1, 0, 3 } },
+    { DXGI_FORMAT_B8G8R8X8_UNORM_SRGB,  DXGI_FORMAT_B8G8R8A8_UNORM_SRGB,    4, 4, 1, { 0, 1, 2, 3 } },
+
+    // R and RG expansion to RGBA
+    { DXGI_FORMAT_R8_UNORM,             DXGI_FORMAT_R8G8B8A8_UNORM,         1, 4, 1, { 0, 0, 0, 0 } },
+    { DXGI_FORMAT_R8_UNORM,             DXGI_FORMAT_B8G8R8A8_UNORM,         1, 4, 1, { 0, 0, 0, 0 } },
+    { DXGI_FORMAT_R8G8_UNORM,           DXGI_FORMAT_R8G8B8A8_UNORM,         2, 4, 1, { 0, 1, 0, 0 } },
+    { DXGI_FORMAT_R8G8_UNORM,           DXGI_FORMAT_B8G8R8A8_UNORM,         2, 4, 1, { 0, 1, 0, 0 } },
+
+    // UNORM to float
+    { DXGI_FORMAT_R8G8B8A8_UNORM,       DXGI_FORMAT_R16G16B16A16_FLOAT,     4, 4, 2, { 0, 1, 2, 3 } },
+    { DXGI_FORMAT_R8G8B8A8_UNORM,       DXGI_FORMAT_R32G32B32A32_FLOAT,     4, 4, 4, { 0, 1, 2, 3 } },
+    { DXGI_FORMAT_B8G8R8A8_UNORM,       DXGI_FORMAT_R16G16B16A16_FLOAT,     4, 4, 2, { 2, 1, 0, 3 } },
+    { DXGI_FORMAT_B8G8R8A8_UNORM,       DXGI_FORMAT_R32G32B32A32_FLOAT,     4, 4, 4, { 2, 1, 0, 3 } },
+    { DXGI_FORMAT_B8G8R8X8_UNORM,       DXGI_FORMAT_R16G16B16A16_FLOAT,     4, 4, 2, { 2, 1, 0, 3 } },
+    { DXGI_FORMAT_B8G8R8X8_UNORM,       DXGI_FORMAT_R32G32B32A32_FLOAT,     4, 4, 4, { 2, 1, 0, 3 } },
+    { DXGI_FORMAT_R8G8_UNORM,           DXGI_FORMAT_R16G16_FLOAT,           2, 2, 2, { 0, 1 } },
+    { DXGI_FORMAT_R8G8_UNORM,           DXGI_FORMAT_R32G32_FLOAT,           2, 2, 4, { 0, 1 } },
+    { DXGI_FORMAT_R8_UNORM,             DXGI_FORMAT_R16_FLOAT,              1, 1, 2, { 0 } },
+    { DXGI_FORMAT_R8_UNORM,             DXGI_FORMAT_R32_FLOAT,              1, 1, 4, { 0 } },
+};
+
+// Number of pixels in the rows used to capture and check the kernels (one per byte value)
+static const size_t FAST_CONVERT_PROBE = 256;
+
+struct FastConvertPlan
+{
+    const FastConvertData*  data;
+    bool                    valid;
+    bool                    vector;             // The SIMD kernel reproduces every destination channel
+    bool                    divide;             // UNORM values are x / 255 rather than x * (1 / 255)
+    uint8_t                 shuffleMask[16];    // Source byte of each destination element (0x80 for constants)
+    uint8_t                 fillMask[16];       // Bits of the constant destination elements
+    std::vector<uint32_t>   lut;                // Destination value bits (256 per channel)
+};
+
+namespace
+{
+    //---------------------------------------------------------------------------------
+    // Scalar kernel, which handles any channel mapping and the ends of rows
+    template<typename T, size_t outChannels>
+    void _LookupRow( _In_ const FastConvertPlan& plan, _Out_writes_bytes_(width * outChannels * sizeof(T)) uint8_t* pDest,
+                     _In_reads_bytes_(width * plan.data->inBytes) const uint8_t* pSrc, _In_ size_t width )
+    {
+        const size_t inBytes = plan.data->inBytes;
+        const uint32_t* lut = plan.lut.data();
+
+        size_t channelSource[ outChannels ];
+        for( size_t c = 0; c < outChannels; ++c )
+        {
+            channelSource[c] = plan.data->channelSource[c];
+        }
+
+        T * __restrict dPtr = reinterpret_cast<T*>( pDest );
+        for( size_t x = 0; x < width; ++x, pSrc += inBytes, dPtr += outChannels )
+        {
+            for( size_t c = 0; c < outChannels; ++c )
+            {
+                dPtr[c] = static_cast<T>( lut[ c * 256 + pSrc[ channelSource[c] ] ] );
+            }
+        }
+    }
+
+    template<typename T>
+    void _LookupRow( _In_ const FastConvertPlan& plan, _Out_ uint8_t* pDest, _In_ const uint8_t* pSrc, _In_ size_t width )
+    {
+        switch( plan.data->outChannels )
+        {
+        case 4: _LookupRow<T, 4>( plan, pDest, pSrc, width ); break;
+        case 2: _LookupRow<T, 2>( plan, pDest, pSrc, width ); break;
+        case 1: _LookupRow<T, 1>( plan, pDest, pSrc, width ); break;
+        }
+    }
+
+    //---------------------------------------------------------------------------------
+    // UNORM8 to 4-byte pixels, 4 pixels at a time
+    template<size_t inBytes>
+    size_t _ShuffleRow( _In_ const FastConvertPlan& plan, _Out_writes_bytes_(width * 4) uint8_t* pDest,
+                        _In_reads_bytes_(width * inBytes) const uint8_t* pSrc, _In_ size_t width )
+    {
+        const __m128i shuffle = _mm_loadu_si128( reinterpret_cast<const __m128i*>( plan.shuffleMask ) );
+        const __m128i fill = _mm_loadu_si128( reinterpret_cast<const __m128i*>( plan.fillMask ) );
+
+        size_t x = 0;
+        for( ; x + 4 <= width; x += 4 )
+        {
+            __m128i v;
+            switch( inBytes )
+            {
+            case 4:
+                v = _mm_loadu_si128( reinterpret_cast<const __m128i*>( pSrc + x * 4 ) );
+                break;
+
+            case 2:
+                v = _mm_loadl_epi64( reinterpret_cast<const __m128i*>( pSrc + x * 2 ) );
+                break;
+
+            default:
+                {
+                    int t;
+                    memcpy( &t, pSrc + x, sizeof(t) );
+                    v = _mm_cvtsi32_si128( t );
+                }
+                break;
+            }
+
+            v = _mm_or_si128( _mm_shuffle_epi8( v, shuffle ), fill );
+            _mm_storeu_si128( reinterpret_cast<__m128i*>( pDest + x * 4 ), v );
+        }
+
+        return x;
+    }
+
+    //---------------------------------------------------------------------------------
+    // UNORM8 to float, matching XMLoadUByteN4 (multiply) or the R8_UNORM loader (divide)
+    template<bool divide>
+    inline __m128 _UNormToFloat( _In_ __m128i v )
+    {
+        __m128 f = _mm_cvtepi32_ps( v );
+        return divide ? _mm_div_ps( f, _mm_set1_ps( 255.f ) ) : _mm_mul_ps( f, _mm_set1_ps( 1.f / 255.f ) );
+    }
+
+    // Rounds to nearest even as XMConvertFloatToHalf does (only zero and normal halves are handled)
+    inline __m128i _FloatToHalf( _In_ __m128 v )
+    {
+        __m128i bits = _mm_castps_si128( v );
+        __m128i h = _mm_add_epi32( bits, _mm_set1_epi32( static_cast<int>( 0xC8000FFF ) ) );
+        h = _mm_add_epi32( h, _mm_and_si128( _mm_srli_epi32( bits, 13 ), _mm_set1_epi32( 1 ) ) );
+        h = _mm_and_si128( _mm_srli_epi32( h, 13 ), _mm_set1_epi32( 0x7FFF ) );
+        return _mm_andnot_si128( _mm_cmpeq_epi32( bits, _mm_setzero_si128() ), h );
+    }
+
+    template<typename T, bool divide>
+    inline __m128i _UNormToBits( _In_ __m128i v )
+    {
+        __m128 f = _UNormToFloat<divide>( v );
+        return ( sizeof(T) == sizeof(uint16_t) ) ? _FloatToHalf( f ) : _mm_castps_si128( f );
+    }
+
+    // UNORM8 to half or float, 16 source bytes at a time
+    template<typename T, bool divide>
+    size_t _UNormRow( _In_ const FastConvertPlan& plan, _Out_ uint8_t* pDest, _In_ const uint8_t* pSrc, _In_ size_t width )
+    {
+        const __m128i shuffle = _mm_loadu_si128( reinterpret_cast<const __m128i*>( plan.shuffleMask ) );
+        const __m128i fill = _mm_loadu_si128( reinterpret_cast<const __m128i*>( plan.fillMask ) );
+
+        const size_t outChannels = plan.data->outChannels;
+        const size_t pixels = 16 / plan.data->inBytes;
+
+        size_t x = 0;
+        for( ; x + pixels <= width; x += pixels )
+        {
+            __m128i v = _mm_shuffle_epi8( _mm_loadu_si128( reinterpret_cast<const __m128i*>( pSrc + x * plan.data->inBytes ) ), shuffle );
+
+            __m128i r0 = _mm_or_si128( _UNormToBits<T, divide>( _mm_cvtepu8_epi32( v ) ), fill );
+            __m128i r1 = _mm_or_si128( _UNormToBits<T, divide>( _mm_cvtepu8_epi32( _mm_srli_si128( v, 4 ) ) ), fill );
+            __m128i r2 = _mm_or_si128( _UNormToBits<T, divide>( _mm_cvtepu8_epi32( _mm_srli_si128( v, 8 ) ) ), fill );
+            __m128i r3 = _mm_or_si128( _UNormToBits<T, divide>( _mm_cvtepu8_epi32( _mm_srli_si128( v, 12 ) ) ), fill );
+
+            __m128i* dPtr = reinterpret_cast<__m128i*>( pDest + x * outChannels * sizeof(T) );
+            if ( sizeof(T) == sizeof(uint16_t) )
+            {
+                _mm_storeu_si128( dPtr, _mm_packus_epi32( r0, r1 ) );
+                _mm_storeu_si128( dPtr + 1, _mm_packus_epi32( r2, r3 ) );
+            }
+            else
+            {
+                _mm_storeu_si128( dPtr, r0 );
+                _mm_storeu_si128( dPtr + 1, r1 );
+                _mm_storeu_si128( dPtr + 2, r2 );
+                _mm_storeu_si128( dPtr + 3, r3 );
+            }
+        }
+
+        return x;
+    }
+
+    //---------------------------------------------------------------------------------
+    void _FastConvertRow( _In_ const FastConvertPlan& plan, _Out_ uint8_t* pDest, _In_ const uint8_t* pSrc, _In_ size_t width )
+    {
+        const FastConvertData& data = *plan.data;
+
+        size_t x = 0;
+        if ( plan.vector )
+        {
+            switch( data.outChannelBytes )
+            {
+            case 1:
+                switch( data.inBytes )
+                {
+                case 4: x = _ShuffleRow<4>( plan, pDest, pSrc, width ); break;
+                case 2: x = _ShuffleRow<2>( plan, pDest, pSrc, width ); break;
+                case 1: x = _ShuffleRow<1>( plan, pDest, pSrc, width ); break;
+                }
+                break;
+
+            case 2:
+                x = ( plan.divide ) ? _UNormRow<uint16_t, true>( plan, pDest, pSrc, width ) : _UNormRow<uint16_t, false>( plan, pDest, pSrc, width );
+                break;
+
+            case 4:
+                x = ( plan.divide ) ? _UNormRow<uint32_t, true>( plan, pDest, pSrc, width ) : _UNormRow<uint32_t, false>( plan, pDest, pSrc, width );
+                break;
+            }
+
+            if ( x == width )
+                return;
+        }
+
+        pDest += x * data.outChannels * data.outChannelBytes;
+        pSrc += x * data.inBytes;
+        width -= x;
+
+        switch( data.outChannelBytes )
+        {
+        case 1: _LookupRow<uint8_t>( plan, pDest, pSrc, width ); break;
+        case 2: _LookupRow<uint16_t>( plan, pDest, pSrc, width ); break;
+        case 4: _LookupRow<uint32_t>( plan, pDest, pSrc, width ); break;
+        }
+    }
+
+    //---------------------------------------------------------------------------------
+    // Runs a probe row through the generic (non-dithered) conversion path
+    bool _GenericConvertRow( _In_ const FastConvertData& data, _Out_ uint8_t* pDest, _In_ const uint8_t* pSrc, _Inout_ XMVECTOR* scanline )
+    {
+        const size_t outBytes = data.outChannels * data.outChannelBytes;
+
+        if ( !_LoadScanline( scanline, FAST_CONVERT_PROBE, pSrc, FAST_CONVERT_PROBE * data.inBytes, data.inFormat ) )
+            return false;
+
+        _ConvertScanline( scanline, FAST_CONVERT_PROBE, data.outFormat, data.inFormat, TEX_FILTER_DEFAULT );
+
+        return _StoreScanline( pDest, FAST_CONVERT_PROBE * outBytes, data.outFormat, scanline, FAST_CONVERT_PROBE, 0.f );
+    }
+
+    uint32_t _ReadChannel( _In_ const FastConvertData& data, _In_ const uint8_t* pDest, _In_ size_t x, _In_ size_t c )
+    {
+        const uint8_t* ptr = pDest + ( x * data.outChannels + c ) * data.outChannelBytes;
+        switch( data.outChannelBytes )
+        {
+        case 1:  return *ptr;
+        case 2:  return *reinterpret_cast<const uint16_t*>( ptr );
+        default: return *reinterpret_cast<const uint32_t*>( ptr );
+        }
+    }
+
+    // Checks whether the SIMD kernel computes a destination channel the way the generic path does
+    bool _IsVectorChannel( _In_ const FastConvertPlan& plan, _In_ size_t c, _In_ bool divide )
+    {
+        const size_t outChannelBytes = plan.data->outChannelBytes;
+
+        for( size_t x = 0; x < 256; ++x )
+        {
+            uint32_t bits;
+            __m128i v = _mm_cvtsi32_si128( static_cast<int>( x ) );
+
+            if ( outChannelBytes == 1 )
+                bits = static_cast<uint32_t>( x );
+            else if ( outChannelBytes == 2 )
+                bits = _mm_cvtsi128_si32( divide ? _UNormToBits<uint16_t, true>( v ) : _UNormToBits<uint16_t, false>( v ) );
+            else
+                bits = _mm_cvtsi128_si32( divide ? _UNormToBits<uint32_t, true>( v ) : _UNormToBits<uint32_t, false>( v ) );
+
+            if ( plan.lut[ c * 256 + x ] != bits )
+                return false;
+        }
+
+        return true;
+    }
+
+    bool _IsConstantChannel( _In_ const FastConvertPlan& plan, _In_ size_t c )
+    {
+        for( size_t x = 1; x < 256; ++x )
+        {
+            if ( plan.lut[ c * 256 + x ] != plan.lut[ c * 256 ] )
+                return false;
+        }
+
+        return true;
+    }
+
+    // Sets up the masks of the SIMD kernels, where source byte e is gathered for destination element e
+    bool _BuildVectorMasks( _Inout_ FastConvertPlan& plan, _In_ bool divide )
+    {
+        const FastConvertData& data = *plan.data;
+
+        memset( plan.fillMask, 0, sizeof(plan.fillMask) );
+
+        for( size_t e = 0; e < 16; ++e )
+        {
+            const size_t p = e / data.outChannels;
+            const size_t c = e % data.outChannels;
+
+            if ( _IsVectorChannel( plan, c, divide ) )
+            {
+                plan.shuffleMask[e] = static_cast<uint8_t>( p * data.inBytes + data.channelSource[c] );
+            }
+            else if ( _IsConstantChannel( plan, c ) )
+            {
+                // Zero converts to zero bits, so the constant is or'ed in
+                plan.shuffleMask[e] = 0x80;
+
+                if ( data.outChannelBytes == 1 )
+                {
+                    plan.fillMask[e] = static_cast<uint8_t>( plan.lut[ c * 256 ] );
+                }
+                else if ( e < 4 )
+                {
+                    // Half and float elements are expanded to a 32-bit lane each
+                    memcpy( &plan.fillMask[ e * 4 ], &plan.lut[ c * 256 ], sizeof(uint32_t) );
+                }
+            }
+            else
+            {
+                return false;
+            }
+        }
+
+        plan.divide = divide;
+        return true;
+    }
+
+    //---------------------------------------------------------------------------------
+    // Captures the generic path output for every byte value and checks the kernels against it
+    void _BuildFastConvertPlan( _In_ const FastConvertData& data, _Out_ FastConvertPlan& plan )
+    {
+        plan.data = &data;
+        plan.valid = false;
+        plan.vector = false;
+        plan.divide = false;
+
+        const size_t outBytes = data.outChannels * data.outChannelBytes;
+
+        ScopedAlignedArrayXMVECTOR scanline( reinterpret_cast<XMVECTOR*>( _aligned_malloc( sizeof(XMVECTOR) * FAST_CONVERT_PROBE, 16 ) ) );
+        if ( !scanline )
+            return;
+
+        std::vector<uint8_t> source( FAST_CONVERT_PROBE * data.inBytes );
+        std::vector<uint8_t> expected( FAST_CONVERT_PROBE * outBytes );
+        std::vector<uint8_t> actual( FAST_CONVERT_PROBE * outBytes );
+
+        // Every byte of pixel x is x
+        for( size_t x = 0; x < FAST_CONVERT_PROBE; ++x )
+        {
+            memset( &source[ x * data.inBytes ], static_cast<int>( x ), data.inBytes );
+        }
+
+        if ( !_GenericConvertRow( data, expected.data(), source.data(), scanline.get() ) )
+            return;
+
+        plan.lut.resize( data.outChannels * 256 );
+        for( size_t x = 0; x < FAST_CONVERT_PROBE; ++x )
+        {
+            for( size_t c = 0; c < data.outChannels; ++c )
+            {
+                plan.lut[ c * 256 + x ] = _ReadChannel( data, expected.data(), x, c );
+            }
+        }
+
+        // The byte kernel writes 4-byte pixels, the others read 16 bytes for 16 elements
+        if ( ( data.outChannelBytes == 1 ) ? ( data.outChannels == 4 ) : ( data.inBytes == data.outChannels ) )
+        {
+            plan.vector = _BuildVectorMasks( plan, false ) || _BuildVectorMasks( plan, true );
+        }
+
+        // The bytes of each pixel differ, so reading the wrong source byte is caught
+        for( size_t x = 0; x < FAST_CONVERT_PROBE; ++x )
+        {
+            for( size_t b = 0; b < data.inBytes; ++b )
+            {
+                source[ x * data.inBytes + b ] = static_cast<uint8_t>( x * 7 + b * 67 + 13 );
+            }
+        }
+
+        if ( !_GenericConvertRow( data, expected.data(), source.data(), scanline.get() ) )
+            return;
+
+        _FastConvertRow( plan, actual.data(), source.data(), FAST_CONVERT_PROBE );
+
+        plan.valid = ( memcmp( actual.data(), expected.data(), actual.size() ) == 0 );
+    }
+
+    //---------------------------------------------------------------------------------
+    // Specialized conversions are only used where the generic path has no per-pixel math
+    bool _IsFastConvertFilter( _In_ DWORD filter, _In_ DXGI_FORMAT sformat, _In_ DXGI_FORMAT tformat )
+    {
+        if ( filter & ( TEX_FILTER_DITHER | TEX_FILTER_DITHER_DIFFUSION ) )
+            return false;
+
+        filter &= TEX_FILTER_SRGB;
+
+        if ( IsSRGB( sformat ) )
+            filter |= TEX_FILTER_SRGB_IN;
+
+        if ( IsSRGB( tformat ) )
+            filter |= TEX_FILTER_SRGB_OUT;
+
+        // Matching color spaces cancel out, as in _ConvertScanline
+        return ( filter == 0 ) || ( filter == TEX_FILTER_SRGB );
+    }
+}
+
+static const FastConvertPlan* _FindFastConvert( _In_ DWORD filter, _In_ DXGI_FORMAT sformat, _In_ DXGI_FORMAT tformat )
+{
+    if ( !_IsFastConvertFilter( filter, sformat, tformat ) )
+        return nullptr;
+
+    for( size_t index = 0; index < _countof(g_FastConvertTable); ++index )
+    {
+        if ( g_FastConvertTable[index].inFormat != sformat || g_FastConvertTable[index].outFormat != tformat )
+            continue;
+
+        static const std::vector<FastConvertPlan> s_plans = []()
+        {
+            std::vector<FastConvertPlan> plans( _countof(g_FastConvertTable) );
+            for( size_t i = 0; i < plans.size(); ++i )
+            {
+                _BuildFastConvertPlan( g_FastConvertTable[i], plans[i] );
+            }
+            return plans;
+        }();
+
+        return s_plans[index].valid ? &s_plans[index] : nullptr;
+    }
+
+    return nullptr;
+}
+
+
 //-------------------------------------------------------------------------------------
 // Selection logic for using WIC vs. our own routines
 //-------------------------------------------------------------------------------------
@@ -4105,6 +4569,12 @@ static inline bool _UseWICConversion( _In_ DWORD filter, _In_ DXGI_FORMAT sforma
         return false;
     }
 
+    if ( _FindFastConvert( filter, sformat, tformat ) )
+    {
+        // Specialized conversions are faster than WIC and match the non-WIC code paths
+        return false;
+    }
+
 #if defined(_XBOX_ONE) && defined(_TITLE)
     if ( sformat == DXGI_FORMAT_R16G16B16A16_FLOAT
          || sformat == DXGI_FORMAT_R16_FLOAT
@@ -4248,6 +4718,20 @@ static HRESULT _Convert( _In_ const Image& srcImage, _In_ DWORD filter, _In_ con
 
     size_t width = srcImage.width;
 
+    const FastConvertPlan* plan = _FindFastConvert( filter, srcImage.format, destImage.format );
+    if ( plan )
+    {
+        for( size_t h = 0; h < srcImage.height; ++h )
+        {
+            _FastConvertRow( *plan, pDest, pSrc, width );
+
+            pSrc += srcImage.rowPitch;
+            pDest += destImage.rowPitch;
+        }
+
+        return S_OK;
+    }
+
     if ( filter & TEX_FILTER_DITHER_DIFFUSION )
     {
         // Error diffusion dithering (aka Floyd-Steinberg dithering)
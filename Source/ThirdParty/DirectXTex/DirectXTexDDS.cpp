@@ -1638,6 +1638,137 @@ HRESULT LoadFromDDSFile( LPCWSTR szFile, DWORD flags, TexMetadata* metadata, Scr
 }
 
 
+//-------------------------------------------------------------------------------------
+// Create a view of a DDS file in memory
+//-------------------------------------------------------------------------------------
+_Use_decl_annotations_
+HRESULT LoadFromDDSMemory( LPCVOID pSource, size_t size, DWORD flags, TexMetadata* metadata, ImageView& view )
+{
+    if ( !pSource || size == 0 )
+        return E_INVALIDARG;
+
+    view.Release();
+
+    DWORD convFlags = 0;
+    TexMetadata mdata;
+    HRESULT hr = _DecodeDDSHeader( pSource, size, flags, mdata, convFlags );
+    if ( FAILED(hr) )
+        return hr;
+
+    if ( convFlags & (CONV_FLAGS_EXPAND | CONV_FLAGS_SWIZZLE | CONV_FLAGS_NOALPHA) )
+    {
+        // Legacy formats have to be converted, so the view holds a copy of the pixels
+        ScratchImage image;
+        hr = LoadFromDDSMemory( pSource, size, flags, nullptr, image );
+        if ( FAILED(hr) )
+            return hr;
+
+        hr = view.Initialize( std::move(image) );
+    }
+    else
+    {
+        size_t offset = sizeof(uint32_t) + sizeof(DDS_HEADER);
+        if ( convFlags & CONV_FLAGS_DX10 )
+            offset += sizeof(DDS_HEADER_DXT10);
+
+        assert( offset <= size );
+
+        if ( size == offset )
+            return E_FAIL;
+
+        // The pixels are already laid out the way Direct3D expects them (with DWORD-aligned rows for legacy writers)
+        auto pPixels = reinterpret_cast<LPCVOID>( reinterpret_cast<const uint8_t*>(pSource) + offset );
+        hr = view.Initialize( mdata, pPixels, size - offset,
+                              (flags & DDS_FLAGS_LEGACY_DWORD) ? CP_FLAGS_LEGACY_DWORD : CP_FLAGS_NONE );
+    }
+
+    if ( FAILED(hr) )
+        return hr;
+
+    if ( metadata )
+        memcpy( metadata, &view.GetMetadata(), sizeof(TexMetadata) );
+
+    return S_OK;
+}
+
+
+//-------------------------------------------------------------------------------------
+// Create a view of a DDS file on disk
+//-------------------------------------------------------------------------------------
+_Use_decl_annotations_
+HRESULT LoadFromDDSFile( LPCWSTR szFile, DWORD flags, TexMetadata* metadata, ImageView& view )
+{
+    if ( !szFile )
+        return E_INVALIDARG;
+
+    view.Release();
+
+#if (_WIN32_WINNT >= _WIN32_WINNT_WIN8)
+    ScopedHandle hFile( safe_handle ( CreateFile2( szFile, GENERIC_READ, FILE_SHARE_READ, OPEN_EXISTING, 0 ) ) );
+#else
+    ScopedHandle hFile( safe_handle ( CreateFileW( szFile, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING,
+                                                   FILE_FLAG_RANDOM_ACCESS, 0 ) ) );
+#endif
+
+    if ( !hFile )
+    {
+        return HRESULT_FROM_WIN32( GetLastError() );
+    }
+
+    // Get the file size
+    LARGE_INTEGER fileSize = {0};
+
+#if (_WIN32_WINNT >= _WIN32_WINNT_VISTA)
+    FILE_STANDARD_INFO fileInfo;
+    if ( !GetFileInformationByHandleEx( hFile.get(), FileStandardInfo, &fileInfo, sizeof(fileInfo) ) )
+    {
+        return HRESULT_FROM_WIN32( GetLastError() );
+    }
+    fileSize = fileInfo.EndOfFile;
+#else
+    if ( !GetFileSizeEx( hFile.get(), &fileSize ) )
+    {
+        return HRESULT_FROM_WIN32( GetLastError() );
+    }
+#endif
+
+    // File is too big for 32-bit allocation, so reject read (4 GB should be plenty large enough for a valid DDS file)
+    if ( fileSize.HighPart > 0 )
+    {
+        return HRESULT_FROM_WIN32( ERROR_FILE_TOO_LARGE );
+    }
+
+    // Need at least enough data to fill the standard header and magic number to be a valid DDS
+    if ( fileSize.LowPart < ( sizeof(DDS_HEADER) + sizeof(uint32_t) ) )
+    {
+        return E_FAIL;
+    }
+
+    // The view of the file stays mapped after the handles are closed, so the pixels are paged in from the file cache on demand
+    ScopedHandle hMapping( CreateFileMappingW( hFile.get(), 0, PAGE_READONLY, 0, 0, 0 ) );
+    if ( !hMapping )
+    {
+        return HRESULT_FROM_WIN32( GetLastError() );
+    }
+
+    ScopedMapView mapView( MapViewOfFile( hMapping.get(), FILE_MAP_READ, 0, 0, 0 ) );
+    if ( !mapView )
+    {
+        return HRESULT_FROM_WIN32( GetLastError() );
+    }
+
+    HRESULT hr = LoadFromDDSMemory( mapView.get(), fileSize.LowPart, flags, metadata, view );
+    if ( FAILED(hr) )
+        return hr;
+
+    // A converted copy does not refer to the file, which can then be unmapped right away
+    if ( !view.IsCopy() )
+        view._mapping = mapView.release();
+
+    return S_OK;
+}
+
+
 //-------------------------------------------------------------------------------------
 // Save a DDS file to memory
 //-------------------------------------------------------------------------------------
@@ -0,0 +1,195 @@
+//-------------------------------------------------------------------------------------
+// DirectXTexExecutor.cpp
+//
+// DirectX Texture Library - Task execution
+//
+// THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A
+// PARTICULAR PURPOSE.
+//
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// http://go.microsoft.com/fwlink/?LinkId=248926
+//-------------------------------------------------------------------------------------
+
+#include "directxtexp.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace DirectX
+{
+
+namespace
+{
+    //---------------------------------------------------------------------------------
+    // Tasks submitted by a single Run() call
+    //---------------------------------------------------------------------------------
+    class TaskBatch
+    {
+    public:
+        TaskBatch( _In_ size_t count, _In_ const std::function<void __cdecl(size_t)>& task ) :
+            m_task( task ),
+            m_count( count ),
+            m_next( 0 ),
+            m_pending( count )
+        {
+        }
+
+        // Executes tasks until there are none left to start
+        void Work()
+        {
+            for( size_t index = m_next++; index < m_count; index = m_next++ )
+            {
+                m_task( index );
+
+                if ( --m_pending == 0 )
+                {
+                    std::lock_guard<std::mutex> lock( m_mutex );
+                    m_completed.notify_all();
+                }
+            }
+        }
+
+        bool IsExhausted() const { return m_next >= m_count; }
+
+        // Blocks until all tasks have completed
+        void Wait()
+        {
+            std::unique_lock<std::mutex> lock( m_mutex );
+            m_completed.wait( lock, [this]() { return m_pending == 0; } );
+        }
+
+    private:
+        TaskBatch( const TaskBatch& ) = delete;
+        TaskBatch& operator=( const TaskBatch& ) = delete;
+
+        const std::function<void __cdecl(size_t)>&  m_task;
+        const size_t                                m_count;
+        std::atomic<size_t>                         m_next;
+        std::atomic<size_t>                         m_pending;
+        std::mutex                                  m_mutex;
+        std::condition_variable                     m_completed;
+    };
+
+
+    //---------------------------------------------------------------------------------
+    // Pool of worker threads which pick tasks from the oldest batch first
+    //---------------------------------------------------------------------------------
+    class SharedTaskExecutor : public ITaskExecutor
+    {
+    public:
+        SharedTaskExecutor() :
+            m_shutdown( false )
+        {
+            // The thread calling Run() executes tasks as well
+            const unsigned nthreads = std::thread::hardware_concurrency();
+
+            for( unsigned i = 1; i < nthreads; ++i )
+            {
+                m_threads.emplace_back( &SharedTaskExecutor::WorkerLoop, this );
+            }
+        }
+
+        ~SharedTaskExecutor()
+        {
+            {
+                std::lock_guard<std::mutex> lock( m_mutex );
+                m_shutdown = true;
+            }
+
+            m_wake.notify_all();
+
+            for( auto& thread : m_threads )
+            {
+                thread.join();
+            }
+        }
+
+        virtual void __cdecl Run( _In_ size_t count, _In_ const std::function<void __cdecl(size_t)>& task ) override
+        {
+            if ( count <= 1 || m_threads.empty() )
+            {
+                for( size_t index = 0; index < count; ++index )
+                {
+                    task( index );
+                }
+                return;
+            }
+
+            // Workers keep the batch alive while they are inside Work()
+            auto batch = std::make_shared<TaskBatch>( count, task );
+
+            {
+                std::lock_guard<std::mutex> lock( m_mutex );
+                m_batches.push_back( batch );
+            }
+
+            m_wake.notify_all();
+
+            // Helping (rather than only waiting) keeps nested and concurrent calls from starving
+            batch->Work();
+            batch->Wait();
+
+            std::lock_guard<std::mutex> lock( m_mutex );
+            auto it = std::find( m_batches.begin(), m_batches.end(), batch );
+            if ( it != m_batches.end() )
+                m_batches.erase( it );
+        }
+
+    private:
+        SharedTaskExecutor( const SharedTaskExecutor& ) = delete;
+        SharedTaskExecutor& operator=( const SharedTaskExecutor& ) = delete;
+
+        void WorkerLoop()
+        {
+            std::unique_lock<std::mutex> lock( m_mutex );
+
+            for(;;)
+            {
+                m_wake.wait( lock, [this]() { return m_shutdown || !m_batches.empty(); } );
+
+                if ( m_shutdown )
+                    return;
+
+                std::shared_ptr<TaskBatch> batch = m_batches.front();
+                if ( batch->IsExhausted() )
+                {
+                    // The remaining tasks are running, so move on to the next batch
+                    m_batches.pop_front();
+                    continue;
+                }
+
+                lock.unlock();
+                batch->Work();
+                lock.lock();
+            }
+        }
+
+        std::mutex                              m_mutex;
+        std::condition_variable                 m_wake;
+        std::deque<std::shared_ptr<TaskBatch>>  m_batches;
+        std::vector<std::thread>                m_threads;
+        bool                                    m_shutdown;
+    };
+}
+
+
+//=====================================================================================
+// Entry-points
+//=====================================================================================
+
+//-------------------------------------------------------------------------------------
+// Returns the executor shared by all callers within the process
+//-------------------------------------------------------------------------------------
+ITaskExecutor* GetSharedTaskExecutor()
+{
+    static SharedTaskExecutor s_executor;
+    return &s_executor;
+}
+
+}; // namespace
@@ -225,36 +225,10 @@ bool _SetupImageArray( uint8_t *pMemory, size_t pixelSize,
 }
 
 
-//=====================================================================================
-// ScratchImage - Bitmap image container
-//=====================================================================================
-
-ScratchImage& ScratchImage::operator= (ScratchImage&& moveFrom)
-{
-    if ( this != &moveFrom )
-    {
-        Release();
-
-        _nimages = moveFrom._nimages;
-        _size = moveFrom._size;
-        _metadata = moveFrom._metadata;
-        _image = moveFrom._image;
-        _memory = moveFrom._memory;
-
-        moveFrom._nimages = 0;
-        moveFrom._size = 0;
-        moveFrom._image = nullptr;
-        moveFrom._memory = nullptr;
-    }
-    return *this;
-}
-
-
 //-------------------------------------------------------------------------------------
-// Methods
+// Validates the metadata of an image array, and computes the number of mip levels
 //-------------------------------------------------------------------------------------
-_Use_decl_annotations_
-HRESULT ScratchImage::Initialize( const TexMetadata& mdata, DWORD flags )
+static HRESULT _ValidateMetadata( _In_ const TexMetadata& mdata, _Out_ size_t& mipLevels )
 {
     if ( !IsValid(mdata.format) )
         return E_INVALIDARG;
@@ -262,7 +236,7 @@ HRESULT ScratchImage::Initialize( const TexMetadata& mdata, DWORD flags )
     if ( IsPalettized(mdata.format) )
         return HRESULT_FROM_WIN32( ERROR_NOT_SUPPORTED );
 
-    size_t mipLevels = mdata.mipLevels;
+    mipLevels = mdata.mipLevels;
 
     switch( mdata.dimension )
     {
@@ -300,6 +274,57 @@ HRESULT ScratchImage::Initialize( const TexMetadata& mdata, DWORD flags )
         return HRESULT_FROM_WIN32( ERROR_NOT_SUPPORTED );
     }
 
+    return S_OK;
+}
+
+
+//=====================================================================================
+// ScratchImage - Bitmap image container
+//=====================================================================================
+
+ScratchImage& ScratchImage::operator= (ScratchImage&& moveFrom)
+{
+    if ( this != &moveFrom )
+    {
+        Release();
+        RetainBuffers( false );
+
+        _nimages = moveFrom._nimages;
+        _size = moveFrom._size;
+        _metadata = moveFrom._metadata;
+        _image = moveFrom._image;
+        _memory = moveFrom._memory;
+        _retain = moveFrom._retain;
+        _spareImageCount = moveFrom._spareImageCount;
+        _spareSize = moveFrom._spareSize;
+        _spareImage = moveFrom._spareImage;
+        _spareMemory = moveFrom._spareMemory;
+
+        moveFrom._nimages = 0;
+        moveFrom._size = 0;
+        moveFrom._image = nullptr;
+        moveFrom._memory = nullptr;
+        moveFrom._retain = false;
+        moveFrom._spareImageCount = 0;
+        moveFrom._spareSize = 0;
+        moveFrom._spareImage = nullptr;
+        moveFrom._spareMemory = nullptr;
+    }
+    return *this;
+}
+
+
+//-------------------------------------------------------------------------------------
+// Methods
+//-------------------------------------------------------------------------------------
+_Use_decl_annotations_
+HRESULT ScratchImage::Initialize( const TexMetadata& mdata, DWORD flags )
+{
+    size_t mipLevels;
+    HRESULT hr = _ValidateMetadata( mdata, mipLevels );
+    if ( FAILED(hr) )
+        return hr;
+
     Release();
 
     _metadata.width = mdata.width;
@@ -315,15 +340,13 @@ HRESULT ScratchImage::Initialize( const TexMetadata& mdata, DWORD flags )
     size_t pixelSize, nimages;
     _DetermineImageArray( _metadata, flags, nimages, pixelSize );
 
-    _image = new (std::nothrow) Image[ nimages ];
-    if ( !_image )
+    if ( !_AllocateImages( nimages ) )
         return E_OUTOFMEMORY;
 
     _nimages = nimages;
     memset( _image, 0, sizeof(Image) * nimages );
 
-    _memory = reinterpret_cast<uint8_t*>( _aligned_malloc( pixelSize, 16 ) );
-    if ( !_memory )
+    if ( !_AllocatePixels( pixelSize ) )
     {
         Release();
         return E_OUTOFMEMORY;
@@ -381,15 +404,13 @@ HRESULT ScratchImage::Initialize2D( DXGI_FORMAT fmt, size_t width, size_t height
     size_t pixelSize, nimages;
     _DetermineImageArray( _metadata, flags, nimages, pixelSize );
 
-    _image = new (std::nothrow) Image[ nimages ];
-    if ( !_image )
+    if ( !_AllocateImages( nimages ) )
         return E_OUTOFMEMORY;
 
     _nimages = nimages;
     memset( _image, 0, sizeof(Image) * nimages );
 
-    _memory = reinterpret_cast<uint8_t*>( _aligned_malloc( pixelSize, 16 ) );
-    if ( !_memory )
+    if ( !_AllocatePixels( pixelSize ) )
     {
         Release();
         return E_OUTOFMEMORY;
@@ -431,8 +452,7 @@ HRESULT ScratchImage::Initialize3D( DXGI_FORMAT fmt, size_t width, size_t height
     size_t pixelSize, nimages;
     _DetermineImageArray( _metadata, flags, nimages, pixelSize );
 
-    _image = new (std::nothrow) Image[ nimages ];
-    if ( !_image )
+    if ( !_AllocateImages( nimages ) )
     {
         Release();
         return E_OUTOFMEMORY;
@@ -440,8 +460,7 @@ HRESULT ScratchImage::Initialize3D( DXGI_FORMAT fmt, size_t width, size_t height
     _nimages = nimages;
     memset( _image, 0, sizeof(Image) * nimages );
 
-    _memory = reinterpret_cast<uint8_t*>( _aligned_malloc( pixelSize, 16 ) );
-    if ( !_memory )
+    if ( !_AllocatePixels( pixelSize ) )
     {
         Release();
         return E_OUTOFMEMORY;
@@ -651,21 +670,97 @@ void ScratchImage::Release()
     _nimages = 0;
     _size = 0;
 
+    // Spare buffers are only freed by RetainBuffers( false )
     if ( _image )
     {
-        delete [] _image;
+        if ( _image != _spareImage )
+            delete [] _image;
         _image = 0;
     }
 
     if ( _memory )
     {
-        _aligned_free( _memory );
+        if ( _memory != _spareMemory )
+            _aligned_free( _memory );
         _memory = 0;
     }
     
     memset(&_metadata, 0, sizeof(_metadata));
 }
 
+_Use_decl_annotations_
+void ScratchImage::RetainBuffers( bool retain )
+{
+    _retain = retain;
+    if ( retain )
+        return;
+
+    // Buffers which are in use are now owned by the current image, and freed by Release()
+    if ( _spareImage != _image )
+        delete [] _spareImage;
+    _spareImage = nullptr;
+    _spareImageCount = 0;
+
+    if ( _spareMemory != _memory )
+        _aligned_free( _spareMemory );
+    _spareMemory = nullptr;
+    _spareSize = 0;
+}
+
+_Use_decl_annotations_
+bool ScratchImage::_AllocateImages( size_t nimages )
+{
+    assert( !_image );
+
+    if ( !_retain )
+    {
+        _image = new (std::nothrow) Image[ nimages ];
+        return ( _image != nullptr );
+    }
+
+    if ( _spareImageCount < nimages )
+    {
+        delete [] _spareImage;
+        _spareImageCount = 0;
+
+        _spareImage = new (std::nothrow) Image[ nimages ];
+        if ( !_spareImage )
+            return false;
+
+        _spareImageCount = nimages;
+    }
+
+    _image = _spareImage;
+    return true;
+}
+
+_Use_decl_annotations_
+bool ScratchImage::_AllocatePixels( size_t pixelSize )
+{
+    assert( !_memory );
+
+    if ( !_retain )
+    {
+        _memory = reinterpret_cast<uint8_t*>( _aligned_malloc( pixelSize, 16 ) );
+        return ( _memory != nullptr );
+    }
+
+    if ( _spareSize < pixelSize )
+    {
+        _aligned_free( _spareMemory );
+        _spareSize = 0;
+
+        _spareMemory = reinterpret_cast<uint8_t*>( _aligned_malloc( pixelSize, 16 ) );
+        if ( !_spareMemory )
+            return false;
+
+        _spareSize = pixelSize;
+    }
+
+    _memory = _spareMemory;
+    return true;
+}
+
 _Use_decl_annotations_
 bool ScratchImage::OverrideFormat( DXGI_FORMAT f )
 {
@@ -791,4 +886,145 @@ bool ScratchImage::IsAlphaAllOpaque() const
     return true;
 }
 
+
+//=====================================================================================
+// ImageView - Image container which refers to pixels stored elsewhere
+//=====================================================================================
+
+ImageView& ImageView::operator= (ImageView&& moveFrom)
+{
+    if ( this != &moveFrom )
+    {
+        Release();
+
+        _nimages = moveFrom._nimages;
+        _size = moveFrom._size;
+        _metadata = moveFrom._metadata;
+        _image = moveFrom._image;
+        _pixels = moveFrom._pixels;
+        _copy = std::move( moveFrom._copy );
+        _mapping = moveFrom._mapping;
+
+        moveFrom._nimages = 0;
+        moveFrom._size = 0;
+        moveFrom._image = nullptr;
+        moveFrom._pixels = nullptr;
+        moveFrom._mapping = nullptr;
+    }
+    return *this;
+}
+
+
+//-------------------------------------------------------------------------------------
+// Methods
+//-------------------------------------------------------------------------------------
+_Use_decl_annotations_
+HRESULT ImageView::Initialize( const TexMetadata& mdata, LPCVOID pixels, size_t size, DWORD flags )
+{
+    if ( !pixels || !size )
+        return E_INVALIDARG;
+
+    size_t mipLevels;
+    HRESULT hr = _ValidateMetadata( mdata, mipLevels );
+    if ( FAILED(hr) )
+        return hr;
+
+    Release();
+
+    _metadata = mdata;
+    _metadata.mipLevels = mipLevels;
+
+    size_t pixelSize, nimages;
+    _DetermineImageArray( _metadata, flags, nimages, pixelSize );
+
+    // The pixels are laid out as if by ScratchImage::Initialize, so they have to cover the entire image array
+    if ( pixelSize > size )
+    {
+        Release();
+        return E_FAIL;
+    }
+
+    _image = new (std::nothrow) Image[ nimages ];
+    if ( !_image )
+    {
+        Release();
+        return E_OUTOFMEMORY;
+    }
+
+    _nimages = nimages;
+    memset( _image, 0, sizeof(Image) * nimages );
+
+    // The pixels are never written through the view, but Image only holds non-const pointers
+    if ( !_SetupImageArray( const_cast<uint8_t*>( reinterpret_cast<const uint8_t*>( pixels ) ), pixelSize, _metadata, flags, _image, nimages ) )
+    {
+        Release();
+        return E_FAIL;
+    }
+
+    _pixels = reinterpret_cast<const uint8_t*>( pixels );
+    _size = pixelSize;
+
+    return S_OK;
+}
+
+_Use_decl_annotations_
+HRESULT ImageView::Initialize( ScratchImage&& image )
+{
+    const size_t nimages = image.GetImageCount();
+    if ( !nimages || !image.GetPixels() )
+        return E_INVALIDARG;
+
+    Release();
+
+    _image = new (std::nothrow) Image[ nimages ];
+    if ( !_image )
+        return E_OUTOFMEMORY;
+
+    memcpy( _image, image.GetImages(), sizeof(Image) * nimages );
+
+    _nimages = nimages;
+    _size = image.GetPixelsSize();
+    _metadata = image.GetMetadata();
+    _pixels = image.GetPixels();
+    _copy = std::move( image );
+
+    return S_OK;
+}
+
+void ImageView::Release()
+{
+    _nimages = 0;
+    _size = 0;
+
+    if ( _image )
+    {
+        delete [] _image;
+        _image = nullptr;
+    }
+
+    _pixels = nullptr;
+    _copy.Release();
+
+    if ( _mapping )
+    {
+        UnmapViewOfFile( _mapping );
+        _mapping = nullptr;
+    }
+
+    memset(&_metadata, 0, sizeof(_metadata));
+}
+
+_Use_decl_annotations_
+const Image* ImageView::GetImage(size_t mip, size_t item, size_t slice) const
+{
+    if ( !_image )
+        return nullptr;
+
+    size_t index = _metadata.ComputeIndex( mip, item, slice );
+    if ( index >= _nimages )
+        return nullptr;
+
+    return &_image[index];
+}
+
 }; // namespace
@@ -17,6 +17,9 @@
 
 #include "filters.h"
 
+#include <math.h>
+#include <smmintrin.h>
+
 using Microsoft::WRL::ComPtr;
 
 namespace DirectX
@@ -30,6 +33,21 @@ inline static bool ispow2( _In_ size_t x )
     return ((x != 0) && !(x & (x - 1)));
 }
 
+inline static bool _IsRGBA8( _In_ DXGI_FORMAT format )
+{
+    switch( format )
+    {
+    case DXGI_FORMAT_R8G8B8A8_UNORM:
+    case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:
+    case DXGI_FORMAT_B8G8R8A8_UNORM:
+    case DXGI_FORMAT_B8G8R8A8_UNORM_SRGB:
+        return true;
+
+    default:
+        return false;
+    }
+}
+
 
 //--- mipmap (1D/2D) levels computation ---
 static size_t _CountMips( _In_ size_t width, _In_ size_t height )
@@ -388,6 +406,12 @@ static bool _UseWICFiltering( _In_ DXGI_FORMAT format, _In_ DWORD filter )
         return true;
     }
 
+    if ( _IsRGBA8(format) && ( !(filter & TEX_FILTER_MASK) || (filter & TEX_FILTER_MASK) == TEX_FILTER_BOX ) )
+    {
+        // Use the SIMD box filter for 8-bit RGBA formats
+        return false;
+    }
+
     if ( IsSRGB(format) || (filter & TEX_FILTER_SRGB) )
     {
         // Use non-WIC code paths for sRGB correct filtering
@@ -436,6 +460,7 @@ static bool _UseWICFiltering( _In_ DXGI_FORMAT format, _In_ DWORD filter )
         break;
 
     case TEX_FILTER_TRIANGLE:
+    case TEX_FILTER_LANCZOS3:
         // WIC does not implement this filter
         return false;
     }
@@ -808,6 +833,245 @@ static HRESULT _Generate2DMipsBoxFilter( _In_ size_t levels, _In_ DWORD filter,
 }
 
 
+//--- 2D Box Filter for 8-bit RGBA formats ---
+// Downsamples 2x2 blocks in linear space using table-based sRGB conversions and SSE4.1.
+// Odd dimensions use 3-tap filters which weigh each source texel by its coverage of the
+// destination texel, so non-power-of-2 images keep their average intensity.
+namespace
+{
+    const size_t SRGB_BUCKETS = 4096;
+
+    struct SRGBTables
+    {
+        float   toLinear[256];              // sRGB code -> linear value
+        float   toUnorm[256];               // UNORM code -> value
+        float   thresholds[257];            // Smallest linear value which encodes to the sRGB code
+        uint8_t toSRGB[SRGB_BUCKETS];       // Linear value bucket -> sRGB code of its lower bound
+    };
+
+    // Source texels (and their weights) covered by a destination texel
+    struct BoxTaps
+    {
+        size_t  index;                      // First source texel
+        size_t  count;                      // 1, 2 or 3
+        float   weights[3];
+    };
+
+    inline double _SRGBToLinear( _In_ double v )
+    {
+        return ( v <= 0.04045 ) ? v / 12.92 : pow( ( v + 0.055 ) / 1.055, 2.4 );
+    }
+
+    const SRGBTables& _GetSRGBTables()
+    {
+        static const SRGBTables s_tables = []()
+        {
+            SRGBTables t;
+            for( size_t i = 0; i < 256; ++i )
+            {
+                t.toLinear[i] = float( _SRGBToLinear( double(i) / 255.0 ) );
+                t.toUnorm[i] = float(i) / 255.f;
+            }
+
+            // Code k is the nearest one for the values between the midpoints (k -/+ 0.5) / 255
+            t.thresholds[0] = -1.f;
+            for( size_t i = 1; i < 256; ++i )
+            {
+                t.thresholds[i] = float( _SRGBToLinear( ( double(i) - 0.5 ) / 255.0 ) );
+            }
+            t.thresholds[256] = 2.f;
+
+            // The buckets are narrower than the gaps between the thresholds (the smallest gap
+            // is 1 / (12.92 * 255)), so each bucket contains at most one threshold
+            uint32_t code = 0;
+            for( size_t i = 0; i < SRGB_BUCKETS; ++i )
+            {
+                const float v = float(i) / float( SRGB_BUCKETS - 1 );
+                while ( v >= t.thresholds[ code + 1 ] )
+                    ++code;
+                t.toSRGB[i] = uint8_t( code );
+            }
+            return t;
+        }();
+        return s_tables;
+    }
+
+    inline void _ComputeBoxTaps( _In_ size_t i, _In_ size_t srcSize, _Out_ BoxTaps& taps )
+    {
+        if ( srcSize <= 1 )
+        {
+            taps.index = 0;
+            taps.count = 1;
+            taps.weights[0] = 1.f;
+            taps.weights[1] = taps.weights[2] = 0.f;
+        }
+        else if ( !( srcSize & 1 ) )
+        {
+            taps.index = i << 1;
+            taps.count = 2;
+            taps.weights[0] = taps.weights[1] = 0.5f;
+            taps.weights[2] = 0.f;
+        }
+        else
+        {
+            // Each of the m = (n - 1) / 2 destination texels covers n / m source texels
+            const float n = float( srcSize );
+            const float m = float( srcSize >> 1 );
+            taps.index = i << 1;
+            taps.count = 3;
+            taps.weights[0] = ( m - float(i) ) / n;
+            taps.weights[1] = m / n;
+            taps.weights[2] = ( float(i) + 1.f ) / n;
+        }
+    }
+
+    inline __m128 _DecodeRGBA8( _In_ uint32_t texel, _In_reads_(256) const float* colorLUT, _In_reads_(256) const float* alphaLUT )
+    {
+        return _mm_setr_ps( colorLUT[ texel & 0xFF ], colorLUT[ ( texel >> 8 ) & 0xFF ],
+                            colorLUT[ ( texel >> 16 ) & 0xFF ], alphaLUT[ texel >> 24 ] );
+    }
+
+    inline uint32_t _EncodeUnorm8( _In_ __m128 v )
+    {
+        v = _mm_min_ps( _mm_max_ps( v, _mm_setzero_ps() ), _mm_set1_ps( 1.f ) );
+        __m128i i = _mm_cvtps_epi32( _mm_mul_ps( v, _mm_set1_ps( 255.f ) ) );
+        i = _mm_packus_epi32( i, i );
+        i = _mm_packus_epi16( i, i );
+        return uint32_t( _mm_cvtsi128_si32( i ) );
+    }
+
+    inline uint32_t _EncodeSRGB8( _In_ __m128 v, _In_ const SRGBTables& t )
+    {
+        v = _mm_min_ps( _mm_max_ps( v, _mm_setzero_ps() ), _mm_set1_ps( 1.f ) );
+
+        alignas(16) int32_t buckets[4];
+        alignas(16) float values[4];
+        _mm_store_si128( reinterpret_cast<__m128i*>( buckets ), _mm_cvttps_epi32( _mm_mul_ps( v, _mm_set1_ps( float( SRGB_BUCKETS - 1 ) ) ) ) );
+        _mm_store_ps( values, v );
+
+        // Alpha is stored linearly
+        uint32_t result = _EncodeUnorm8( v ) & 0xFF000000;
+        for( uint32_t c = 0; c < 3; ++c )
+        {
+            // Correct the code of the lower bound of the bucket using the thresholds
+            uint32_t code = t.toSRGB[ buckets[c] ];
+            code += ( values[c] >= t.thresholds[ code + 1 ] ) ? 1 : 0;
+            code -= ( values[c] < t.thresholds[ code ] ) ? 1 : 0;
+            result |= code << ( 8 * c );
+        }
+        return result;
+    }
+
+    template<bool srgb>
+    void _DownsampleRowRGBA8( _In_ const Image& src, _In_ const Image& dest, _In_ size_t y, _In_reads_(dest.width) const BoxTaps* xtaps, _In_ const SRGBTables& t )
+    {
+        const float* colorLUT = srgb ? t.toLinear : t.toUnorm;
+        const float* alphaLUT = t.toUnorm;
+
+        BoxTaps ytaps;
+        _ComputeBoxTaps( y, src.height, ytaps );
+
+        const uint32_t* rows[3];
+        for( size_t r = 0; r < ytaps.count; ++r )
+        {
+            rows[r] = reinterpret_cast<const uint32_t*>( src.pixels + ( ytaps.index + r ) * src.rowPitch );
+        }
+
+        auto pDest = reinterpret_cast<uint32_t*>( dest.pixels + y * dest.rowPitch );
+
+        if ( ytaps.count == 2 && src.width > 1 && !( src.width & 1 ) )
+        {
+            // Even dimensions: average 2x2 blocks
+            const __m128 quarter = _mm_set1_ps( 0.25f );
+            const uint32_t* row0 = rows[0];
+            const uint32_t* row1 = rows[1];
+            for( size_t x = 0; x < dest.width; ++x, row0 += 2, row1 += 2 )
+            {
+                __m128 sum = _mm_add_ps( _DecodeRGBA8( row0[0], colorLUT, alphaLUT ), _DecodeRGBA8( row0[1], colorLUT, alphaLUT ) );
+                sum = _mm_add_ps( sum, _DecodeRGBA8( row1[0], colorLUT, alphaLUT ) );
+                sum = _mm_add_ps( sum, _DecodeRGBA8( row1[1], colorLUT, alphaLUT ) );
+                sum = _mm_mul_ps( sum, quarter );
+                pDest[x] = srgb ? _EncodeSRGB8( sum, t ) : _EncodeUnorm8( sum );
+            }
+        }
+        else
+        {
+            // Odd (or unit) dimensions: weigh up to 3x3 texels by their coverage
+            for( size_t x = 0; x < dest.width; ++x )
+            {
+                const BoxTaps& taps = xtaps[x];
+                __m128 sum = _mm_setzero_ps();
+                for( size_t r = 0; r < ytaps.count; ++r )
+                {
+                    const uint32_t* row = rows[r] + taps.index;
+                    for( size_t c = 0; c < taps.count; ++c )
+                    {
+                        const __m128 w = _mm_set1_ps( ytaps.weights[r] * taps.weights[c] );
+                        sum = _mm_add_ps( sum, _mm_mul_ps( _DecodeRGBA8( row[c], colorLUT, alphaLUT ), w ) );
+                    }
+                }
+                pDest[x] = srgb ? _EncodeSRGB8( sum, t ) : _EncodeUnorm8( sum );
+            }
+        }
+    }
+}
+
+static HRESULT _Generate2DMipsRGBA8BoxFilter( _In_ size_t levels, _In_ DWORD filter, _In_ const ScratchImage& mipChain, _In_ size_t item )
+{
+    if ( !mipChain.GetImages() )
+        return E_INVALIDARG;
+
+    // This assumes that the base image is already placed into the mipChain at the top level... (see _Setup2DMips)
+
+    assert( levels > 1 );
+    assert( _IsRGBA8( mipChain.GetMetadata().format ) );
+
+    // sRGB data is filtered in linear space
+    const bool srgb = IsSRGB( mipChain.GetMetadata().format ) || ( filter & TEX_FILTER_SRGB ) != 0;
+    const SRGBTables& tables = _GetSRGBTables();
+
+    // Horizontal taps of the widest level
+    std::unique_ptr<BoxTaps[]> xtaps( new (std::nothrow) BoxTaps[ std::max<size_t>( 1, mipChain.GetMetadata().width >> 1 ) ] );
+    if ( !xtaps )
+        return E_OUTOFMEMORY;
+
+    // Resize base image to each target mip level
+    for( size_t level=1; level < levels; ++level )
+    {
+        const Image* src = mipChain.GetImage( level-1, item, 0 );
+        const Image* dest = mipChain.GetImage( level, item, 0 );
+
+        if ( !src || !dest )
+            return E_POINTER;
+
+        for( size_t x = 0; x < dest->width; ++x )
+        {
+            _ComputeBoxTaps( x, src->width, xtaps[x] );
+        }
+
+        // Rows are independent; bands of at least this many texels amortize the cost of scheduling a task
+        const size_t BAND_TEXELS = 16384;
+
+        const size_t rowsPerBand = std::max<size_t>( 1, BAND_TEXELS / dest->width );
+        const size_t nbands = ( dest->height + rowsPerBand - 1 ) / rowsPerBand;
+
+        GetSharedTaskExecutor()->Run( nbands, [&]( size_t band )
+        {
+            const size_t rowEnd = std::min<size_t>( dest->height, ( band + 1 ) * rowsPerBand );
+            for( size_t y = band * rowsPerBand; y < rowEnd; ++y )
+            {
+                if ( srgb )
+                    _DownsampleRowRGBA8<true>( *src, *dest, y, xtaps.get(), tables );
+                else
+                    _DownsampleRowRGBA8<false>( *src, *dest, y, xtaps.get(), tables );
+            }
+        } );
+    }
+
+    return S_OK;
+}
+
+
 //--- 2D Linear Filter ---
 static HRESULT _Generate2DMipsLinearFilter( _In_ size_t levels, _In_ DWORD filter, _In_ const ScratchImage& mipChain, _In_ size_t item )
 {
@@ -2615,7 +2879,7 @@ HRESULT GenerateMipMaps( const Image& baseImage, DWORD filter, size_t levels, Sc
         if ( !filter_select )
         {
             // Default filter choice
-            filter_select = ( ispow2(baseImage.width) && ispow2(baseImage.height) ) ? TEX_FILTER_BOX : TEX_FILTER_LINEAR;
+            filter_select = ( _IsRGBA8(baseImage.format) || ( ispow2(baseImage.width) && ispow2(baseImage.height) ) ) ? TEX_FILTER_BOX : TEX_FILTER_LINEAR;
         }
 
         switch( filter_select )
@@ -2625,7 +2889,9 @@ HRESULT GenerateMipMaps( const Image& baseImage, DWORD filter, size_t levels, Sc
                 if ( FAILED(hr) )
                     return hr;
 
-                hr = _Generate2DMipsBoxFilter( levels, filter, mipChain, 0 );
+                hr = _IsRGBA8( baseImage.format )
+                     ? _Generate2DMipsRGBA8BoxFilter( levels, filter, mipChain, 0 )
+                     : _Generate2DMipsBoxFilter( levels, filter, mipChain, 0 );
                 if ( FAILED(hr) )
                     mipChain.Release();
                 return hr;
@@ -2803,7 +3069,7 @@ HRESULT GenerateMipMaps( const Image* srcImages, size_t nimages, const TexMetada
         if ( !filter_select )
         {
             // Default filter choice
-            filter_select = ( ispow2(metadata.width) && ispow2(metadata.height) ) ? TEX_FILTER_BOX : TEX_FILTER_LINEAR;
+            filter_select = ( _IsRGBA8(metadata.format) || ( ispow2(metadata.width) && ispow2(metadata.height) ) ) ? TEX_FILTER_BOX : TEX_FILTER_LINEAR;
         }
 
         switch( filter_select )
@@ -2815,7 +3081,9 @@ HRESULT GenerateMipMaps( const Image* srcImages, size_t nimages, const TexMetada
 
                 for( size_t item = 0; item < metadata.arraySize; ++item )
                 {
-                    hr = _Generate2DMipsBoxFilter( levels, filter, mipChain, item );
+                    hr = _IsRGBA8( metadata.format )
+                         ? _Generate2DMipsRGBA8BoxFilter( levels, filter, mipChain, item )
+                         : _Generate2DMipsBoxFilter( levels, filter, mipChain, item );
                     if ( FAILED(hr) )
                         mipChain.Release();
                 }
@@ -17,6 +17,8 @@
 
 #include "filters.h"
 
+#include <atomic>
+
 using Microsoft::WRL::ComPtr;
 
 namespace DirectX
@@ -227,6 +229,7 @@ static bool _UseWICFiltering( _In_ DXGI_FORMAT format, _In_ DWORD filter )
         break;
 
     case TEX_FILTER_TRIANGLE:
+    case TEX_FILTER_LANCZOS3:
         // WIC does not implement this filter
         return false;
     }
@@ -781,6 +784,154 @@ static HRESULT _ResizeTriangleFilter( _In_ const Image& srcImage, _In_ DWORD fil
 }
 
 
+//--- Polyphase Filter ---
+static HRESULT _ResizePolyphaseFilter( _In_ const Image& srcImage, _In_ DWORD filter, _In_ DWORD filterSelect, _In_ const Image& destImage )
+{
+    assert( srcImage.pixels && destImage.pixels );
+    assert( srcImage.format == destImage.format );
+
+    using namespace PolyphaseFilter;
+
+    // Strips of at least this many rows amortize re-filtering the source rows they share with their neighbors
+    const size_t STRIP_ROWS = 32;
+
+    Filter pfX;
+    HRESULT hr = _Create( srcImage.width, destImage.width, filterSelect,
+                          (filter & TEX_FILTER_WRAP_U) != 0, (filter & TEX_FILTER_MIRROR_U) != 0, pfX );
+    if ( FAILED(hr) )
+        return hr;
+
+    Filter pfY;
+    hr = _Create( srcImage.height, destImage.height, filterSelect,
+                  (filter & TEX_FILTER_WRAP_V) != 0, (filter & TEX_FILTER_MIRROR_V) != 0, pfY );
+    if ( FAILED(hr) )
+        return hr;
+
+    const size_t nstrips = ( destImage.height + STRIP_ROWS - 1 ) / STRIP_ROWS;
+
+    std::atomic<HRESULT> result( S_OK );
+
+    GetSharedTaskExecutor()->Run( nstrips, [&]( size_t strip )
+    {
+        const size_t taps = pfY.taps;
+
+        // Allocate temporary space (1 source scanline, 1 target scanline, plus a cache of horizontally filtered rows)
+        ScopedAlignedArrayXMVECTOR scanline( reinterpret_cast<XMVECTOR*>( _aligned_malloc( sizeof(XMVECTOR) * ( srcImage.width + destImage.width * ( taps + 1 ) ), 16 ) ) );
+        std::unique_ptr<size_t[]> tags( new (std::nothrow) size_t[ taps * 2 ] );
+        if ( !scanline || !tags )
+        {
+            result = E_OUTOFMEMORY;
+            return;
+        }
+
+        XMVECTOR* row = scanline.get();
+        XMVECTOR* target = row + srcImage.width;
+        XMVECTOR* cache = target + destImage.width;
+
+        // Source row held by each cache slot, and the last target row which used it
+        size_t* rowTags = tags.get();
+        size_t* lastUse = rowTags + taps;
+        for( size_t k = 0; k < taps; ++k )
+        {
+            rowTags[ k ] = size_t(-1);
+            lastUse[ k ] = 0;
+        }
+
+        const uint8_t* pSrc = srcImage.pixels;
+        uint8_t* pDest = destImage.pixels;
+
+        const size_t yEnd = std::min<size_t>( destImage.height, ( strip + 1 ) * STRIP_ROWS );
+        for( size_t y = strip * STRIP_ROWS; y < yEnd; ++y )
+        {
+            if ( FAILED( result.load() ) )
+                return;
+
+            const size_t* yIndex = &pfY.index[ y * taps ];
+            const float* yWeight = &pfY.weight[ y * taps ];
+
+            memset( target, 0, sizeof(XMVECTOR) * destImage.width );
+
+            for( size_t j = 0; j < taps; ++j )
+            {
+                if ( yWeight[ j ] == 0.f )
+                    continue;
+
+                const size_t v = yIndex[ j ];
+
+                size_t slot = 0;
+                while( slot < taps && rowTags[ slot ] != v )
+                    ++slot;
+
+                if ( slot == taps )
+                {
+                    // Evict the least recently used row; rows used by this target row are never the oldest
+                    slot = 0;
+                    for( size_t k = 1; k < taps; ++k )
+                    {
+                        if ( rowTags[ k ] == size_t(-1) || ( rowTags[ slot ] != size_t(-1) && lastUse[ k ] < lastUse[ slot ] ) )
+                            slot = k;
+                    }
+
+                    if ( !_LoadScanlineLinear( row, srcImage.width, pSrc + ( srcImage.rowPitch * v ), srcImage.rowPitch, srcImage.format, filter ) )
+                    {
+                        result = E_FAIL;
+                        return;
+                    }
+
+                    // Horizontal pass
+                    XMVECTOR* pCache = cache + destImage.width * slot;
+                    const size_t* xIndex = pfX.index.get();
+                    const float* xWeight = pfX.weight.get();
+                    for( size_t x = 0; x < destImage.width; ++x, xIndex += pfX.taps, xWeight += pfX.taps )
+                    {
+                        XMVECTOR acc = XMVectorZero();
+                        if ( xIndex[ pfX.taps - 1 ] == xIndex[ 0 ] + pfX.taps - 1 )
+                        {
+                            // Addressing only ever steps back or repeats, so the taps are contiguous source texels
+                            const XMVECTOR* pRow = row + xIndex[ 0 ];
+                            for( size_t k = 0; k < pfX.taps; ++k )
+                            {
+                                acc = XMVectorMultiplyAdd( pRow[ k ], XMVectorReplicate( xWeight[ k ] ), acc );
+                            }
+                        }
+                        else
+                        {
+                            for( size_t k = 0; k < pfX.taps; ++k )
+                            {
+                                acc = XMVectorMultiplyAdd( row[ xIndex[ k ] ], XMVectorReplicate( xWeight[ k ] ), acc );
+                            }
+                        }
+                        pCache[ x ] = acc;
+                    }
+
+                    rowTags[ slot ] = v;
+                }
+
+                // Mark as used before the next lookup, so it survives eviction for the rest of this row
+                lastUse[ slot ] = y + 1;
+
+                // Vertical pass
+                const XMVECTOR weight = XMVectorReplicate( yWeight[ j ] );
+                const XMVECTOR* pCache = cache + destImage.width * slot;
+                for( size_t x = 0; x < destImage.width; ++x )
+                {
+                    target[ x ] = XMVectorMultiplyAdd( pCache[ x ], weight, target[ x ] );
+                }
+            }
+
+            // This performs any required clamping
+            if ( !_StoreScanlineLinear( pDest + ( destImage.rowPitch * y ), destImage.rowPitch, destImage.format, target, destImage.width, filter ) )
+            {
+                result = E_FAIL;
+                return;
+            }
+        }
+    } );
+
+    return result;
+}
+
+
 //--- Custom filter resize ---
 static HRESULT _PerformResizeUsingCustomFilters( _In_ const Image& srcImage, _In_ DWORD filter, _In_ const Image& destImage )
 {
@@ -797,6 +948,22 @@ static HRESULT _PerformResizeUsingCustomFilters( _In_ const Image& srcImage, _In
                         ? TEX_FILTER_BOX : TEX_FILTER_LINEAR;
     }
 
+    switch( filter_select )
+    {
+    case TEX_FILTER_BOX:
+    case TEX_FILTER_CUBIC:
+    case TEX_FILTER_TRIANGLE:
+        if ( filter & TEX_FILTER_FORCE_NON_WIC )
+        {
+            // Separable filter which handles any scale factor, and runs in parallel strips
+            return _ResizePolyphaseFilter( srcImage, filter, filter_select, destImage );
+        }
+        break;
+
+    case TEX_FILTER_LANCZOS3:
+        return _ResizePolyphaseFilter( srcImage, filter, filter_select, destImage );
+    }
+
     switch( filter_select )
     {
     case TEX_FILTER_POINT:
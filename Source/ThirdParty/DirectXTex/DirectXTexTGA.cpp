@@ -15,6 +15,11 @@
 
 #include "directxtexp.h"
 
+#include <atomic>
+#include <thread>
+
+#include <smmintrin.h>
+
 //
 // The implementation here has the following limitations:
 //      * Does not support files that contain color maps (these are rare in practice)
@@ -250,486 +255,362 @@ static HRESULT _SetAlphaChannelToOpaque( _In_ const Image* image )
 
 
 //-------------------------------------------------------------------------------------
-// Uncompress pixel data from a TGA into the target image
+// Decodes TGA pixels (in BGR/BGRA order) to the target format
 //-------------------------------------------------------------------------------------
-static HRESULT _UncompressPixels( _In_reads_bytes_(size) LPCVOID pSource, size_t size, _In_ const Image* image, _In_ DWORD convFlags )
+
+// Scanlines are decoded in bands of this many rows, which run as parallel tasks
+static const size_t TGA_BAND_ROWS = 64;
+
+// Swizzles BGRA to RGBA, and returns true if any alpha value is non-zero
+static bool _SwizzleBGRA( _Out_writes_(count) uint32_t* dPtr, _In_reads_bytes_(count*4) const uint8_t* sPtr, _In_ size_t count )
 {
-    assert( pSource && size > 0 );
+    static const __m128i s_swizzle = _mm_setr_epi8( 2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15 );
 
-    if ( !image || !image->pixels )
-        return E_POINTER;
+    __m128i alpha = _mm_setzero_si128();
 
-    // Compute TGA image data pitch
-    size_t rowPitch;
-    if ( convFlags & CONV_FLAGS_EXPAND )
+    size_t x = 0;
+    for( ; x + 4 <= count; x += 4 )
     {
-        rowPitch = image->width * 3;
-    }
-    else
-    {
-        size_t slicePitch;
-        ComputePitch( image->format, image->width, image->height, rowPitch, slicePitch, CP_FLAGS_NONE );
+        __m128i v = _mm_loadu_si128( reinterpret_cast<const __m128i*>( sPtr + x * 4 ) );
+        alpha = _mm_or_si128( alpha, v );
+        _mm_storeu_si128( reinterpret_cast<__m128i*>( dPtr + x ), _mm_shuffle_epi8( v, s_swizzle ) );
     }
 
-    auto sPtr = reinterpret_cast<const uint8_t*>( pSource );
-    const uint8_t* endPtr = sPtr + size;
+    bool nonzeroa = ( _mm_movemask_epi8( _mm_cmpeq_epi32( _mm_and_si128( alpha, _mm_set1_epi32( int(0xFF000000) ) ), _mm_setzero_si128() ) ) != 0xFFFF );
 
-    switch( image->format )
+    for( ; x < count; ++x )
     {
-    //--------------------------------------------------------------------------- 8-bit
-    case DXGI_FORMAT_R8_UNORM:
-        for( size_t y=0; y < image->height; ++y )
-        {
-            size_t offset = ( (convFlags & CONV_FLAGS_INVERTX ) ? (image->width - 1) : 0 );
-            assert( offset < rowPitch);
-
-            uint8_t* dPtr = reinterpret_cast<uint8_t*>( image->pixels )
-                         + ( image->rowPitch * ( (convFlags & CONV_FLAGS_INVERTY) ? y : (image->height - y - 1) ) )
-                         + offset;
-
-            for( size_t x=0; x < image->width; )
-            {
-                if ( sPtr >= endPtr )
-                    return E_FAIL;
-
-                if ( *sPtr & 0x80 )
-                {
-                    // Repeat
-                    size_t j = (*sPtr & 0x7F) + 1;
-                    if ( ++sPtr >= endPtr )
-                        return E_FAIL;
-
-                    for( ; j > 0; --j, ++x )
-                    {
-                        if ( x >= image->width )
-                            return E_FAIL;
-
-                        *dPtr = *sPtr;
+        const uint8_t* p = sPtr + x * 4;
+        dPtr[ x ] = ( p[0] << 16 ) | ( p[1] << 8 ) | ( p[2] ) | ( p[3] << 24 );
 
-                        if ( convFlags & CONV_FLAGS_INVERTX )
-                            --dPtr;
-                        else
-                            ++dPtr;
-                    }
+        if ( p[3] > 0 )
+            nonzeroa = true;
+    }
 
-                    ++sPtr;
-                }
-                else
-                {
-                    // Literal
-                    size_t j = (*sPtr & 0x7F) + 1;
-                    ++sPtr;
+    return nonzeroa;
+}
 
-                    if ( sPtr+j > endPtr )
-                        return E_FAIL;
+// Expands BGR to RGBA with an opaque alpha
+static void _ExpandBGR( _Out_writes_(count) uint32_t* dPtr, _In_reads_bytes_(count*3) const uint8_t* sPtr, _In_ size_t count )
+{
+    static const __m128i s_expand = _mm_setr_epi8( 2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1 );
+    const __m128i alpha = _mm_set1_epi32( int(0xFF000000) );
 
-                    for( ; j > 0; --j, ++x )
-                    {
-                        if ( x >= image->width )
-                            return E_FAIL;
+    // Each load reads 16 bytes to use 12, so stop early enough to stay within the source
+    size_t x = 0;
+    for( ; x + 6 <= count; x += 4 )
+    {
+        __m128i v = _mm_loadu_si128( reinterpret_cast<const __m128i*>( sPtr + x * 3 ) );
+        _mm_storeu_si128( reinterpret_cast<__m128i*>( dPtr + x ), _mm_or_si128( _mm_shuffle_epi8( v, s_expand ), alpha ) );
+    }
 
-                        *dPtr = *(sPtr++);
+    for( ; x < count; ++x )
+    {
+        const uint8_t* p = sPtr + x * 3;
+        dPtr[ x ] = ( p[0] << 16 ) | ( p[1] << 8 ) | ( p[2] ) | 0xFF000000;
+    }
+}
 
-                        if ( convFlags & CONV_FLAGS_INVERTX )
-                            --dPtr;
-                        else
-                            ++dPtr;
-                    }
-                }
-            }
-        }
+// Decodes 'count' consecutive pixels of 'bpp' bytes each
+static void _DecodePixels( _Out_ uint8_t* dPtr, _In_ const uint8_t* sPtr, _In_ size_t count, _In_ size_t bpp, _Inout_ bool& nonzeroa )
+{
+    switch( bpp )
+    {
+    case 1:
+        memcpy( dPtr, sPtr, count );
         break;
 
-    //-------------------------------------------------------------------------- 16-bit
-    case DXGI_FORMAT_B5G5R5A1_UNORM:
+    case 2:
         {
-            bool nonzeroa = false;
-            for( size_t y=0; y < image->height; ++y )
-            {
-                size_t offset = ( (convFlags & CONV_FLAGS_INVERTX ) ? (image->width - 1) : 0 );
-                assert( offset*2 < rowPitch);
-
-                uint16_t* dPtr = reinterpret_cast<uint16_t*>( reinterpret_cast<uint8_t*>( image->pixels )
-                             + ( image->rowPitch * ( (convFlags & CONV_FLAGS_INVERTY) ? y : (image->height - y - 1) ) ) )
-                             + offset;
+            memcpy( dPtr, sPtr, count * 2 );
 
-                for( size_t x=0; x < image->width; )
+            if ( !nonzeroa )
+            {
+                auto ptr = reinterpret_cast<const uint16_t*>( dPtr );
+                for( size_t x = 0; x < count; ++x )
                 {
-                    if ( sPtr >= endPtr )
-                        return E_FAIL;
-
-                    if ( *sPtr & 0x80 )
-                    {
-                        // Repeat
-                        size_t j = (*sPtr & 0x7F) + 1;
-                        ++sPtr;
-
-                        if ( sPtr+1 >= endPtr )
-                            return E_FAIL;
-
-                        uint16_t t =  *sPtr | (*(sPtr+1) << 8);
-                        if ( t & 0x8000 )
-                            nonzeroa = true;
-                        sPtr += 2;
-
-                        for( ; j > 0; --j, ++x )
-                        {
-                            if ( x >= image->width )
-                                return E_FAIL;
-
-                            *dPtr = t;
-
-                            if ( convFlags & CONV_FLAGS_INVERTX )
-                                --dPtr;
-                            else
-                                ++dPtr;
-                        }
-                    }
-                    else
+                    if ( ptr[ x ] & 0x8000 )
                     {
-                        // Literal
-                        size_t j = (*sPtr & 0x7F) + 1;
-                        ++sPtr;
-
-                        if ( sPtr+(j*2) > endPtr )
-                            return E_FAIL;
-
-                        for( ; j > 0; --j, ++x )
-                        {
-                            if ( x >= image->width )
-                                return E_FAIL;
-
-                            uint16_t t =  *sPtr | (*(sPtr+1) << 8);
-                            if ( t & 0x8000 )
-                                nonzeroa = true;
-                            sPtr += 2;
-                            *dPtr = t;
-
-                            if ( convFlags & CONV_FLAGS_INVERTX )
-                                --dPtr;
-                            else
-                                ++dPtr;
-                        }
+                        nonzeroa = true;
+                        break;
                     }
                 }
             }
-
-            // If there are no non-zero alpha channel entries, we'll assume alpha is not used and force it to opaque
-            if ( !nonzeroa )
-            {
-                HRESULT hr = _SetAlphaChannelToOpaque( image );
-                if ( FAILED(hr) )
-                    return hr;
-            }
         }
         break;
 
-    //----------------------------------------------------------------------- 24/32-bit
-    case DXGI_FORMAT_R8G8B8A8_UNORM:
-        {
-            bool nonzeroa = false;
-            for( size_t y=0; y < image->height; ++y )
-            {
-                size_t offset = ( (convFlags & CONV_FLAGS_INVERTX ) ? (image->width - 1) : 0 );
-
-                uint32_t* dPtr = reinterpret_cast<uint32_t*>( reinterpret_cast<uint8_t*>( image->pixels )
-                              + ( image->rowPitch * ( (convFlags & CONV_FLAGS_INVERTY) ? y : (image->height - y - 1) ) ) )
-                              + offset;
-
-                for( size_t x=0; x < image->width; )
-                {
-                    if ( sPtr >= endPtr )
-                        return E_FAIL;
-
-                    if ( *sPtr & 0x80 )
-                    {
-                        // Repeat
-                        size_t j = (*sPtr & 0x7F) + 1;
-                        ++sPtr;
+    case 3:
+        // BGR -> RGBA
+        _ExpandBGR( reinterpret_cast<uint32_t*>( dPtr ), sPtr, count );
+        nonzeroa = true;
+        break;
 
-                        DWORD t;
-                        if ( convFlags & CONV_FLAGS_EXPAND )
-                        {
-                            assert( offset*3 < rowPitch);
+    default:
+        // BGRA -> RGBA
+        if ( _SwizzleBGRA( reinterpret_cast<uint32_t*>( dPtr ), sPtr, count ) )
+            nonzeroa = true;
+        break;
+    }
+}
 
-                            if ( sPtr+2 >= endPtr )
-                                return E_FAIL;
+// Reverses the order of pixels in a right-to-left scanline
+static void _ReverseScanline( _Inout_ uint8_t* pixels, _In_ size_t width, _In_ size_t bpp )
+{
+    switch( bpp )
+    {
+    case 1:     std::reverse( pixels, pixels + width ); break;
+    case 2:     std::reverse( reinterpret_cast<uint16_t*>( pixels ), reinterpret_cast<uint16_t*>( pixels ) + width ); break;
+    default:    std::reverse( reinterpret_cast<uint32_t*>( pixels ), reinterpret_cast<uint32_t*>( pixels ) + width ); break;
+    }
+}
 
-                            // BGR -> RGBA
-                            t = ( *sPtr << 16 ) | ( *(sPtr+1) << 8 ) | ( *(sPtr+2) ) | 0xFF000000;
-                            sPtr += 3;
+// Decodes one RLE compressed scanline, and returns the start of the next (or nullptr if the data is invalid);
+// packets are typically only a few pixels long, so the source pixel size is a template argument
+template<size_t bpp>
+static const uint8_t* _DecodeRLEScanline( _In_ const uint8_t* sPtr, _In_ const uint8_t* endPtr, _Out_ uint8_t* dPtr,
+                                          _In_ size_t width, _Inout_ bool& nonzeroa )
+{
+    const size_t dbpp = ( bpp == 3 ) ? 4 : bpp;
 
-                            nonzeroa = true;
-                        }
-                        else
-                        {
-                            assert( offset*4 < rowPitch);
+    for( size_t x = 0; x < width; )
+    {
+        if ( sPtr >= endPtr )
+            return nullptr;
 
-                            if ( sPtr+3 >= endPtr )
-                                return E_FAIL;
+        const bool repeat = ( *sPtr & 0x80 ) != 0;
+        const size_t j = (*sPtr & 0x7F) + 1;
+        ++sPtr;
 
-                            // BGRA -> RGBA
-                            t = ( *sPtr << 16 ) | ( *(sPtr+1) << 8 ) | ( *(sPtr+2) ) | ( *(sPtr+3) << 24 );
+        // Packets may not cross scanlines
+        if ( x + j > width )
+            return nullptr;
 
-                            if ( *(sPtr+3) > 0 )
-                                nonzeroa = true;
+        if ( repeat )
+        {
+            if ( size_t( endPtr - sPtr ) < bpp )
+                return nullptr;
 
-                            sPtr += 4;
-                        }
+            // Decode the pixel once, then replicate it
+            uint8_t* pixel = dPtr + x * dbpp;
+            _DecodePixels( pixel, sPtr, 1, bpp, nonzeroa );
 
-                        for( ; j > 0; --j, ++x )
-                        {
-                            if ( x >= image->width )
-                                return E_FAIL;
+            switch( dbpp )
+            {
+            case 1:     memset( pixel + 1, *pixel, j - 1 ); break;
+            case 2:     std::fill_n( reinterpret_cast<uint16_t*>( pixel ) + 1, j - 1, *reinterpret_cast<const uint16_t*>( pixel ) ); break;
+            default:    std::fill_n( reinterpret_cast<uint32_t*>( pixel ) + 1, j - 1, *reinterpret_cast<const uint32_t*>( pixel ) ); break;
+            }
 
-                            *dPtr = t;
+            sPtr += bpp;
+        }
+        else
+        {
+            if ( size_t( endPtr - sPtr ) < j * bpp )
+                return nullptr;
 
-                            if ( convFlags & CONV_FLAGS_INVERTX )
-                                --dPtr;
-                            else
-                                ++dPtr;
-                        }
-                    }
-                    else
-                    {
-                        // Literal
-                        size_t j = (*sPtr & 0x7F) + 1;
-                        ++sPtr;
-
-                        if ( convFlags & CONV_FLAGS_EXPAND )
-                        {
-                            if ( sPtr+(j*3) > endPtr )
-                                return E_FAIL;
-                        }
-                        else
-                        {
-                            if ( sPtr+(j*4) > endPtr )
-                                return E_FAIL;
-                        }
-
-                        for( ; j > 0; --j, ++x )
-                        {
-                            if ( x >= image->width )
-                                return E_FAIL;
-
-                            if ( convFlags & CONV_FLAGS_EXPAND )
-                            {
-                                assert( offset*3 < rowPitch);
-
-                                if ( sPtr+2 >= endPtr )
-                                    return E_FAIL;
-
-                                // BGR -> RGBA
-                                *dPtr = ( *sPtr << 16 ) | ( *(sPtr+1) << 8 ) | ( *(sPtr+2) ) | 0xFF000000;
-                                sPtr += 3;
-
-                                nonzeroa = true;
-                            }
-                            else
-                            {
-                                assert( offset*4 < rowPitch);
-
-                                if ( sPtr+3 >= endPtr )
-                                    return E_FAIL;
-
-                                // BGRA -> RGBA
-                                *dPtr = ( *sPtr << 16 ) | ( *(sPtr+1) << 8 ) | ( *(sPtr+2) ) | ( *(sPtr+3) << 24 );
-
-                                if ( *(sPtr+3) > 0 )
-                                    nonzeroa = true;
-
-                                sPtr += 4;
-                            }
-
-                            if ( convFlags & CONV_FLAGS_INVERTX )
-                                --dPtr;
-                            else
-                                ++dPtr;
-                        }
-                    }
-                }
-            }
+            _DecodePixels( dPtr + x * dbpp, sPtr, j, bpp, nonzeroa );
 
-            // If there are no non-zero alpha channel entries, we'll assume alpha is not used and force it to opaque
-            if ( !nonzeroa )
-            {
-                HRESULT hr = _SetAlphaChannelToOpaque( image );
-                if ( FAILED(hr) )
-                    return hr;
-            }
+            sPtr += j * bpp;
         }
-        break;
 
-    //---------------------------------------------------------------------------------
-    default:
-        return E_FAIL;
+        x += j;
     }
 
-    return S_OK;
+    return sPtr;
+}
+
+// Returns where the y-th scanline stored in the file is placed in the image
+static uint8_t* _GetScanline( _In_ const Image* image, _In_ size_t y, _In_ DWORD convFlags )
+{
+    return image->pixels + image->rowPitch * ( (convFlags & CONV_FLAGS_INVERTY) ? y : (image->height - y - 1) );
+}
+
+static size_t _GetSourceBytesPerPixel( _In_ const Image* image, _In_ DWORD convFlags )
+{
+    return ( convFlags & CONV_FLAGS_EXPAND ) ? 3 : ( BitsPerPixel( image->format ) / 8 );
 }
 
 
 //-------------------------------------------------------------------------------------
-// Copies pixel data from a TGA into the target image
+// Uncompress pixel data from a TGA into the target image
 //-------------------------------------------------------------------------------------
-static HRESULT _CopyPixels( _In_reads_bytes_(size) LPCVOID pSource, size_t size, _In_ const Image* image, _In_ DWORD convFlags )
+static HRESULT _UncompressPixels( _In_reads_bytes_(size) LPCVOID pSource, size_t size, _In_ const Image* image, _In_ DWORD convFlags )
 {
     assert( pSource && size > 0 );
 
     if ( !image || !image->pixels )
         return E_POINTER;
 
-    // Compute TGA image data pitch
-    size_t rowPitch;
-    if ( convFlags & CONV_FLAGS_EXPAND )
-    {
-        rowPitch = image->width * 3;
-    }
-    else
+    switch( image->format )
     {
-        size_t slicePitch;
-        ComputePitch( image->format, image->width, image->height, rowPitch, slicePitch, CP_FLAGS_NONE );
+    case DXGI_FORMAT_R8_UNORM:
+    case DXGI_FORMAT_B5G5R5A1_UNORM:
+    case DXGI_FORMAT_R8G8B8A8_UNORM:
+        break;
+
+    default:
+        return E_FAIL;
     }
 
-    const uint8_t* sPtr = reinterpret_cast<const uint8_t*>( pSource );
+    const size_t bpp = _GetSourceBytesPerPixel( image, convFlags );
+
+    auto sPtr = reinterpret_cast<const uint8_t*>( pSource );
     const uint8_t* endPtr = sPtr + size;
 
-    switch( image->format )
+    // First pass finds where each band starts by skipping over the packets, so the bands can be decoded independently
+    // (this costs about a third of the decode, so it is skipped when there is no other core to share the work with)
+    const size_t bandRows = ( std::thread::hardware_concurrency() > 1 ) ? TGA_BAND_ROWS : image->height;
+    const size_t nbands = ( image->height + bandRows - 1 ) / bandRows;
+
+    std::unique_ptr<const uint8_t*[]> bands( new (std::nothrow) const uint8_t*[ nbands ] );
+    if ( !bands )
+        return E_OUTOFMEMORY;
+
+    bands[ 0 ] = sPtr;
+
+    if ( nbands > 1 )
     {
-    //--------------------------------------------------------------------------- 8-bit
-    case DXGI_FORMAT_R8_UNORM:
-        for( size_t y=0; y < image->height; ++y )
+        const uint8_t* ptr = sPtr;
+        for( size_t y = 0; y < image->height; ++y )
         {
-            size_t offset = ( (convFlags & CONV_FLAGS_INVERTX ) ? (image->width - 1) : 0 );
-            assert( offset < rowPitch);
+            if ( !( y % bandRows ) )
+                bands[ y / bandRows ] = ptr;
 
-            uint8_t* dPtr = reinterpret_cast<uint8_t*>( image->pixels )
-                         + ( image->rowPitch * ( (convFlags & CONV_FLAGS_INVERTY) ? y : (image->height - y - 1) ) )
-                         + offset;
-
-            for( size_t x=0; x < image->width; ++x )
+            for( size_t x = 0; x < image->width; )
             {
-                if ( sPtr >= endPtr )
+                if ( ptr >= endPtr )
                     return E_FAIL;
 
-                *dPtr = *(sPtr++);
+                const size_t j = (*ptr & 0x7F) + 1;
+                const size_t bytes = ( *ptr & 0x80 ) ? bpp : ( j * bpp );
+                ++ptr;
+
+                if ( x + j > image->width || size_t( endPtr - ptr ) < bytes )
+                    return E_FAIL;
 
-                if ( convFlags & CONV_FLAGS_INVERTX )
-                    --dPtr;
-                else
-                    ++dPtr;
+                ptr += bytes;
+                x += j;
             }
         }
-        break;
-
-    //-------------------------------------------------------------------------- 16-bit
-    case DXGI_FORMAT_B5G5R5A1_UNORM:
-        {
-            bool nonzeroa = false;
-            for( size_t y=0; y < image->height; ++y )
-            {
-                size_t offset = ( (convFlags & CONV_FLAGS_INVERTX ) ? (image->width - 1) : 0 );
-                assert( offset*2 < rowPitch);
+    }
 
-                uint16_t* dPtr = reinterpret_cast<uint16_t*>( reinterpret_cast<uint8_t*>( image->pixels )
-                             + ( image->rowPitch * ( (convFlags & CONV_FLAGS_INVERTY) ? y : (image->height - y - 1) ) ) )
-                             + offset;
+    // Second pass decodes the bands
+    typedef const uint8_t* (*DecodeRLEScanline)( const uint8_t*, const uint8_t*, uint8_t*, size_t, bool& );
 
-                for( size_t x=0; x < image->width; ++x )
-                {
-                    if ( sPtr+1 >= endPtr )
-                        return E_FAIL;
+    DecodeRLEScanline pfDecode;
+    switch( bpp )
+    {
+    case 1:     pfDecode = _DecodeRLEScanline<1>; break;
+    case 2:     pfDecode = _DecodeRLEScanline<2>; break;
+    case 3:     pfDecode = _DecodeRLEScanline<3>; break;
+    default:    pfDecode = _DecodeRLEScanline<4>; break;
+    }
 
-                    uint16_t t =  *sPtr | (*(sPtr+1) << 8);
-                    sPtr += 2;
-                    *dPtr = t;
+    std::atomic<bool> fail( false );
+    std::atomic<bool> nonzeroa( false );
 
-                    if ( t & 0x8000 )
-                        nonzeroa = true;
+    GetSharedTaskExecutor()->Run( nbands, [&]( size_t band )
+    {
+        const uint8_t* ptr = bands[ band ];
+        bool alpha = false;
 
-                    if ( convFlags & CONV_FLAGS_INVERTX )
-                        --dPtr;
-                    else
-                        ++dPtr;
-                }
-            }
+        const size_t yEnd = std::min<size_t>( image->height, ( band + 1 ) * bandRows );
+        for( size_t y = band * bandRows; y < yEnd; ++y )
+        {
+            uint8_t* dPtr = _GetScanline( image, y, convFlags );
 
-            // If there are no non-zero alpha channel entries, we'll assume alpha is not used and force it to opaque
-            if ( !nonzeroa )
+            ptr = pfDecode( ptr, endPtr, dPtr, image->width, alpha );
+            if ( !ptr )
             {
-                HRESULT hr = _SetAlphaChannelToOpaque( image );
-                if ( FAILED(hr) )
-                    return hr;
+                fail = true;
+                return;
             }
+
+            if ( convFlags & CONV_FLAGS_INVERTX )
+                _ReverseScanline( dPtr, image->width, ( bpp == 3 ) ? 4 : bpp );
         }
-        break;
 
-    //----------------------------------------------------------------------- 24/32-bit
-    case DXGI_FORMAT_R8G8B8A8_UNORM:
-        {
-            bool nonzeroa = false;
-            for( size_t y=0; y < image->height; ++y )
-            {
-                size_t offset = ( (convFlags & CONV_FLAGS_INVERTX ) ? (image->width - 1) : 0 );
+        if ( alpha )
+            nonzeroa = true;
+    } );
 
-                uint32_t* dPtr = reinterpret_cast<uint32_t*>( reinterpret_cast<uint8_t*>( image->pixels )
-                              + ( image->rowPitch * ( (convFlags & CONV_FLAGS_INVERTY) ? y : (image->height - y - 1) ) ) )
-                              + offset;
+    if ( fail )
+        return E_FAIL;
 
-                for( size_t x=0; x < image->width; ++x )
-                {
-                    if ( convFlags & CONV_FLAGS_EXPAND )
-                    {
-                        assert( offset*3 < rowPitch);
+    // If there are no non-zero alpha channel entries, we'll assume alpha is not used and force it to opaque
+    if ( image->format != DXGI_FORMAT_R8_UNORM && !nonzeroa )
+    {
+        HRESULT hr = _SetAlphaChannelToOpaque( image );
+        if ( FAILED(hr) )
+            return hr;
+    }
 
-                        if ( sPtr+2 >= endPtr )
-                            return E_FAIL;
+    return S_OK;
+}
 
-                        // BGR -> RGBA
-                        *dPtr = ( *sPtr << 16 ) | ( *(sPtr+1) << 8 ) | ( *(sPtr+2) ) | 0xFF000000;
-                        sPtr += 3;
 
-                        nonzeroa = true;
-                    }
-                    else
-                    {
-                        assert( offset*4 < rowPitch);
+//-------------------------------------------------------------------------------------
+// Copies pixel data from a TGA into the target image
+//-------------------------------------------------------------------------------------
+static HRESULT _CopyPixels( _In_reads_bytes_(size) LPCVOID pSource, size_t size, _In_ const Image* image, _In_ DWORD convFlags )
+{
+    assert( pSource && size > 0 );
 
-                        if ( sPtr+3 >= endPtr )
-                            return E_FAIL;
+    if ( !image || !image->pixels )
+        return E_POINTER;
 
-                        // BGRA -> RGBA
-                        *dPtr = ( *sPtr << 16 ) | ( *(sPtr+1) << 8 ) | ( *(sPtr+2) ) | ( *(sPtr+3) << 24 );
+    switch( image->format )
+    {
+    case DXGI_FORMAT_R8_UNORM:
+    case DXGI_FORMAT_B5G5R5A1_UNORM:
+    case DXGI_FORMAT_R8G8B8A8_UNORM:
+        break;
 
-                        if ( *(sPtr+3) > 0 )
-                            nonzeroa = true;
+    default:
+        return E_FAIL;
+    }
 
-                        sPtr += 4;
-                    }
+    const size_t bpp = _GetSourceBytesPerPixel( image, convFlags );
 
-                    if ( convFlags & CONV_FLAGS_INVERTX )
-                        --dPtr;
-                    else
-                        ++dPtr;
-                }
-            }
+    // Compute TGA image data pitch
+    const size_t rowPitch = image->width * bpp;
+    if ( size / rowPitch < image->height )
+        return E_FAIL;
 
-            // If there are no non-zero alpha channel entries, we'll assume alpha is not used and force it to opaque
-            if ( !nonzeroa )
-            {
-                HRESULT hr = _SetAlphaChannelToOpaque( image );
-                if ( FAILED(hr) )
-                    return hr;
-            }
+    auto sPtr = reinterpret_cast<const uint8_t*>( pSource );
+
+    std::atomic<bool> nonzeroa( false );
+
+    const size_t nbands = ( image->height + TGA_BAND_ROWS - 1 ) / TGA_BAND_ROWS;
+
+    GetSharedTaskExecutor()->Run( nbands, [&]( size_t band )
+    {
+        bool alpha = false;
+
+        const size_t yEnd = std::min<size_t>( image->height, ( band + 1 ) * TGA_BAND_ROWS );
+        for( size_t y = band * TGA_BAND_ROWS; y < yEnd; ++y )
+        {
+            uint8_t* dPtr = _GetScanline( image, y, convFlags );
+
+            _DecodePixels( dPtr, sPtr + rowPitch * y, image->width, bpp, alpha );
+
+            if ( convFlags & CONV_FLAGS_INVERTX )
+                _ReverseScanline( dPtr, image->width, ( bpp == 3 ) ? 4 : bpp );
         }
-        break;
 
-    //---------------------------------------------------------------------------------
-    default:
-        return E_FAIL;
+        if ( alpha )
+            nonzeroa = true;
+    } );
+
+    // If there are no non-zero alpha channel entries, we'll assume alpha is not used and force it to opaque
+    if ( image->format != DXGI_FORMAT_R8_UNORM && !nonzeroa )
+    {
+        HRESULT hr = _SetAlphaChannelToOpaque( image );
+        if ( FAILED(hr) )
+            return hr;
     }
 
-    return S_OK;   
+    return S_OK;
 }
 
 
@@ -910,6 +791,12 @@ HRESULT GetMetadataFromTGAFile( LPCWSTR szFile, TexMetadata& metadata )
 //-------------------------------------------------------------------------------------
 _Use_decl_annotations_
 HRESULT LoadFromTGAMemory( LPCVOID pSource, size_t size, TexMetadata* metadata, ScratchImage& image )
+{
+    return LoadFromTGAMemory( pSource, size, TGA_FLAGS_NONE, metadata, image );
+}
+
+_Use_decl_annotations_
+HRESULT LoadFromTGAMemory( LPCVOID pSource, size_t size, DWORD flags, TexMetadata* metadata, ScratchImage& image )
 {
     if ( !pSource || size == 0 )
         return E_INVALIDARG;
@@ -923,6 +810,12 @@ HRESULT LoadFromTGAMemory( LPCVOID pSource, size_t size, TexMetadata* metadata,
     if ( FAILED(hr) )
         return hr;
 
+    if ( flags & TGA_FLAGS_FLIP_VERTICAL )
+    {
+        // The decoders place each scanline according to the origin, so flipping only reverses it
+        convFlags ^= CONV_FLAGS_INVERTY;
+    }
+
     if ( offset > size )
         return E_FAIL;
 
@@ -963,6 +856,12 @@ HRESULT LoadFromTGAMemory( LPCVOID pSource, size_t size, TexMetadata* metadata,
 //-------------------------------------------------------------------------------------
 _Use_decl_annotations_
 HRESULT LoadFromTGAFile( LPCWSTR szFile, TexMetadata* metadata, ScratchImage& image )
+{
+    return LoadFromTGAFile( szFile, TGA_FLAGS_NONE, metadata, image );
+}
+
+_Use_decl_annotations_
+HRESULT LoadFromTGAFile( LPCWSTR szFile, DWORD flags, TexMetadata* metadata, ScratchImage& image )
 {
     if ( !szFile )
         return E_INVALIDARG;
@@ -1009,201 +908,20 @@ HRESULT LoadFromTGAFile( LPCWSTR szFile, TexMetadata* metadata, ScratchImage& im
         return E_FAIL;
     }
 
-    // Read the header
-    uint8_t header[sizeof(TGA_HEADER)];
-    DWORD bytesRead = 0;
-    if ( !ReadFile( hFile.get(), header, sizeof(TGA_HEADER), &bytesRead, 0 ) )
+    // Map the file rather than reading it into a temporary buffer, so the pixels are decoded straight from the file cache
+    ScopedHandle hMapping( CreateFileMappingW( hFile.get(), 0, PAGE_READONLY, 0, 0, 0 ) );
+    if ( !hMapping )
     {
         return HRESULT_FROM_WIN32( GetLastError() );
     }
 
-    size_t offset;
-    DWORD convFlags = 0;
-    TexMetadata mdata;
-    HRESULT hr = _DecodeTGAHeader( header, bytesRead, mdata, offset, &convFlags );
-    if ( FAILED(hr) )
-        return hr;
-
-    // Read the pixels
-    DWORD remaining = static_cast<DWORD>( fileSize.LowPart - offset );
-    if ( remaining == 0 )
-        return E_FAIL;
-
-    if ( offset > sizeof(TGA_HEADER) )
-    {
-        // Skip past the id string
-        LARGE_INTEGER filePos = { static_cast<DWORD>(offset), 0 };
-        if ( !SetFilePointerEx( hFile.get(), filePos, 0, FILE_BEGIN ) )
-        {
-            return HRESULT_FROM_WIN32( GetLastError() );
-        }
-    }
-
-    hr = image.Initialize2D( mdata.format, mdata.width, mdata.height, 1, 1 );
-    if ( FAILED(hr) )
-        return hr;
-
-    assert( image.GetPixels() );
-
-    if ( !(convFlags & (CONV_FLAGS_RLE | CONV_FLAGS_EXPAND | CONV_FLAGS_INVERTX)) && (convFlags & CONV_FLAGS_INVERTY) )
+    ScopedMapView view( MapViewOfFile( hMapping.get(), FILE_MAP_READ, 0, 0, 0 ) );
+    if ( !view )
     {
-        // This case we can read directly into the image buffer in place
-        if ( !ReadFile( hFile.get(), image.GetPixels(), static_cast<DWORD>( image.GetPixelsSize() ), &bytesRead, 0 ) )
-        {
-            image.Release();
-            return HRESULT_FROM_WIN32( GetLastError() );
-        }
-
-        if ( bytesRead != image.GetPixelsSize() )
-        {
-            image.Release();
-            return E_FAIL;
-        }
-
-        switch( mdata.format  )
-        {
-        case DXGI_FORMAT_R8G8B8A8_UNORM:
-            {
-                // TGA stores 32-bit data in BGRA form, need to swizzle to RGBA
-                assert( image.GetImageCount() == 1 );
-                const Image* img = image.GetImage(0,0,0);
-                if ( !img )
-                    return E_POINTER;
-
-                uint8_t *pPixels = img->pixels;
-                if ( !pPixels )
-                    return E_POINTER;
-
-                size_t rowPitch = img->rowPitch;
-
-                // Scan for non-zero alpha channel
-                bool nonzeroa = false;
-
-                for( size_t h = 0; h < img->height; ++h )
-                {
-                    const uint32_t* sPtr = reinterpret_cast<const uint32_t*>( pPixels );
-
-                    for( size_t x=0; x < img->width; ++x )
-                    {
-                        if ( (*sPtr) & 0xff000000 )
-                        {
-                            nonzeroa = true;
-                            break;
-                        }
-
-                        ++sPtr;
-                    }
-
-                    if ( nonzeroa )
-                        break;
-
-                    pPixels += rowPitch;
-                }
-
-                DWORD tflags = ( !nonzeroa ) ? TEXP_SCANLINE_SETALPHA : TEXP_SCANLINE_NONE;
-
-                // Swizzle scanlines
-                pPixels = img->pixels;
-
-                for( size_t h = 0; h < img->height; ++h )
-                {
-                    _SwizzleScanline( pPixels, rowPitch, pPixels, rowPitch, mdata.format, tflags );
-                    pPixels += rowPitch;
-                }
-            }
-            break;
-
-        // If we start using DXGI_FORMAT_B8G8R8X8_UNORM or DXGI_FORMAT_B8G8R8A8_UNORM we need to check for a fully 0 alpha channel
-     
-        case DXGI_FORMAT_B5G5R5A1_UNORM:
-            {
-                assert( image.GetImageCount() == 1 );
-                const Image* img = image.GetImage(0,0,0);
-                if ( !img )
-                    return E_POINTER;
-
-                // Scan for non-zero alpha channel
-                bool nonzeroa = false;
-
-                const uint8_t *pPixels = img->pixels;
-                if ( !pPixels )
-                    return E_POINTER;
-
-                size_t rowPitch = img->rowPitch;
-
-                for( size_t h = 0; h < img->height; ++h )
-                {
-                    const uint16_t* sPtr = reinterpret_cast<const uint16_t*>( pPixels );
-
-                    for( size_t x=0; x < img->width; ++x )
-                    {
-                        if ( *sPtr & 0x8000 )
-                        {
-                            nonzeroa = true;
-                            break;
-                        }
-
-                        ++sPtr;
-                    }
-
-                    if ( nonzeroa )
-                        break;
-
-                    pPixels += rowPitch;
-                }
-
-                // If there are no non-zero alpha channel entries, we'll assume alpha is not used and force it to opaque
-                if ( !nonzeroa )
-                {
-                    hr = _SetAlphaChannelToOpaque( img );
-                    if ( FAILED(hr) )
-                        return hr;
-                }
-            }
-            break;
-        }
-    }
-    else // RLE || EXPAND || INVERTX || !INVERTY
-    {
-        std::unique_ptr<uint8_t[]> temp( new (std::nothrow) uint8_t[ remaining ] );
-        if ( !temp )
-        {
-            image.Release();
-            return E_OUTOFMEMORY;
-        }
-
-        if ( !ReadFile( hFile.get(), temp.get(), remaining, &bytesRead, 0 ) )
-        {
-            image.Release();
-            return HRESULT_FROM_WIN32( GetLastError() );
-        }
-
-        if ( bytesRead != remaining )
-        {
-            image.Release();
-            return E_FAIL;
-        }
-
-        if ( convFlags & CONV_FLAGS_RLE )
-        {
-            hr = _UncompressPixels( temp.get(), remaining, image.GetImage(0,0,0), convFlags );
-        }
-        else
-        {
-            hr = _CopyPixels( temp.get(), remaining, image.GetImage(0,0,0), convFlags );
-        }
-
-        if ( FAILED(hr) )
-        {
-            image.Release();
-            return hr;
-        }
+        return HRESULT_FROM_WIN32( GetLastError() );
     }
 
-    if ( metadata )
-        memcpy( metadata, &mdata, sizeof(TexMetadata) );
-
-    return S_OK;
+    return LoadFromTGAMemory( view.get(), fileSize.LowPart, flags, metadata, image );
 }
 
 
@@ -419,4 +419,192 @@ namespace TriangleFilter
 
 }; // namespace
 
+//-------------------------------------------------------------------------------------
+// Polyphase filtering helpers
+//-------------------------------------------------------------------------------------
+
+namespace PolyphaseFilter
+{
+    // Every destination texel reads the same number of source texels (taps), padded
+    // with zero weights, with the addressing mode already applied to the indices
+    struct Filter
+    {
+        size_t                      taps;
+        std::unique_ptr<size_t[]>   index;      // dest * taps
+        std::unique_ptr<float[]>    weight;     // dest * taps
+
+        Filter() : taps(0) {}
+    };
+
+    static const float PF_PI = 3.14159265358979f;
+    static const float PF_EPSILON = 0.00001f;
+
+    inline float _Triangle( _In_ float x )
+    {
+        x = fabsf( x );
+        return ( x < 1.f ) ? ( 1.f - x ) : 0.f;
+    }
+
+    // Keys cubic with a = -0.5
+    inline float _CatmullRom( _In_ float x )
+    {
+        x = fabsf( x );
+        if ( x < 1.f )
+            return ( ( 1.5f * x - 2.5f ) * x ) * x + 1.f;
+        if ( x < 2.f )
+            return ( ( -0.5f * x + 2.5f ) * x - 4.f ) * x + 2.f;
+        return 0.f;
+    }
+
+    inline float _Lanczos3( _In_ float x )
+    {
+        x = fabsf( x );
+        if ( x < PF_EPSILON )
+            return 1.f;
+        if ( x >= 3.f )
+            return 0.f;
+
+        float px = PF_PI * x;
+        return 3.f * sinf( px ) * sinf( px / 3.f ) / ( px * px );
+    }
+
+    inline float _Support( _In_ DWORD filter )
+    {
+        switch( filter )
+        {
+        case TEX_FILTER_BOX:        return 0.5f;
+        case TEX_FILTER_TRIANGLE:   return 1.f;
+        case TEX_FILTER_CUBIC:      return 2.f;
+        default:                    return 3.f;
+        }
+    }
+
+    // Weight of source texel u for a destination texel centered on 'center' (in source texels)
+    inline float _Weight( _In_ DWORD filter, _In_ float u, _In_ float center, _In_ float scale )
+    {
+        switch( filter )
+        {
+        case TEX_FILTER_BOX:
+            {
+                // Coverage of the source texel by the destination texel footprint
+                float halfWidth = 0.5f * scale;
+                float a = std::max<float>( u - 0.5f, center - halfWidth );
+                float b = std::min<float>( u + 0.5f, center + halfWidth );
+                return std::max<float>( b - a, 0.f );
+            }
+
+        case TEX_FILTER_TRIANGLE:   return _Triangle( ( u - center ) / scale );
+        case TEX_FILTER_CUBIC:      return _CatmullRom( ( u - center ) / scale );
+        default:                    return _Lanczos3( ( u - center ) / scale );
+        }
+    }
+
+    inline size_t _Address( _In_ ptrdiff_t u, _In_ size_t size, _In_ bool wrap, _In_ bool mirror )
+    {
+        const ptrdiff_t n = ptrdiff_t( size );
+
+        if ( wrap )
+        {
+            u %= n;
+            if ( u < 0 )
+                u += n;
+        }
+        else if ( mirror )
+        {
+            u %= 2 * n;
+            if ( u < 0 )
+                u += 2 * n;
+            if ( u >= n )
+                u = 2 * n - 1 - u;
+        }
+        else
+        {
+            u = std::min<ptrdiff_t>( std::max<ptrdiff_t>( u, 0 ), n - 1 );
+        }
+
+        return size_t( u );
+    }
+
+    // Builds the weights for BOX, TRIANGLE, CUBIC (Catmull-Rom) or LANCZOS3 filtering; the filter
+    // is stretched by the scale factor when minifying so every source texel contributes
+    inline HRESULT _Create( _In_ size_t source, _In_ size_t dest, _In_ DWORD filter, _In_ bool wrap, _In_ bool mirror, _Out_ Filter& pf )
+    {
+        assert( source > 0 );
+        assert( dest > 0 );
+
+        const float scale = float(source) / float(dest);
+        const float filterScale = std::max<float>( scale, 1.f );
+        const float support = _Support( filter ) * filterScale;
+        const size_t window = size_t( ceilf( support * 2.f ) ) + 2;
+
+        std::unique_ptr<float[]> weights( new (std::nothrow) float[ dest * window ] );
+        std::unique_ptr<ptrdiff_t[]> first( new (std::nothrow) ptrdiff_t[ dest ] );
+        if ( !weights || !first )
+            return E_OUTOFMEMORY;
+
+        // Evaluate the filter over the window, and trim zero weights from both ends
+        size_t taps = 1;
+        for( size_t v = 0; v < dest; ++v )
+        {
+            const float center = ( float(v) + 0.5f ) * scale - 0.5f;
+            const ptrdiff_t start = ptrdiff_t( floorf( center - support ) );
+
+            float* w = weights.get() + v * window;
+            size_t lo = window;
+            size_t hi = 0;
+            float total = 0.f;
+
+            for( size_t k = 0; k < window; ++k )
+            {
+                w[k] = _Weight( filter, float( start + ptrdiff_t(k) ), center, filterScale );
+                total += w[k];
+
+                if ( fabsf( w[k] ) > PF_EPSILON )
+                {
+                    lo = std::min<size_t>( lo, k );
+                    hi = k;
+                }
+            }
+
+            if ( lo > hi || fabsf( total ) < PF_EPSILON )
+            {
+                // Degenerate case, so use the nearest texel
+                memset( w, 0, sizeof(float) * window );
+                lo = hi = size_t( floorf( center + 0.5f ) - float(start) );
+                lo = hi = std::min<size_t>( lo, window - 1 );
+                w[lo] = total = 1.f;
+            }
+
+            for( size_t k = 0; k < window; ++k )
+            {
+                w[k] /= total;
+            }
+
+            memmove( w, w + lo, sizeof(float) * ( hi - lo + 1 ) );
+            memset( w + ( hi - lo + 1 ), 0, sizeof(float) * ( window - ( hi - lo + 1 ) ) );
+
+            first[v] = start + ptrdiff_t(lo);
+            taps = std::max<size_t>( taps, hi - lo + 1 );
+        }
+
+        pf.taps = taps;
+        pf.index.reset( new (std::nothrow) size_t[ dest * taps ] );
+        pf.weight.reset( new (std::nothrow) float[ dest * taps ] );
+        if ( !pf.index || !pf.weight )
+            return E_OUTOFMEMORY;
+
+        for( size_t v = 0; v < dest; ++v )
+        {
+            for( size_t k = 0; k < taps; ++k )
+            {
+                pf.index[ v * taps + k ] = _Address( first[v] + ptrdiff_t(k), source, wrap, mirror );
+                pf.weight[ v * taps + k ] = weights[ v * window + k ];
+            }
+        }
+
+        return S_OK;
+    }
+
+}; // namespace
+
 }; // namespace
\ No newline at end of file
@@ -30,3 +30,8 @@ struct handle_closer { void operator()(HANDLE h) { assert(h != INVALID_HANDLE_VA
 typedef public std::unique_ptr<void, handle_closer> ScopedHandle;
 
 inline HANDLE safe_handle( HANDLE h ) { return (h == INVALID_HANDLE_VALUE) ? 0 : h; }
+
+//---------------------------------------------------------------------------------
+struct view_unmapper { void operator()(LPCVOID p) { if (p) UnmapViewOfFile(p); } };
+
+typedef std::unique_ptr<const void, view_unmapper> ScopedMapView;
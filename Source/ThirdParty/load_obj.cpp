@@ -366,3 +366,26 @@ bool load_mtl(const Path& path, obj::MaterialLib& mtl_lib) {
     std::ifstream stream(path);
     return stream && parse_mtl(stream, mtl_lib);
 }
+
+// Read-only stream buffer over a block of memory (no copies are made)
+class MemoryBuf : public std::streambuf {
+public:
+    MemoryBuf(const char* data, size_t size) {
+        char* ptr = const_cast<char*>(data);
+        setg(ptr, ptr, ptr + size);
+    }
+};
+
+bool load_obj(const char* data, size_t size, obj::File& obj_file) {
+    // Parse the OBJ file contents in place
+    MemoryBuf buf(data, size);
+    std::istream stream(&buf);
+    return parse_obj(stream, obj_file);
+}
+
+bool load_mtl(const char* data, size_t size, obj::MaterialLib& mtl_lib) {
+    // Parse the MTL file contents in place
+    MemoryBuf buf(data, size);
+    std::istream stream(&buf);
+    return parse_mtl(stream, mtl_lib);
+}
@@ -134,5 +134,8 @@ typedef std::unordered_map<obj::Index, unsigned, HashIndex, CompareIndex> IndexM
 
 bool load_obj(const obj::Path&, obj::File&);
 bool load_mtl(const obj::Path&, obj::MaterialLib&);
+// Parse the contents of a file already loaded (or mapped) into memory
+bool load_obj(const char*, size_t, obj::File&);
+bool load_mtl(const char*, size_t, obj::MaterialLib&);
 
 #endif // LOAD_OBJ_H
@@ -0,0 +1,76 @@
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+#include <Windows.h>
+#include "..\Common\AssetPack.h"
+#include "..\Common\Utility.h"
+
+// Appends the names of all files within the directory (and its subdirectories) to 'fileNames'.
+// The names are relative to 'rootPath'. Skips existing pack files.
+static void listFiles(const std::string& rootPath, const std::string& dirName,
+                      std::vector<std::string>& fileNames) {
+    WIN32_FIND_DATAA findData;
+    const HANDLE search = FindFirstFileA((rootPath + dirName + "*").c_str(), &findData);
+    if (INVALID_HANDLE_VALUE == search) return;
+    do {
+        const std::string name = findData.cFileName;
+        if ("." == name || ".." == name) continue;
+        if (findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) {
+            listFiles(rootPath, dirName + name + "\\", fileNames);
+        } else if (name.length() < 5 || name.compare(name.length() - 5, 5, ".pack")) {
+            fileNames.push_back(dirName + name);
+        }
+    } while (FindNextFileA(search, &findData));
+    FindClose(search);
+}
+
+int __cdecl main(const int argc, const char* argv[]) {
+    // Parse command line arguments.
+    const bool compress = argc == 4 && 0 == strcmp(argv[1], "-c");
+    if (argc != 3 && !compress) {
+        printError("Usage: Packer [-c] <asset directory> <pack file>");
+        return -1;
+    }
+    const char* packFileName = argv[argc - 1];
+    std::string rootPath     = argv[argc - 2];
+    if ('\\' != rootPath.back() && '/' != rootPath.back()) {
+        rootPath += '\\';
+    }
+    // Collect the files, and create the pack.
+    std::vector<std::string> fileNames;
+    listFiles(rootPath, "", fileNames);
+    printInfo("Packing %zu files from the directory: %s", fileNames.size(), rootPath.c_str());
+    AssetPack::build(packFileName, rootPath.c_str(), fileNames, compress);
+    // Verify the result, and measure the decompression throughput.
+    const AssetPack pack{packFileName};
+    uint64_t totalSize = 0, totalStoredSize = 0;
+    std::chrono::duration<double> readTime{0};
+    for (const std::string& fileName : fileNames) {
+        AssetRange range;
+        if (!pack.find(fileName.c_str(), range)) {
+            printError("Failed to locate the file within the pack: %s", fileName.c_str());
+            return -1;
+        }
+        const auto contents  = std::make_unique<byte_t[]>(static_cast<size_t>(range.size));
+        const auto startTime = std::chrono::steady_clock::now();
+        pack.read(range, contents.get());
+        readTime += std::chrono::steady_clock::now() - startTime;
+        const FileView original{(rootPath + fileName).c_str()};
+        if (original.size() != range.size ||
+            0 != memcmp(original.data(), contents.get(), static_cast<size_t>(range.size))) {
+            printError("Contents mismatch: %s", fileName.c_str());
+            return -1;
+        }
+        totalSize       += range.size;
+        totalStoredSize += range.storedSize;
+    }
+    constexpr double MiB = 1.0 / (1024 * 1024);
+    printInfo("Packed %.2f MiB into %.2f MiB (compression ratio: %.2f).", totalSize * MiB,
+              totalStoredSize * MiB, static_cast<double>(totalSize) / totalStoredSize);
+    printInfo("Read the contents in %.2f ms (%.2f GB/s).", readTime.count() * 1e3,
+              totalSize * 1e-9 / readTime.count());
+    printInfo("Asset pack created successfully: %s", packFileName);
+    return 0;
+}